@@ -0,0 +1,129 @@
+#include "engine/MixKernels.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace beater;
+
+// Mixing kernel microbenchmark
+// Mixes 64 voices into a stereo block, the way Sampler::render does, for each
+// available kernel and a range of JACK buffer sizes.
+// Usage: beater_bench_mix [iterations]
+
+namespace {
+
+constexpr uint32_t VOICES = 64;
+constexpr uint32_t SOURCE_FRAMES = 48000;
+
+struct Result {
+    double nsPerBlock = 0.0;
+    float checksum = 0.0f;
+};
+
+Result runKernel(const MixKernels& kernels, uint32_t blockSize, int iterations,
+                 const std::vector<float>& srcL, const std::vector<float>& srcR) {
+    std::vector<float> outL(blockSize), outR(blockSize);
+    const uint32_t stride = SOURCE_FRAMES / VOICES;
+
+    auto mixBlock = [&](int iteration) {
+        std::memset(outL.data(), 0, blockSize * sizeof(float));
+        std::memset(outR.data(), 0, blockSize * sizeof(float));
+        for (uint32_t v = 0; v < VOICES; ++v) {
+            // Each voice reads a different (unaligned) part of the source
+            uint32_t pos = (v * stride + static_cast<uint32_t>(iteration) * 7 + v)
+                           % (SOURCE_FRAMES - blockSize);
+            float gainL = 0.5f + 0.005f * v;
+            float gainR = 0.8f - 0.005f * v;
+            kernels.mixStereo(srcL.data() + pos, srcR.data() + pos,
+                              outL.data(), outR.data(), blockSize, gainL, gainR);
+        }
+    };
+
+    // Warm caches and clocks
+    for (int i = 0; i < 100; ++i) {
+        mixBlock(i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        mixBlock(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    Result result;
+    result.nsPerBlock = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    // Output of the final block, so the work cannot be optimized away
+    for (uint32_t i = 0; i < blockSize; ++i) {
+        result.checksum += outL[i] + outR[i];
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = 20000;
+    if (argc > 1) {
+        iterations = std::max(1, std::atoi(argv[1]));
+    }
+
+    std::vector<float> srcL(SOURCE_FRAMES), srcR(SOURCE_FRAMES);
+    for (uint32_t i = 0; i < SOURCE_FRAMES; ++i) {
+        srcL[i] = static_cast<float>((i * 37) % 1000) / 1000.0f - 0.5f;
+        srcR[i] = static_cast<float>((i * 53) % 1000) / 1000.0f - 0.5f;
+    }
+
+    std::cout << "=== Beater Mixing Kernel Benchmark ===\n\n";
+    std::cout << "Active kernel: " << mixKernels().name << "\n";
+    std::cout << "Voices: " << VOICES << ", iterations: " << iterations << "\n\n";
+
+    const MixIsa isas[] = {MixIsa::Scalar, MixIsa::SSE2, MixIsa::AVX2, MixIsa::AVX512};
+    const uint32_t blockSizes[] = {32, 64, 128, 256, 512, 1024};
+
+    std::cout << std::left << std::setw(10) << "kernel"
+              << std::right << std::setw(8) << "frames"
+              << std::setw(14) << "ns/block"
+              << std::setw(14) << "ns/voice-fr"
+              << std::setw(10) << "speedup" << "\n";
+
+    bool mismatch = false;
+    for (uint32_t blockSize : blockSizes) {
+        Result scalar = runKernel(*mixKernelsFor(MixIsa::Scalar), blockSize, iterations, srcL, srcR);
+
+        for (MixIsa isa : isas) {
+            const MixKernels* kernels = mixKernelsFor(isa);
+            if (kernels == nullptr) {
+                continue;
+            }
+
+            Result result = isa == MixIsa::Scalar
+                ? scalar
+                : runKernel(*kernels, blockSize, iterations, srcL, srcR);
+
+            // Kernels are specified to be bit-identical to the scalar path
+            if (result.checksum != scalar.checksum) {
+                mismatch = true;
+            }
+
+            std::cout << std::left << std::setw(10) << kernels->name
+                      << std::right << std::setw(8) << blockSize
+                      << std::setw(14) << std::fixed << std::setprecision(1) << result.nsPerBlock
+                      << std::setw(14) << std::setprecision(3)
+                      << result.nsPerBlock / (static_cast<double>(blockSize) * VOICES)
+                      << std::setw(9) << std::setprecision(2)
+                      << scalar.nsPerBlock / result.nsPerBlock << "x"
+                      << (result.checksum != scalar.checksum ? "  MISMATCH" : "") << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    if (mismatch) {
+        std::cerr << "Kernel output differs from scalar reference!\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "engine/Engine.hpp"
+#include "engine/OfflineRenderer.hpp"
+#include "serialization/ProjectSerializer.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace beater;
+
+// Offline project renderer (no JACK server needed)
+// Usage: beater_render <project.beater> <output.wav|output.flac> [options]
+//   --rate HZ        sample rate (default 48000)
+//   --block FRAMES   render block size (default 256)
+//   --bits N         16, 24 or 32 (float, WAV only); default 24
+//   --start TICK     first tick to render (default 0)
+//   --end TICK       tick to stop at (default: end of the last region)
+//   --tail SECONDS   longest ring-out after the end (default 2)
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <project.beater> <output.wav|output.flac>"
+              << " [--rate HZ] [--block FRAMES] [--bits 16|24|32]"
+              << " [--start TICK] [--end TICK] [--tail SECONDS]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    const std::string projectPath = argv[1];
+    const std::string outputPath = argv[2];
+    OfflineRenderOptions options;
+    int bitDepth = 24;
+    
+    for (int i = 3; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--rate") == 0) {
+            options.sampleRate = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(arg, "--block") == 0) {
+            options.blockSize = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(arg, "--bits") == 0) {
+            bitDepth = std::atoi(value);
+        } else if (std::strcmp(arg, "--start") == 0) {
+            options.startTick = std::atoll(value);
+        } else if (std::strcmp(arg, "--end") == 0) {
+            options.endTick = std::atoll(value);
+        } else if (std::strcmp(arg, "--tail") == 0) {
+            options.tailSeconds = std::atof(value);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    AudioFileFormat format;
+    if (!AudioFileWriter::formatForPath(outputPath, bitDepth, format)) {
+        std::cerr << "Unsupported output: " << outputPath << " at " << bitDepth
+                  << " bits (use .wav with 16/24/32 or .flac with 16/24)\n";
+        return 1;
+    }
+    
+    Project project;
+    if (!ProjectSerializer::loadFromFile(project, projectPath)) {
+        std::cerr << "Failed to load project: " << projectPath << "\n";
+        return 1;
+    }
+    
+    Engine engine;
+    engine.setProject(project);
+    if (!engine.loadInstrumentSamples()) {
+        // A render missing instruments is worse than none
+        std::cerr << "Not rendering: the instruments listed above would be silent\n";
+        return 1;
+    }
+    
+    OfflineRenderer renderer(engine);
+    if (!renderer.renderToFile(outputPath, format, options)) {
+        std::cerr << "Render failed: " << renderer.getError() << "\n";
+        return 1;
+    }
+    
+    const auto& stats = renderer.getStats();
+    std::cout << "Rendered " << stats.frames << " frames ("
+              << std::fixed << std::setprecision(2) << stats.audioSeconds << " s) to "
+              << outputPath << "\n";
+    std::cout << "Wall time " << std::setprecision(3) << stats.wallSeconds << " s, "
+              << std::setprecision(1) << stats.realtimeFactor() << "x realtime\n";
+    return 0;
+}
@@ -36,7 +36,7 @@ int main(int argc, char* argv[]) {
             
             // Trigger the sample
             std::cout << "Triggering sample...\n";
-            engine.triggerSample(sample, 0.8f, 1.0f, 0.0f);
+            engine.triggerSample(engine.getSampleLibrary().getHandle(samplePath), 0.8f, 1.0f, 0.0f);
             
             // Wait for playback
             float durationSec = static_cast<float>(sample->lengthFrames) / sample->sampleRate;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "domain/SymbolTable.hpp"
+#include "domain/TimeTypes.hpp"
+#include <vector>
+
+namespace beater {
+
+// What an edit touched
+enum class ChangeKind {
+    RegionAdded,     // Region `target` now covers [newStart, newEnd)
+    RegionRemoved,   // Region `target` no longer covers [oldStart, oldEnd)
+    RegionChanged,   // Region `target` moved/resized or switched pattern
+    PatternChanged,  // Pattern `target`'s notes or length changed (or it was replaced/removed)
+    TempoChanged,    // Tempo map changed from oldStart on
+    MeterChanged,    // Meter map changed from oldStart on
+    Reset            // Untracked or too many edits: rebuild everything
+};
+
+// One fine-grained edit to the domain model
+struct Change {
+    ChangeKind kind = ChangeKind::Reset;
+    SymbolId target = EMPTY_SYMBOL;  // Region or pattern id
+    Tick oldStart = 0;               // Ticks covered before the edit
+    Tick oldEnd = 0;
+    Tick newStart = 0;               // Ticks covered after the edit
+    Tick newEnd = 0;
+};
+
+// Pending change records of a domain object, drained by whoever compiles it
+// Bounded: past MAX_RECORDS it collapses to a single Reset, so a long burst
+// of edits without a compile costs neither memory nor a slow patch.
+class ChangeJournal {
+public:
+    static constexpr size_t MAX_RECORDS = 1024;
+    
+    void record(const Change& change) {
+        if (!changes_.empty() && changes_.back().kind == ChangeKind::Reset) {
+            return;
+        }
+        if (changes_.size() >= MAX_RECORDS || change.kind == ChangeKind::Reset) {
+            changes_.clear();
+            changes_.push_back(Change{});
+            return;
+        }
+        changes_.push_back(change);
+    }
+    
+    // Append the pending records to out and forget them
+    void drainInto(std::vector<Change>& out) {
+        out.insert(out.end(), changes_.begin(), changes_.end());
+        changes_.clear();
+    }
+    
+    bool empty() const { return changes_.empty(); }
+    const std::vector<Change>& getChanges() const { return changes_; }
+    
+private:
+    std::vector<Change> changes_;
+};
+
+} // namespace beater
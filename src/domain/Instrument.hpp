@@ -17,12 +17,16 @@ public:
     float getGain() const { return gain_; }
     float getPan() const { return pan_; }
     const std::string& getSamplePath() const { return samplePath_; }
+    int getChokeGroup() const { return chokeGroup_; }
+    int getMaxPolyphony() const { return maxPolyphony_; }
     
     // Mutators
     void setName(const std::string& name) { name_ = name; }
     void setGain(float gain) { gain_ = gain; }
     void setPan(float pan) { pan_ = pan; }
     void setSamplePath(const std::string& path) { samplePath_ = path; }
+    void setChokeGroup(int group) { chokeGroup_ = group; }
+    void setMaxPolyphony(int voices) { maxPolyphony_ = voices; }
     
 private:
     int id_ = 0;
@@ -30,6 +34,8 @@ private:
     float gain_ = 1.0f;      // 0.0 to 1.0+
     float pan_ = 0.0f;       // -1.0 (left) to +1.0 (right)
     std::string samplePath_; // Path to WAV/sample file
+    int chokeGroup_ = 0;     // 0 = none; a hit fades out other voices in the group
+    int maxPolyphony_ = 0;   // 0 = unlimited; 1 = monophonic
 };
 
 // Instrument rack: collection of instruments in a project
@@ -6,10 +6,12 @@ namespace beater {
 MeterMap::MeterMap() {
     // Default: 4/4 at start
     changes_.push_back({0, {4, 4}});
+    rebuildIndex();
 }
 
 MeterMap::MeterMap(const TimeSignature& initialSignature) {
     changes_.push_back({0, initialSignature});
+    rebuildIndex();
 }
 
 void MeterMap::addChange(Tick atTick, const TimeSignature& signature) {
@@ -18,6 +20,7 @@ void MeterMap::addChange(Tick atTick, const TimeSignature& signature) {
     
     changes_.push_back({atTick, signature});
     sortChanges();
+    recordChange(atTick);
 }
 
 void MeterMap::removeChangeAt(Tick tick) {
@@ -26,116 +29,132 @@ void MeterMap::removeChangeAt(Tick tick) {
             [tick](const MeterChange& mc) { return mc.atTick == tick; }),
         changes_.end()
     );
+    rebuildIndex();
+    recordChange(tick);
 }
 
 TimeSignature MeterMap::getSignatureAt(Tick tick) const {
-    if (changes_.empty()) {
+    if (sections_.empty()) {
         return {4, 4}; // fallback
     }
     
-    // Find the last meter change at or before this tick
-    TimeSignature sig = changes_[0].signature;
-    for (const auto& change : changes_) {
-        if (change.atTick <= tick) {
-            sig = change.signature;
-        } else {
-            break;
-        }
-    }
-    
-    return sig;
+    // Before the first change its signature applies
+    const Section* section = sectionAt(tick);
+    return section != nullptr ? section->signature : sections_.front().signature;
 }
 
 void MeterMap::clear() {
     changes_.clear();
+    sections_.clear();
+    recordChange(0);
 }
 
 void MeterMap::setConstantMeter(const TimeSignature& signature) {
     changes_.clear();
     changes_.push_back({0, signature});
+    rebuildIndex();
+    recordChange(0);
 }
 
 Tick MeterMap::getBarStartAt(Tick tick) const {
-    if (changes_.empty()) {
+    if (sections_.empty()) {
         TimeSignature defaultSig = {4, 4};
         Tick barLength = TimeUtils::ticksPerBar(defaultSig);
         return (tick / barLength) * barLength;
     }
     
-    // Walk through meter changes to find which bar we're in
-    Tick currentTick = 0;
-    TimeSignature currentSig = changes_[0].signature;
-    
-    for (size_t i = 0; i < changes_.size(); ++i) {
-        const auto& change = changes_[i];
-        
-        // Determine the range where this signature applies
-        Tick rangeStart = change.atTick;
-        Tick rangeEnd = (i + 1 < changes_.size()) ? changes_[i + 1].atTick : tick + 1;
-        
-        if (tick < rangeStart) {
-            break;
-        }
-        
-        if (tick >= rangeStart && tick < rangeEnd) {
-            // Tick is within this meter section
-            currentSig = change.signature;
-            Tick barLength = TimeUtils::ticksPerBar(currentSig);
-            Tick offsetInSection = tick - rangeStart;
-            Tick barStartInSection = (offsetInSection / barLength) * barLength;
-            return rangeStart + barStartInSection;
-        }
-    }
-    
-    // Fallback: use last known signature
-    if (!changes_.empty()) {
-        currentSig = changes_.back().signature;
-        Tick barLength = TimeUtils::ticksPerBar(currentSig);
+    const Section* section = sectionAt(tick);
+    if (section == nullptr) {
+        // Before the first change: bars of the last signature from tick 0
+        Tick barLength = sections_.back().barLength;
         return (tick / barLength) * barLength;
     }
     
-    return 0;
+    // Bars restart at each meter change
+    Tick offsetInSection = tick - section->startTick;
+    return section->startTick + (offsetInSection / section->barLength) * section->barLength;
 }
 
 int MeterMap::getBarIndexAt(Tick tick) const {
-    if (changes_.empty()) {
+    if (sections_.empty()) {
         TimeSignature defaultSig = {4, 4};
         Tick barLength = TimeUtils::ticksPerBar(defaultSig);
         return static_cast<int>(tick / barLength);
     }
     
-    // Count bars across meter changes
-    int barCount = 0;
-    Tick currentTick = 0;
+    const Section* section = sectionAt(tick);
+    if (section == nullptr) {
+        return 0;
+    }
+    return section->firstBar + static_cast<int>((tick - section->startTick) / section->barLength);
+}
+
+void MeterMap::getGridLines(Tick startTick, Tick endTick, std::vector<GridLine>& out) const {
+    out.clear();
+    if (sections_.empty() || startTick >= endTick) {
+        return;
+    }
     
-    for (size_t i = 0; i < changes_.size(); ++i) {
-        const auto& change = changes_[i];
-        Tick rangeStart = change.atTick;
-        Tick rangeEnd = (i + 1 < changes_.size()) ? changes_[i + 1].atTick : tick + 1;
+    // Section containing startTick; the grid starts at the first change
+    size_t index = 0;
+    if (const Section* first = sectionAt(startTick)) {
+        index = static_cast<size_t>(first - sections_.data());
+    }
+    
+    for (; index < sections_.size() && sections_[index].startTick < endTick; ++index) {
+        const Section& section = sections_[index];
+        Tick sectionEnd = index + 1 < sections_.size()
+            ? std::min(sections_[index + 1].startTick, endTick) : endTick;
         
-        if (tick < rangeStart) {
-            break;
+        // Walk bar by bar from the first bar reaching the window
+        Tick bar = 0;
+        if (startTick > section.startTick) {
+            bar = (startTick - section.startTick) / section.barLength;
         }
-        
-        TimeSignature sig = change.signature;
-        Tick barLength = TimeUtils::ticksPerBar(sig);
-        
-        Tick effectiveEnd = (tick < rangeEnd) ? tick : rangeEnd;
-        Tick ticksInSection = effectiveEnd - rangeStart;
-        int barsInSection = static_cast<int>(ticksInSection / barLength);
-        
-        barCount += barsInSection;
-        
-        if (tick < rangeEnd) {
-            break;
+        for (Tick barStart = section.startTick + bar * section.barLength;
+             barStart < sectionEnd; barStart += section.barLength, ++bar) {
+            int beat = 0;
+            for (Tick tick = barStart; tick < barStart + section.barLength && tick < sectionEnd;
+                 tick += section.beatLength, ++beat) {
+                if (tick >= startTick) {
+                    out.push_back({tick, section.firstBar + static_cast<int>(bar), beat});
+                }
+            }
         }
     }
+}
+
+const MeterMap::Section* MeterMap::sectionAt(Tick tick) const {
+    // Last section starting at or before tick
+    auto it = std::upper_bound(sections_.begin(), sections_.end(), tick,
+        [](Tick t, const Section& section) { return t < section.startTick; });
+    return it == sections_.begin() ? nullptr : &*(it - 1);
+}
+
+void MeterMap::rebuildIndex() {
+    sections_.clear();
+    sections_.reserve(changes_.size());
     
-    return barCount;
+    int bars = 0;
+    for (size_t i = 0; i < changes_.size(); ++i) {
+        Section section;
+        section.startTick = changes_[i].atTick;
+        section.signature = changes_[i].signature;
+        section.barLength = TimeUtils::ticksPerBar(section.signature);
+        section.beatLength = TimeUtils::ticksPerBeat(section.signature);
+        section.firstBar = bars;
+        sections_.push_back(section);
+        
+        // Only whole bars count towards later sections
+        if (i + 1 < changes_.size()) {
+            bars += static_cast<int>((changes_[i + 1].atTick - section.startTick) / section.barLength);
+        }
+    }
 }
 
 void MeterMap::sortChanges() {
     std::sort(changes_.begin(), changes_.end());
+    rebuildIndex();
 }
 
 } // namespace beater
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "domain/ChangeJournal.hpp"
 #include "domain/TimeTypes.hpp"
 #include <vector>
 
@@ -15,7 +16,19 @@ struct MeterChange {
     }
 };
 
+// Bar or beat line of the meter grid
+struct GridLine {
+    Tick tick = 0;
+    int bar = 0;    // 0-based bar index (as getBarIndexAt)
+    int beat = 0;   // 0 on the bar line, else the beat within the bar
+    
+    bool isBar() const { return beat == 0; }
+};
+
 // Meter map: piecewise constant time signatures across timeline
+// Keeps a compiled index of its sections (start tick, bar/beat lengths and
+// a prefix sum of bar counts), rebuilt on every edit, so position queries
+// are a binary search instead of a walk over all changes.
 class MeterMap {
 public:
     MeterMap();
@@ -45,10 +58,33 @@ public:
     // Get bar index (0-based) at given tick
     int getBarIndexAt(Tick tick) const;
     
+    // All bar and beat lines in [startTick, endTick), in tick order
+    // Bars run from each meter change; out is cleared first.
+    void getGridLines(Tick startTick, Tick endTick, std::vector<GridLine>& out) const;
+    
+    // Move pending change records to out
+    void drainChanges(std::vector<Change>& out) { journal_.drainInto(out); }
+    
 private:
     std::vector<MeterChange> changes_;
+    ChangeJournal journal_;
+    
+    // Compiled index: one entry per change
+    struct Section {
+        Tick startTick = 0;
+        Tick barLength = 0;
+        Tick beatLength = 0;
+        int firstBar = 0;  // Whole bars in all earlier sections
+        TimeSignature signature;
+    };
+    std::vector<Section> sections_;
+    
+    // Section containing tick, or nullptr before the first change
+    const Section* sectionAt(Tick tick) const;
     
+    void rebuildIndex();
     void sortChanges();
+    void recordChange(Tick fromTick) { journal_.record({ChangeKind::MeterChanged, EMPTY_SYMBOL, fromTick}); }
 };
 
 } // namespace beater
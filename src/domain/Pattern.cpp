@@ -4,27 +4,44 @@
 namespace beater {
 
 Pattern::Pattern(const std::string& id, const std::string& name, Tick lengthTicks)
-    : id_(id), name_(name), lengthTicks_(lengthTicks) {
+    : id_(domainSymbols().intern(id)), name_(name), lengthTicks_(lengthTicks) {
 }
 
+namespace {
+
+bool noteTickLess(const StepNote& a, const StepNote& b) {
+    return a.offsetTick < b.offsetTick;
+}
+
+} // namespace
+
 void Pattern::addNote(const StepNote& note) {
-    notes_.push_back(note);
-    
     // Keep notes sorted by tick for efficient playback
-    std::sort(notes_.begin(), notes_.end(), 
-        [](const StepNote& a, const StepNote& b) {
-            return a.offsetTick < b.offsetTick;
-        });
+    auto it = std::upper_bound(notes_.begin(), notes_.end(), note, noteTickLess);
+    notes_.insert(it, note);
+    markChanged();
+}
+
+void Pattern::addNotes(const std::vector<StepNote>& notes) {
+    auto middle = static_cast<std::ptrdiff_t>(notes_.size());
+    notes_.insert(notes_.end(), notes.begin(), notes.end());
+    std::stable_sort(notes_.begin() + middle, notes_.end(), noteTickLess);
+    std::inplace_merge(notes_.begin(), notes_.begin() + middle, notes_.end(), noteTickLess);
+    if (!notes.empty()) {
+        markChanged();
+    }
 }
 
 void Pattern::removeNote(size_t index) {
     if (index < notes_.size()) {
         notes_.erase(notes_.begin() + index);
+        markChanged();
     }
 }
 
 void Pattern::clearNotes() {
     notes_.clear();
+    markChanged();
 }
 
 std::vector<StepNote> Pattern::getNotesAt(Tick tick) const {
@@ -49,32 +66,58 @@ std::vector<StepNote> Pattern::getNotesForInstrument(int instrumentId) const {
 
 // PatternLibrary implementation
 
+namespace {
+
+SymbolId patternSymbol(const Pattern& pattern) {
+    return pattern.getSymbol();
+}
+
+} // namespace
+
 void PatternLibrary::addPattern(const Pattern& pattern) {
     // Remove existing pattern with same ID if present
-    removePattern(pattern.getId());
+    removePattern(pattern.getSymbol());
     patterns_.push_back(pattern);
+    index_.update(patterns_, patterns_.size() - 1, patternSymbol);
+    journal_.record({ChangeKind::PatternChanged, pattern.getSymbol()});
 }
 
 void PatternLibrary::removePattern(const std::string& id) {
-    patterns_.erase(
-        std::remove_if(patterns_.begin(), patterns_.end(),
-            [&id](const Pattern& p) { return p.getId() == id; }),
-        patterns_.end()
-    );
+    SymbolId symbol = domainSymbols().find(id);
+    if (symbol != INVALID_SYMBOL) {
+        removePattern(symbol);
+    }
 }
 
-Pattern* PatternLibrary::getPattern(const std::string& id) {
-    auto it = std::find_if(patterns_.begin(), patterns_.end(),
-        [&id](const Pattern& p) { return p.getId() == id; });
+void PatternLibrary::removePattern(SymbolId id) {
+    size_t index = index_.find(id);
+    if (index == SymbolIndex::NONE) {
+        return;
+    }
     
-    return (it != patterns_.end()) ? &(*it) : nullptr;
+    // Patterns after the removed one shift down
+    patterns_.erase(patterns_.begin() + static_cast<std::ptrdiff_t>(index));
+    index_.erase(id);
+    index_.update(patterns_, index, patternSymbol);
+    journal_.record({ChangeKind::PatternChanged, id});
+}
+
+Pattern* PatternLibrary::getPattern(const std::string& id) {
+    return getPattern(domainSymbols().find(id));
 }
 
 const Pattern* PatternLibrary::getPattern(const std::string& id) const {
-    auto it = std::find_if(patterns_.begin(), patterns_.end(),
-        [&id](const Pattern& p) { return p.getId() == id; });
-    
-    return (it != patterns_.end()) ? &(*it) : nullptr;
+    return getPattern(domainSymbols().find(id));
+}
+
+Pattern* PatternLibrary::getPattern(SymbolId id) {
+    size_t index = index_.find(id);
+    return index != SymbolIndex::NONE ? &patterns_[index] : nullptr;
+}
+
+const Pattern* PatternLibrary::getPattern(SymbolId id) const {
+    size_t index = index_.find(id);
+    return index != SymbolIndex::NONE ? &patterns_[index] : nullptr;
 }
 
 bool PatternLibrary::hasPattern(const std::string& id) const {
@@ -83,6 +126,15 @@ bool PatternLibrary::hasPattern(const std::string& id) const {
 
 void PatternLibrary::clear() {
     patterns_.clear();
+    index_.clear();
+    journal_.record({ChangeKind::Reset});
+}
+
+void PatternLibrary::drainChanges(std::vector<Change>& out) {
+    journal_.drainInto(out);
+    for (auto& pattern : patterns_) {
+        pattern.drainChanges(out);
+    }
 }
 
 } // namespace beater
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "domain/ChangeJournal.hpp"
+#include "domain/SymbolTable.hpp"
 #include "domain/TimeTypes.hpp"
 #include <string>
 #include <vector>
@@ -28,17 +30,22 @@ public:
     Pattern(const std::string& id, const std::string& name, Tick lengthTicks);
     
     // Accessors
-    const std::string& getId() const { return id_; }
+    const std::string& getId() const { return domainSymbols().name(id_); }
+    SymbolId getSymbol() const { return id_; }
     const std::string& getName() const { return name_; }
     Tick getLengthTicks() const { return lengthTicks_; }
     const std::vector<StepNote>& getNotes() const { return notes_; }
     
     // Mutators
     void setName(const std::string& name) { name_ = name; }
-    void setLengthTicks(Tick ticks) { lengthTicks_ = ticks; }
+    void setLengthTicks(Tick ticks) { lengthTicks_ = ticks; markChanged(); }
     
-    // Note manipulation
+    // Note manipulation (notes stay sorted by tick; equal ticks keep
+    // insertion order)
     void addNote(const StepNote& note);
+    
+    // Add many notes with one sort of the new ones and one merge
+    void addNotes(const std::vector<StepNote>& notes);
     void removeNote(size_t index);
     void clearNotes();
     
@@ -48,11 +55,22 @@ public:
     // Get all notes for a specific instrument
     std::vector<StepNote> getNotesForInstrument(int instrumentId) const;
     
+    // Move pending change records (notes/length edits) to out
+    void drainChanges(std::vector<Change>& out) { journal_.drainInto(out); }
+    
 private:
-    std::string id_;
+    SymbolId id_ = EMPTY_SYMBOL;
     std::string name_;
     Tick lengthTicks_ = PPQ * 4; // Default: 1 bar in 4/4
     std::vector<StepNote> notes_;
+    ChangeJournal journal_;
+    
+    // One pending record per pattern is all a compiler needs
+    void markChanged() {
+        if (journal_.empty()) {
+            journal_.record({ChangeKind::PatternChanged, id_});
+        }
+    }
 };
 
 // Pattern library: collection of reusable patterns
@@ -66,6 +84,10 @@ public:
     Pattern* getPattern(const std::string& id);
     const Pattern* getPattern(const std::string& id) const;
     
+    // O(1) lookup by interned id
+    Pattern* getPattern(SymbolId id);
+    const Pattern* getPattern(SymbolId id) const;
+    
     // Access all patterns
     const std::vector<Pattern>& getPatterns() const { return patterns_; }
     
@@ -75,8 +97,15 @@ public:
     // Clear all patterns
     void clear();
     
+    // Move pending change records of the library and its patterns to out
+    void drainChanges(std::vector<Change>& out);
+    
 private:
     std::vector<Pattern> patterns_;
+    SymbolIndex index_;  // Pattern id -> position in patterns_
+    ChangeJournal journal_;  // Patterns added, replaced or removed
+    
+    void removePattern(SymbolId id);
 };
 
 } // namespace beater
@@ -12,30 +12,65 @@ Project::Project(const std::string& name)
     createDefault();
 }
 
+namespace {
+
+SymbolId trackSymbol(const Track& track) {
+    return track.getSymbol();
+}
+
+} // namespace
+
 void Project::addTrack(const Track& track) {
     tracks_.push_back(track);
+    trackIndex_.update(tracks_, tracks_.size() - 1, trackSymbol);
+    recordTrackRange(track, true);
 }
 
 void Project::removeTrack(const std::string& trackId) {
+    SymbolId symbol = domainSymbols().find(trackId);
+    size_t index = trackIndex_.find(symbol);
+    if (symbol == INVALID_SYMBOL || index == SymbolIndex::NONE) {
+        return;
+    }
+    
+    auto first = tracks_.begin() + static_cast<std::ptrdiff_t>(index);
+    for (auto it = first; it != tracks_.end(); ++it) {
+        if (it->getSymbol() == symbol) {
+            recordTrackRange(*it, false);
+            
+            // Its own pending records still name ticks that need patching
+            std::vector<Change> pending;
+            it->drainChanges(pending);
+            for (const auto& change : pending) {
+                journal_.record(change);
+            }
+        }
+    }
     tracks_.erase(
-        std::remove_if(tracks_.begin(), tracks_.end(),
-            [&trackId](const Track& t) { return t.getId() == trackId; }),
+        std::remove_if(first, tracks_.end(),
+            [symbol](const Track& t) { return t.getSymbol() == symbol; }),
         tracks_.end()
     );
+    trackIndex_.erase(symbol);
+    trackIndex_.update(tracks_, index, trackSymbol);
 }
 
 Track* Project::getTrack(const std::string& trackId) {
-    auto it = std::find_if(tracks_.begin(), tracks_.end(),
-        [&trackId](const Track& t) { return t.getId() == trackId; });
-    
-    return (it != tracks_.end()) ? &(*it) : nullptr;
+    return getTrackBySymbol(domainSymbols().find(trackId));
 }
 
 const Track* Project::getTrack(const std::string& trackId) const {
-    auto it = std::find_if(tracks_.begin(), tracks_.end(),
-        [&trackId](const Track& t) { return t.getId() == trackId; });
-    
-    return (it != tracks_.end()) ? &(*it) : nullptr;
+    return getTrackBySymbol(domainSymbols().find(trackId));
+}
+
+Track* Project::getTrackBySymbol(SymbolId trackId) {
+    size_t index = trackIndex_.find(trackId);
+    return index != SymbolIndex::NONE ? &tracks_[index] : nullptr;
+}
+
+const Track* Project::getTrackBySymbol(SymbolId trackId) const {
+    size_t index = trackIndex_.find(trackId);
+    return index != SymbolIndex::NONE ? &tracks_[index] : nullptr;
 }
 
 Track* Project::getTrack(size_t index) {
@@ -54,6 +89,8 @@ void Project::clear() {
     patterns_.clear();
     instruments_.clear();
     tracks_.clear();
+    trackIndex_.clear();
+    markAllChanged();
 }
 
 void Project::createDefault() {
@@ -63,7 +100,7 @@ void Project::createDefault() {
     
     // Create one default track
     Track defaultTrack("track_0", "Drums");
-    tracks_.push_back(defaultTrack);
+    addTrack(defaultTrack);
     
     // Create default instruments (kick, snare, hi-hat)
     Instrument kick(1, "Kick");
@@ -75,6 +112,34 @@ void Project::createDefault() {
     instruments_.addInstrument(hihat);
     
     revision_ = 0;
+    markAllChanged();
+}
+
+void Project::drainChanges(std::vector<Change>& out) {
+    journal_.drainInto(out);
+    tempoMap_.drainChanges(out);
+    meterMap_.drainChanges(out);
+    patterns_.drainChanges(out);
+    for (auto& track : tracks_) {
+        track.drainChanges(out);
+    }
+}
+
+void Project::recordTrackRange(const Track& track, bool added) {
+    if (track.getRegions().empty()) {
+        return;
+    }
+    
+    Change change;
+    change.kind = added ? ChangeKind::RegionAdded : ChangeKind::RegionRemoved;
+    if (added) {
+        change.newStart = track.getStartTick();
+        change.newEnd = track.getEndTick();
+    } else {
+        change.oldStart = track.getStartTick();
+        change.oldEnd = track.getEndTick();
+    }
+    journal_.record(change);
 }
 
 } // namespace beater
@@ -46,6 +46,10 @@ public:
     Track* getTrack(size_t index);
     const Track* getTrack(size_t index) const;
     
+    // O(1) lookup by interned id
+    Track* getTrackBySymbol(SymbolId trackId);
+    const Track* getTrackBySymbol(SymbolId trackId) const;
+    
     const std::vector<Track>& getTracks() const { return tracks_; }
     size_t getTrackCount() const { return tracks_.size(); }
     
@@ -55,6 +59,13 @@ public:
     // Create a default empty project with one track
     void createDefault();
     
+    // Move every pending change record (tracks, regions, patterns, tempo,
+    // meter) to out, for incremental recompilation
+    // Edits that bypass the journaled mutators (e.g. region timing through a
+    // mutable Region*) are not seen; record a Reset with markAllChanged().
+    void drainChanges(std::vector<Change>& out);
+    void markAllChanged() { journal_.record({ChangeKind::Reset}); }
+    
 private:
     std::string name_ = "Untitled";
     uint64_t revision_ = 0;
@@ -64,6 +75,11 @@ private:
     PatternLibrary patterns_;
     InstrumentRack instruments_;
     std::vector<Track> tracks_;
+    SymbolIndex trackIndex_;  // Track id -> position in tracks_
+    ChangeJournal journal_;   // Tracks added/removed, whole-project edits
+    
+    // Record that every tick a track's regions cover has changed
+    void recordTrackRange(const Track& track, bool added);
 };
 
 } // namespace beater
@@ -3,7 +3,7 @@
 namespace beater {
 
 Region::Region(const std::string& id, RegionType type, Tick startTick, Tick lengthTicks)
-    : id_(id), type_(type), startTick_(startTick), lengthTicks_(lengthTicks) {
+    : id_(domainSymbols().intern(id)), type_(type), startTick_(startTick), lengthTicks_(lengthTicks) {
 }
 
 } // namespace beater
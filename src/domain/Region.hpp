@@ -1,5 +1,6 @@
 #pragma once
 
+#include "domain/SymbolTable.hpp"
 #include "domain/TimeTypes.hpp"
 #include <string>
 
@@ -21,25 +22,29 @@ enum class StretchMode {
 };
 
 // Region: a block on the timeline referencing a pattern
+// Its id and pattern id are interned; the string getters resolve them.
 class Region {
 public:
     Region() = default;
     Region(const std::string& id, RegionType type, Tick startTick, Tick lengthTicks);
     
     // Accessors
-    const std::string& getId() const { return id_; }
+    const std::string& getId() const { return domainSymbols().name(id_); }
+    SymbolId getSymbol() const { return id_; }
     RegionType getType() const { return type_; }
     Tick getStartTick() const { return startTick_; }
     Tick getLengthTicks() const { return lengthTicks_; }
     Tick getEndTick() const { return startTick_ + lengthTicks_; }
-    const std::string& getPatternId() const { return patternId_; }
+    const std::string& getPatternId() const { return domainSymbols().name(patternId_); }
+    SymbolId getPatternSymbol() const { return patternId_; }
     StretchMode getStretchMode() const { return stretchMode_; }
     bool getSnapToBars() const { return snapToBars_; }
     
     // Mutators
     void setStartTick(Tick tick) { startTick_ = tick; }
     void setLengthTicks(Tick ticks) { lengthTicks_ = ticks; }
-    void setPatternId(const std::string& id) { patternId_ = id; }
+    void setPatternId(const std::string& id) { patternId_ = domainSymbols().intern(id); }
+    void setPatternSymbol(SymbolId id) { patternId_ = id; }
     void setStretchMode(StretchMode mode) { stretchMode_ = mode; }
     void setSnapToBars(bool snap) { snapToBars_ = snap; }
     
@@ -54,11 +59,11 @@ public:
     }
     
 private:
-    std::string id_;
+    SymbolId id_ = EMPTY_SYMBOL;
     RegionType type_ = RegionType::Groove;
     Tick startTick_ = 0;
     Tick lengthTicks_ = PPQ * 4; // Default: 1 bar
-    std::string patternId_;
+    SymbolId patternId_ = EMPTY_SYMBOL;
     StretchMode stretchMode_ = StretchMode::Repeat;
     bool snapToBars_ = true; // MVP: always snap to bars
 };
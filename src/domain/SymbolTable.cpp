@@ -0,0 +1,135 @@
+#include "domain/SymbolTable.hpp"
+#include <stdexcept>
+
+namespace beater {
+
+SymbolTable::SymbolTable() {
+    intern("");
+}
+
+SymbolTable::~SymbolTable() {
+    for (auto& chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+size_t SymbolTable::chunkOf(SymbolId id) {
+    // floor(log2(id / FIRST_CHUNK_SIZE + 1))
+    size_t q = id / FIRST_CHUNK_SIZE + 1;
+    size_t chunk = 0;
+    while (q >>= 1) {
+        ++chunk;
+    }
+    return chunk;
+}
+
+SymbolId SymbolTable::intern(std::string_view name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    SymbolId id = count_.load(std::memory_order_relaxed);
+    size_t chunk = chunkOf(id);
+    if (chunk >= MAX_CHUNKS) {
+        throw std::length_error("SymbolTable: out of symbol ids");
+    }
+    std::string* names = chunks_[chunk].load(std::memory_order_relaxed);
+    if (!names) {
+        names = new std::string[chunkSize(chunk)];
+        chunks_[chunk].store(names, std::memory_order_release);
+    }
+
+    std::string& slot = names[id - chunkStart(chunk)];
+    slot.assign(name);
+    ids_.emplace(slot, id);
+
+    // Publish: readers that see the new count see the name
+    count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+SymbolId SymbolTable::find(std::string_view name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : INVALID_SYMBOL;
+}
+
+const std::string& SymbolTable::name(SymbolId id) const {
+    if (id >= count_.load(std::memory_order_acquire)) {
+        throw std::out_of_range("SymbolTable: unknown symbol id");
+    }
+    size_t chunk = chunkOf(id);
+    return chunks_[chunk].load(std::memory_order_acquire)[id - chunkStart(chunk)];
+}
+
+SymbolTable& domainSymbols() {
+    static SymbolTable symbols;
+    return symbols;
+}
+
+void SymbolIndex::assign(SymbolId id, uint32_t position) {
+    if ((count_ + 1) * 2 > entries_.size()) {
+        rehash(entries_.empty() ? 8 : entries_.size() * 2);
+    }
+    size_t mask = entries_.size() - 1;
+    for (size_t slot = home(id);; slot = (slot + 1) & mask) {
+        Entry& entry = entries_[slot];
+        if (entry.id == id) {
+            entry.position = position;
+            return;
+        }
+        if (entry.id == INVALID_SYMBOL) {
+            entry = {id, position};
+            ++count_;
+            return;
+        }
+    }
+}
+
+void SymbolIndex::erase(SymbolId id) {
+    if (entries_.empty() || id == INVALID_SYMBOL) {
+        return;
+    }
+    size_t mask = entries_.size() - 1;
+    size_t hole = home(id);
+    while (entries_[hole].id != id) {
+        if (entries_[hole].id == INVALID_SYMBOL) {
+            return;
+        }
+        hole = (hole + 1) & mask;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the
+    // hole unless that would put them before their home slot
+    for (size_t slot = (hole + 1) & mask; entries_[slot].id != INVALID_SYMBOL; slot = (slot + 1) & mask) {
+        size_t want = home(entries_[slot].id);
+        bool homeInRange = hole <= slot ? (hole < want && want <= slot)
+                                        : (hole < want || want <= slot);
+        if (!homeInRange) {
+            entries_[hole] = entries_[slot];
+            hole = slot;
+        }
+    }
+    entries_[hole] = Entry{};
+    --count_;
+}
+
+void SymbolIndex::rehash(size_t size) {
+    std::vector<Entry> old;
+    old.swap(entries_);
+    entries_.assign(size, Entry{});
+    shift_ = 32;
+    for (size_t s = size; s > 1; s >>= 1) {
+        --shift_;
+    }
+    count_ = 0;
+    for (const Entry& entry : old) {
+        if (entry.id != INVALID_SYMBOL) {
+            assign(entry.id, entry.position);
+        }
+    }
+}
+
+} // namespace beater
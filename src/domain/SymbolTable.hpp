@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace beater {
+
+// Interned string id: a dense 32-bit handle
+using SymbolId = uint32_t;
+constexpr SymbolId EMPTY_SYMBOL = 0;             // The empty string
+constexpr SymbolId INVALID_SYMBOL = UINT32_MAX;  // find(): never interned
+
+// Symbol table: interns string ids to dense integer handles
+//
+// Domain objects keep their ids as SymbolIds, so comparing and looking up
+// ids is integer work; the strings are only needed at the edges (files,
+// UI labels). Symbols are never removed, so a SymbolId and the string it
+// names stay valid for the life of the table.
+//
+// Thread-safe. intern() and find() take a mutex; name() and size() do not:
+// the names live in append-only chunks (each twice the size of the last)
+// that are never moved or freed, and a new name is published by a release
+// store of the count, so a reader holding an id only needs an acquire load.
+// That keeps name() cheap enough for paint and hit-test paths.
+class SymbolTable {
+public:
+    SymbolTable();
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    // Handle for a string, adding it if new
+    SymbolId intern(std::string_view name);
+
+    // Handle for a string, or INVALID_SYMBOL if it was never interned
+    SymbolId find(std::string_view name) const;
+
+    // String for a handle from this table (lock-free; throws
+    // std::out_of_range for an id it never handed out)
+    const std::string& name(SymbolId id) const;
+
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t FIRST_CHUNK_SIZE = 256;
+    static constexpr size_t MAX_CHUNKS = 24;  // 256 * (2^24 - 1) ids in all
+
+    // Chunk k holds ids [FIRST_CHUNK_SIZE * (2^k - 1), FIRST_CHUNK_SIZE * (2^(k+1) - 1))
+    static size_t chunkOf(SymbolId id);
+    static size_t chunkStart(size_t chunk) { return FIRST_CHUNK_SIZE * ((size_t{1} << chunk) - 1); }
+    static size_t chunkSize(size_t chunk) { return FIRST_CHUNK_SIZE << chunk; }
+
+    std::atomic<std::string*> chunks_[MAX_CHUNKS] = {};
+    std::atomic<uint32_t> count_{0};
+
+    mutable std::mutex mutex_;  // Writers, and the string -> id map
+    std::unordered_map<std::string_view, SymbolId> ids_;  // Keys view into chunks_
+};
+
+// Table shared by the domain model
+// Process-wide rather than per project: domain objects are value types that
+// are created before they join a project and copied into engine snapshots,
+// and one table keeps their handles valid everywhere.
+SymbolTable& domainSymbols();
+
+// SymbolId -> container position lookup
+// Kept next to a vector of objects with symbol ids for O(1) find by id. An
+// open-addressed table sized by the container (not by the largest SymbolId
+// in the process), so each index costs memory in proportion to its items.
+class SymbolIndex {
+public:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    size_t find(SymbolId id) const {
+        if (entries_.empty() || id == INVALID_SYMBOL) {
+            return NONE;
+        }
+        for (size_t slot = home(id);; slot = (slot + 1) & (entries_.size() - 1)) {
+            if (entries_[slot].id == id) {
+                return entries_[slot].position;
+            }
+            if (entries_[slot].id == INVALID_SYMBOL) {
+                return NONE;
+            }
+        }
+    }
+
+    void erase(SymbolId id);
+
+    void clear() {
+        entries_.clear();
+        count_ = 0;
+        shift_ = 32;
+    }
+
+    size_t size() const { return count_; }
+
+    // Re-point the ids of items[from..] at their positions (after inserting,
+    // removing or reordering there). With duplicate ids the first one wins.
+    template <typename T, typename SymbolOf>
+    void update(const std::vector<T>& items, size_t from, SymbolOf symbolOf) {
+        for (size_t i = from; i < items.size(); ++i) {
+            SymbolId id = symbolOf(items[i]);
+            size_t existing = find(id);
+            if (existing < i && symbolOf(items[existing]) == id) {
+                continue;
+            }
+            assign(id, static_cast<uint32_t>(i));
+        }
+    }
+
+private:
+    struct Entry {
+        SymbolId id = INVALID_SYMBOL;  // INVALID_SYMBOL: free slot
+        uint32_t position = 0;
+    };
+
+    std::vector<Entry> entries_;  // Power-of-two size, at most half full
+    size_t count_ = 0;
+    unsigned shift_ = 32;         // 32 - log2(entries_.size())
+
+    // Preferred slot (Fibonacci hashing: the top bits of id * 2^32/phi)
+    size_t home(SymbolId id) const {
+        return static_cast<size_t>(static_cast<uint32_t>(id * 2654435769u) >> shift_);
+    }
+
+    void assign(SymbolId id, uint32_t position);
+    void rehash(size_t size);
+};
+
+} // namespace beater
@@ -12,12 +12,35 @@ TempoMap::TempoMap(double initialBpm) {
     changes_.push_back({0, initialBpm});
 }
 
-void TempoMap::addChange(Tick atTick, double bpm) {
+void TempoMap::addChange(Tick atTick, double bpm, bool rampToNext) {
     // Remove any existing change at this exact tick
     removeChangeAt(atTick);
     
-    changes_.push_back({atTick, bpm});
+    changes_.push_back({atTick, bpm, rampToNext});
     sortChanges();
+    recordChange(atTick);
+}
+
+void TempoMap::setBpmAt(Tick atTick, double bpm) {
+    for (auto& change : changes_) {
+        if (change.atTick == atTick) {
+            change.bpm = bpm;
+            recordChange(atTick);
+            return;
+        }
+    }
+    addChange(atTick, bpm);
+}
+
+void TempoMap::addRamp(Tick startTick, double startBpm, Tick endTick, double endBpm) {
+    bool endRamps = false;
+    for (const auto& change : changes_) {
+        if (change.atTick == endTick) {
+            endRamps = change.ramp;
+        }
+    }
+    addChange(endTick, endBpm, endRamps);
+    addChange(startTick, startBpm, true);
 }
 
 void TempoMap::removeChangeAt(Tick tick) {
@@ -26,6 +49,7 @@ void TempoMap::removeChangeAt(Tick tick) {
             [tick](const TempoChange& tc) { return tc.atTick == tick; }),
         changes_.end()
     );
+    recordChange(tick);
 }
 
 double TempoMap::getBpmAt(Tick tick) const {
@@ -33,26 +57,32 @@ double TempoMap::getBpmAt(Tick tick) const {
         return 120.0; // fallback
     }
     
-    // Find the last tempo change at or before this tick
-    double bpm = changes_[0].bpm;
-    for (const auto& change : changes_) {
-        if (change.atTick <= tick) {
-            bpm = change.bpm;
-        } else {
-            break;
-        }
+    // Last tempo change at or before this tick (changes are kept sorted);
+    // before the first one its tempo applies
+    auto it = std::upper_bound(changes_.begin(), changes_.end(), tick,
+        [](Tick t, const TempoChange& change) { return t < change.atTick; });
+    if (it == changes_.begin()) {
+        return changes_.front().bpm;
     }
     
-    return bpm;
+    const TempoChange& change = *(it - 1);
+    if (!change.ramp || it == changes_.end()) {
+        return change.bpm;
+    }
+    const double position = static_cast<double>(tick - change.atTick) /
+                            static_cast<double>(it->atTick - change.atTick);
+    return change.bpm + (it->bpm - change.bpm) * position;
 }
 
 void TempoMap::clear() {
     changes_.clear();
+    recordChange(0);
 }
 
 void TempoMap::setConstantTempo(double bpm) {
     changes_.clear();
     changes_.push_back({0, bpm});
+    recordChange(0);
 }
 
 void TempoMap::sortChanges() {
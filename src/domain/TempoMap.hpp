@@ -1,5 +1,6 @@
 #pragma once
 
+#include "domain/ChangeJournal.hpp"
 #include "domain/TimeTypes.hpp"
 #include <vector>
 
@@ -9,25 +10,39 @@ namespace beater {
 struct TempoChange {
     Tick atTick = 0;
     double bpm = 120.0;
+    bool ramp = false;  // Ramp linearly (in BPM) to the next change's tempo
     
     bool operator<(const TempoChange& other) const {
         return atTick < other.atTick;
     }
+    
+    bool operator==(const TempoChange& other) const {
+        return atTick == other.atTick && bpm == other.bpm && ramp == other.ramp;
+    }
 };
 
-// Tempo map: piecewise constant tempo across timeline
+// Tempo map: piecewise constant tempo across timeline, with optional
+// linear ramps between changes (accelerando/ritardando)
 class TempoMap {
 public:
     TempoMap();
     explicit TempoMap(double initialBpm);
     
-    // Add a tempo change
-    void addChange(Tick atTick, double bpm);
+    // Add a tempo change; rampToNext glides from it to the next change
+    void addChange(Tick atTick, double bpm, bool rampToNext = false);
+    
+    // Set the tempo of the change at atTick, keeping whether it ramps
+    // (adds a step change if there is none there)
+    void setBpmAt(Tick atTick, double bpm);
+    
+    // Ramp linearly from startBpm at startTick to endBpm at endTick
+    // (a change at endTick keeps whether it ramps on)
+    void addRamp(Tick startTick, double startBpm, Tick endTick, double endBpm);
     
     // Remove tempo change at tick
     void removeChangeAt(Tick tick);
     
-    // Get BPM at a specific tick
+    // Get BPM at a specific tick, inside ramps too (binary search)
     double getBpmAt(Tick tick) const;
     
     // Get all tempo changes (sorted by tick)
@@ -39,10 +54,18 @@ public:
     // Set constant tempo (clears all changes, sets single initial tempo)
     void setConstantTempo(double bpm);
     
+    bool operator==(const TempoMap& other) const { return changes_ == other.changes_; }
+    bool operator!=(const TempoMap& other) const { return !(*this == other); }
+    
+    // Move pending change records to out
+    void drainChanges(std::vector<Change>& out) { journal_.drainInto(out); }
+    
 private:
     std::vector<TempoChange> changes_;
+    ChangeJournal journal_;
     
     void sortChanges();
+    void recordChange(Tick fromTick) { journal_.record({ChangeKind::TempoChanged, EMPTY_SYMBOL, fromTick}); }
 };
 
 } // namespace beater
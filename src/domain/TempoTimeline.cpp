@@ -0,0 +1,147 @@
+#include "domain/TempoTimeline.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace beater {
+
+TempoTimeline::TempoTimeline() {
+    compileConstant(120.0, 48000);
+}
+
+TempoTimeline::TempoTimeline(const TempoMap& tempoMap, uint32_t sampleRate) {
+    compile(tempoMap, sampleRate);
+}
+
+void TempoTimeline::compile(const TempoMap& tempoMap, uint32_t sampleRate) {
+    const auto& changes = tempoMap.getChanges();
+    if (changes.empty()) {
+        compileConstant(120.0, sampleRate);
+        return;
+    }
+
+    sampleRate_ = sampleRate;
+    framesPerBeatTick_ = sampleRate * 60.0 / PPQ;
+    segments_.clear();
+    segments_.reserve(changes.size());
+
+    // The first tempo also applies before its own tick
+    appendSegment(0, changes.front().bpm, 0.0);
+    for (size_t i = 0; i < changes.size(); ++i) {
+        const auto& change = changes[i];
+
+        // A ramp runs to the next change; the last change holds its tempo
+        double slope = 0.0;
+        if (change.ramp && i + 1 < changes.size() && changes[i + 1].atTick > change.atTick) {
+            slope = (changes[i + 1].bpm - change.bpm) /
+                    static_cast<double>(changes[i + 1].atTick - change.atTick);
+        }
+
+        if (change.atTick <= 0) {
+            // Replaces the initial segment (a ramp begun earlier is picked up at tick 0)
+            setSegmentTempo(segments_.back(), change.bpm - slope * static_cast<double>(change.atTick), slope);
+        } else if (change.atTick > segments_.back().startTick) {
+            appendSegment(change.atTick, change.bpm, slope);
+        }
+    }
+}
+
+void TempoTimeline::compileConstant(double bpm, uint32_t sampleRate) {
+    sampleRate_ = sampleRate;
+    framesPerBeatTick_ = sampleRate * 60.0 / PPQ;
+    segments_.clear();
+    appendSegment(0, bpm, 0.0);
+}
+
+void TempoTimeline::appendSegment(Tick startTick, double bpm, double slope) {
+    Segment segment;
+    segment.startTick = startTick;
+    segment.startFrame = segments_.empty() ? 0.0 : tickToFrameExact(static_cast<double>(startTick));
+    setSegmentTempo(segment, bpm, slope);
+    segments_.push_back(segment);
+}
+
+void TempoTimeline::setSegmentTempo(Segment& segment, double bpm, double slope) {
+    segment.bpm = bpm;
+    segment.slope = slope;
+    segment.framesPerTick = TimeUtils::framesPerTick(bpm, sampleRate_);
+    segment.ticksPerFrame = 1.0 / segment.framesPerTick;
+}
+
+const TempoTimeline::Segment& TempoTimeline::segmentAtTick(double tick) const {
+    // Last segment starting at or before tick
+    auto it = std::upper_bound(segments_.begin() + 1, segments_.end(), tick,
+        [](double t, const Segment& segment) { return t < segment.startTick; });
+    return *(it - 1);
+}
+
+const TempoTimeline::Segment& TempoTimeline::segmentAtFrame(double frame) const {
+    auto it = std::upper_bound(segments_.begin() + 1, segments_.end(), frame,
+        [](double f, const Segment& segment) { return f < segment.startFrame; });
+    return *(it - 1);
+}
+
+double TempoTimeline::tickToFrameExact(double tick) const {
+    const Segment& segment = segmentAtTick(tick);
+    const double ticks = tick - segment.startTick;
+    if (segment.slope == 0.0 || ticks <= 0.0) {
+        return segment.startFrame + ticks * segment.framesPerTick;
+    }
+
+    // frames = integral of framesPerBeatTick / bpm(t) dt, bpm(t) = bpm + slope * t
+    return segment.startFrame + framesPerBeatTick_ / segment.slope *
+           std::log1p(segment.slope * ticks / segment.bpm);
+}
+
+double TempoTimeline::frameToTickExact(double frame) const {
+    const Segment& segment = segmentAtFrame(frame);
+    const double frames = frame - segment.startFrame;
+    if (segment.slope == 0.0 || frames <= 0.0) {
+        return segment.startTick + frames * segment.ticksPerFrame;
+    }
+
+    // Inverse of the integral above
+    return segment.startTick + segment.bpm / segment.slope *
+           std::expm1(segment.slope * frames / framesPerBeatTick_);
+}
+
+uint64_t TempoTimeline::tickToFrame(Tick tick) const {
+    const double frame = std::round(tickToFrameExact(static_cast<double>(tick)));
+    return frame > 0.0 ? static_cast<uint64_t>(frame) : 0;
+}
+
+Tick TempoTimeline::frameToTick(uint64_t frame) const {
+    return static_cast<Tick>(std::round(frameToTickExact(static_cast<double>(frame))));
+}
+
+Tick TempoTimeline::firstTickAtFrame(uint64_t frame) const {
+    // Rounded estimate, then correct by at most a tick either way
+    Tick tick = frameToTick(frame);
+    while (tickToFrame(tick) < frame) {
+        ++tick;
+    }
+    while (tick > 0 && tickToFrame(tick - 1) >= frame) {
+        --tick;
+    }
+    return tick;
+}
+
+double TempoTimeline::getBpmAt(Tick tick) const {
+    const Segment& segment = segmentAtTick(static_cast<double>(tick));
+    const double ticks = std::max(0.0, static_cast<double>(tick - segment.startTick));
+    return segment.bpm + segment.slope * ticks;
+}
+
+double TempoTimeline::getBpmAtFrame(uint64_t frame) const {
+    const Segment& segment = segmentAtFrame(static_cast<double>(frame));
+    if (segment.slope == 0.0) {
+        return segment.bpm;
+    }
+    const double ticks = std::max(0.0, frameToTickExact(static_cast<double>(frame)) - segment.startTick);
+    return segment.bpm + segment.slope * ticks;
+}
+
+bool TempoTimeline::operator==(const TempoTimeline& other) const {
+    return sampleRate_ == other.sampleRate_ && segments_ == other.segments_;
+}
+
+} // namespace beater
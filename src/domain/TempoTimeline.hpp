@@ -0,0 +1,76 @@
+#pragma once
+
+#include "domain/TimeTypes.hpp"
+#include "domain/TempoMap.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace beater {
+
+// Compiled tempo map for one sample rate
+//
+// Each tempo segment stores the exact frame at which it starts, so
+// converting between ticks and frames is a binary search over the segments
+// plus one multiply-add, and tempo changes anywhere (including inside an
+// audio block) are honoured exactly. Ramp segments (BPM linear in ticks)
+// use the closed-form integral instead: a log going to frames, an exp
+// coming back. Rebuild when the tempo map or the sample rate changes.
+class TempoTimeline {
+public:
+    TempoTimeline();  // 120 BPM at 48 kHz
+    TempoTimeline(const TempoMap& tempoMap, uint32_t sampleRate);
+
+    // Rebuild from a tempo map (reuses storage where possible)
+    void compile(const TempoMap& tempoMap, uint32_t sampleRate);
+
+    // Rebuild as a single constant tempo (no allocation once built)
+    void compileConstant(double bpm, uint32_t sampleRate);
+
+    // Exact conversions
+    double tickToFrameExact(double tick) const;
+    double frameToTickExact(double frame) const;
+
+    // Rounded to the nearest frame/tick (matches TimeUtils at constant tempo)
+    uint64_t tickToFrame(Tick tick) const;
+    Tick frameToTick(uint64_t frame) const;
+
+    // First tick whose frame position is at or after the given frame
+    Tick firstTickAtFrame(uint64_t frame) const;
+
+    // Tempo in effect at a position
+    double getBpmAt(Tick tick) const;
+    double getBpmAtFrame(uint64_t frame) const;
+
+    uint32_t getSampleRate() const { return sampleRate_; }
+    size_t getSegmentCount() const { return segments_.size(); }
+
+    bool operator==(const TempoTimeline& other) const;
+    bool operator!=(const TempoTimeline& other) const { return !(*this == other); }
+
+private:
+    struct Segment {
+        Tick startTick = 0;
+        double startFrame = 0.0;     // Exact frame of startTick
+        double framesPerTick = 0.0;
+        double ticksPerFrame = 0.0;
+        double bpm = 120.0;          // At startTick
+        double slope = 0.0;          // BPM per tick; 0 for constant tempo
+
+        bool operator==(const Segment& other) const {
+            return startTick == other.startTick && startFrame == other.startFrame &&
+                   framesPerTick == other.framesPerTick && bpm == other.bpm &&
+                   slope == other.slope;
+        }
+    };
+
+    std::vector<Segment> segments_;  // Sorted; the first starts at tick 0
+    uint32_t sampleRate_ = 48000;
+    double framesPerBeatTick_ = 0.0; // framesPerTick * bpm (sampleRate * 60 / PPQ)
+
+    void appendSegment(Tick startTick, double bpm, double slope);
+    void setSegmentTempo(Segment& segment, double bpm, double slope);
+    const Segment& segmentAtTick(double tick) const;
+    const Segment& segmentAtFrame(double frame) const;
+};
+
+} // namespace beater
@@ -1,50 +1,167 @@
 #include "domain/Track.hpp"
+#include <limits>
 
 namespace beater {
 
 Track::Track(const std::string& id, const std::string& name)
-    : id_(id), name_(name) {
+    : id_(domainSymbols().intern(id)), name_(name) {
 }
 
+namespace {
+
+bool regionStartLess(const Region& a, const Region& b) {
+    return a.getStartTick() < b.getStartTick();
+}
+
+SymbolId regionSymbol(const Region& region) {
+    return region.getSymbol();
+}
+
+} // namespace
+
 void Track::addRegion(const Region& region) {
-    regions_.push_back(region);
+    // Insert in start order (after equal starts) and update the index from there
+    auto it = std::upper_bound(regions_.begin(), regions_.end(), region, regionStartLess);
+    size_t index = static_cast<size_t>(it - regions_.begin());
+    regions_.insert(it, region);
+    reindex(index);
+    journal_.record({ChangeKind::RegionAdded, region.getSymbol(), 0, 0,
+                     region.getStartTick(), region.getEndTick()});
+}
+
+void Track::addRegions(const std::vector<Region>& regions) {
+    if (regions.empty()) {
+        return;
+    }
+    
+    for (const auto& region : regions) {
+        journal_.record({ChangeKind::RegionAdded, region.getSymbol(), 0, 0,
+                         region.getStartTick(), region.getEndTick()});
+    }
     
-    // Keep regions sorted by start time for efficient queries
-    std::sort(regions_.begin(), regions_.end(),
-        [](const Region& a, const Region& b) {
-            return a.getStartTick() < b.getStartTick();
-        });
+    auto middle = static_cast<std::ptrdiff_t>(regions_.size());
+    regions_.insert(regions_.end(), regions.begin(), regions.end());
+    std::stable_sort(regions_.begin() + middle, regions_.end(), regionStartLess);
+    
+    // Existing regions before the earliest new start are not moved
+    auto unchanged = std::upper_bound(regions_.begin(), regions_.begin() + middle,
+                                      regions_[static_cast<size_t>(middle)], regionStartLess);
+    std::inplace_merge(regions_.begin(), regions_.begin() + middle, regions_.end(), regionStartLess);
+    reindex(static_cast<size_t>(unchanged - regions_.begin()));
 }
 
 void Track::removeRegion(const std::string& regionId) {
-    regions_.erase(
-        std::remove_if(regions_.begin(), regions_.end(),
-            [&regionId](const Region& r) { return r.getId() == regionId; }),
-        regions_.end()
-    );
+    SymbolId symbol = domainSymbols().find(regionId);
+    size_t index = index_.find(symbol);
+    if (symbol == INVALID_SYMBOL || index == SymbolIndex::NONE) {
+        return;
+    }
+    
+    // Everything before the first match keeps its place (and index entries)
+    auto matches = [symbol](const Region& r) { return r.getSymbol() == symbol; };
+    auto first = regions_.begin() + static_cast<std::ptrdiff_t>(index);
+    for (auto it = first; it != regions_.end(); ++it) {
+        if (matches(*it)) {
+            journal_.record({ChangeKind::RegionRemoved, symbol,
+                             it->getStartTick(), it->getEndTick(), 0, 0});
+        }
+    }
+    regions_.erase(std::remove_if(first, regions_.end(), matches), regions_.end());
+    index_.erase(symbol);
+    reindex(index);
 }
 
 Region* Track::getRegion(const std::string& regionId) {
-    auto it = std::find_if(regions_.begin(), regions_.end(),
-        [&regionId](const Region& r) { return r.getId() == regionId; });
-    
-    return (it != regions_.end()) ? &(*it) : nullptr;
+    return getRegion(domainSymbols().find(regionId));
 }
 
 const Region* Track::getRegion(const std::string& regionId) const {
-    auto it = std::find_if(regions_.begin(), regions_.end(),
-        [&regionId](const Region& r) { return r.getId() == regionId; });
+    return getRegion(domainSymbols().find(regionId));
+}
+
+Region* Track::getRegion(SymbolId regionId) {
+    size_t index = index_.find(regionId);
+    return index != SymbolIndex::NONE ? &regions_[index] : nullptr;
+}
+
+const Region* Track::getRegion(SymbolId regionId) const {
+    size_t index = index_.find(regionId);
+    return index != SymbolIndex::NONE ? &regions_[index] : nullptr;
+}
+
+size_t Track::setRegionBounds(size_t index, Tick startTick, Tick lengthTicks) {
+    if (index >= regions_.size()) {
+        return index;
+    }
+    
+    Region& region = regions_[index];
+    journal_.record({ChangeKind::RegionChanged, region.getSymbol(),
+                     region.getStartTick(), region.getEndTick(),
+                     startTick, startTick + lengthTicks});
+    
+    region.setStartTick(startTick);
+    region.setLengthTicks(lengthTicks);
+    
+    // Slide the region to its sorted place (usually it stays put or moves by
+    // one during a drag) instead of re-sorting everything
+    size_t newIndex = index;
+    while (newIndex > 0 && regions_[newIndex - 1].getStartTick() > startTick) {
+        std::swap(regions_[newIndex - 1], regions_[newIndex]);
+        --newIndex;
+    }
+    while (newIndex + 1 < regions_.size() && regions_[newIndex + 1].getStartTick() < startTick) {
+        std::swap(regions_[newIndex + 1], regions_[newIndex]);
+        ++newIndex;
+    }
+    
+    reindex(std::min(index, newIndex));
+    return newIndex;
+}
+
+void Track::setRegionPattern(size_t index, const std::string& patternId) {
+    if (index >= regions_.size()) {
+        return;
+    }
+    
+    Region& region = regions_[index];
+    region.setPatternId(patternId);
+    journal_.record({ChangeKind::RegionChanged, region.getSymbol(),
+                     region.getStartTick(), region.getEndTick(),
+                     region.getStartTick(), region.getEndTick()});
+}
+
+void Track::reindex(size_t from) {
+    maxEnd_.resize(regions_.size());
+    Tick running = from > 0 ? maxEnd_[from - 1] : std::numeric_limits<Tick>::min();
+    for (size_t i = from; i < regions_.size(); ++i) {
+        running = std::max(running, regions_[i].getEndTick());
+        maxEnd_[i] = running;
+    }
+    index_.update(regions_, from, regionSymbol);
+}
+
+std::pair<size_t, size_t> Track::candidateRange(Tick startTick, Tick endTick) const {
+    // Regions before `first` all end at or before startTick
+    size_t first = static_cast<size_t>(
+        std::upper_bound(maxEnd_.begin(), maxEnd_.end(), startTick) - maxEnd_.begin());
     
-    return (it != regions_.end()) ? &(*it) : nullptr;
+    // Regions from `last` on all start at or after endTick
+    size_t last = static_cast<size_t>(
+        std::lower_bound(regions_.begin(), regions_.end(), endTick,
+            [](const Region& r, Tick end) { return r.getStartTick() < end; }) - regions_.begin());
+    
+    return {first, std::max(first, last)};
 }
 
 std::vector<const Region*> Track::getRegionsInRange(Tick startTick, Tick endTick) const {
     std::vector<const Region*> result;
     
-    for (const auto& region : regions_) {
+    auto [first, last] = candidateRange(startTick, endTick);
+    for (size_t i = first; i < last; ++i) {
+        const Region& region = regions_[i];
         // Region overlaps with query range if:
         // region.start < endTick AND startTick < region.end
-        if (region.getStartTick() < endTick && startTick < region.getEndTick()) {
+        if (startTick < region.getEndTick()) {
             result.push_back(&region);
         }
     }
@@ -53,8 +170,9 @@ std::vector<const Region*> Track::getRegionsInRange(Tick startTick, Tick endTick
 }
 
 bool Track::wouldOverlap(const Region& newRegion) const {
-    for (const auto& existing : regions_) {
-        if (newRegion.overlaps(existing)) {
+    auto [first, last] = candidateRange(newRegion.getStartTick(), newRegion.getEndTick());
+    for (size_t i = first; i < last; ++i) {
+        if (newRegion.overlaps(regions_[i])) {
             return true;
         }
     }
@@ -62,7 +180,13 @@ bool Track::wouldOverlap(const Region& newRegion) const {
 }
 
 void Track::clearRegions() {
+    if (!regions_.empty()) {
+        journal_.record({ChangeKind::RegionRemoved, EMPTY_SYMBOL,
+                         getStartTick(), getEndTick(), 0, 0});
+    }
     regions_.clear();
+    maxEnd_.clear();
+    index_.clear();
 }
 
 } // namespace beater
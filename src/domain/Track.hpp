@@ -1,9 +1,11 @@
 #pragma once
 
+#include "domain/ChangeJournal.hpp"
 #include "domain/Region.hpp"
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <utility>
 
 namespace beater {
 
@@ -14,7 +16,8 @@ public:
     Track(const std::string& id, const std::string& name);
     
     // Accessors
-    const std::string& getId() const { return id_; }
+    const std::string& getId() const { return domainSymbols().name(id_); }
+    SymbolId getSymbol() const { return id_; }
     const std::string& getName() const { return name_; }
     bool isMuted() const { return muted_; }
     bool isSoloed() const { return soloed_; }
@@ -26,12 +29,32 @@ public:
     void setSoloed(bool soloed) { soloed_ = soloed; }
     
     // Region management
+    // Regions are kept sorted by start tick. Mutable pointers are for
+    // fields that do not affect playback (stretch mode, ...); move or resize
+    // a region with setRegionBounds() and change its pattern with
+    // setRegionPattern() so the range index and change journal stay correct.
     void addRegion(const Region& region);
+    
+    // Add many regions with one sort of the new ones, one merge and one
+    // index update (loading, pasting)
+    void addRegions(const std::vector<Region>& regions);
+    
     void removeRegion(const std::string& regionId);
     Region* getRegion(const std::string& regionId);
     const Region* getRegion(const std::string& regionId) const;
     
-    // Find regions in a time range
+    // O(1) lookup by interned id
+    Region* getRegion(SymbolId regionId);
+    const Region* getRegion(SymbolId regionId) const;
+    
+    // Move/resize the region at an index; returns its index after re-sorting
+    size_t setRegionBounds(size_t index, Tick startTick, Tick lengthTicks);
+    
+    // Point the region at an index to another pattern
+    void setRegionPattern(size_t index, const std::string& patternId);
+    
+    // Find regions in a time range (sorted by start tick)
+    // O(log n + k) when regions do not overlap
     std::vector<const Region*> getRegionsInRange(Tick startTick, Tick endTick) const;
     
     // Check if adding this region would create an overlap (for MVP)
@@ -40,12 +63,36 @@ public:
     // Clear all regions
     void clearRegions();
     
+    // Ticks spanned by all regions: [first start, last end); empty if none
+    Tick getStartTick() const { return regions_.empty() ? 0 : regions_.front().getStartTick(); }
+    Tick getEndTick() const { return maxEnd_.empty() ? 0 : maxEnd_.back(); }
+    
+    // Move pending change records (region edits) to out
+    void drainChanges(std::vector<Change>& out) { journal_.drainInto(out); }
+    
 private:
-    std::string id_;
+    SymbolId id_ = EMPTY_SYMBOL;
     std::string name_ = "Track";
     bool muted_ = false;
     bool soloed_ = false;
     std::vector<Region> regions_;
+    
+    // Range index: maxEnd_[i] is the largest end tick of regions_[0..i]
+    // Non-decreasing, so the first region that can reach a tick is found by
+    // binary search, as is the last one starting before a tick.
+    std::vector<Tick> maxEnd_;
+    
+    // Region id -> position in regions_
+    SymbolIndex index_;
+    
+    // Region edits since the last drain
+    ChangeJournal journal_;
+    
+    // Recompute maxEnd_ and index_ from an index on (after a mutation there)
+    void reindex(size_t from);
+    
+    // Index range [first, last) of regions that may intersect [start, end)
+    std::pair<size_t, size_t> candidateRange(Tick startTick, Tick endTick) const;
 };
 
 } // namespace beater
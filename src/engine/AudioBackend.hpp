@@ -0,0 +1,66 @@
+#pragma once
+
+#include <pthread.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace beater {
+
+// Callback function type for audio rendering
+// Parameters: nframes, outL, outR (zeroed by the backend before the call)
+using AudioCallback = std::function<void(uint32_t, float*, float*)>;
+
+// Audio output backend driving the engine's render callback
+// Implementations: JackAudioBackend (when built with JACK), NullAudioBackend
+// (manual or thread clocked, no device) and FileAudioBackend (renders to a
+// file).
+class AudioBackend {
+public:
+    virtual ~AudioBackend() = default;
+    
+    // Open the device/client and start calling the audio callback
+    virtual bool initialize(const std::string& clientName) = 0;
+    
+    // Stop calling the audio callback and release the device
+    virtual void shutdown() = 0;
+    
+    virtual bool isActive() const = 0;
+    
+    // Set before initialize(); called on the backend's audio thread
+    void setAudioCallback(AudioCallback callback) { audioCallback_ = std::move(callback); }
+    
+    virtual uint32_t getSampleRate() const = 0;
+    virtual uint32_t getBufferSize() const = 0;
+    
+    // Frames between a block being rendered and it being heard (0 if unknown)
+    virtual uint32_t getOutputLatency() const { return 0; }
+    
+    // Buffer under/overruns since initialize() (0 if the backend cannot tell)
+    virtual uint32_t getXrunCount() const { return 0; }
+    
+    // True if the callback runs against a real-time clock (rather than being
+    // stepped by the caller), so work can be done ahead of it
+    virtual bool isRealtime() const { return true; }
+    
+    // Start a thread that helps the audio callback, at the callback's
+    // real-time priority. False if the backend has no such facility (the
+    // caller then uses an ordinary thread).
+    virtual bool createRealtimeThread(pthread_t& thread, void* (*function)(void*), void* arg) {
+        (void)thread;
+        (void)function;
+        (void)arg;
+        return false;
+    }
+    
+    // Join a thread from createRealtimeThread (its function must be returning)
+    virtual void joinRealtimeThread(pthread_t thread) { pthread_join(thread, nullptr); }
+    
+    // Short name for logs and the UI ("jack", "null", "file")
+    virtual const char* getName() const = 0;
+    
+protected:
+    AudioCallback audioCallback_;
+};
+
+} // namespace beater
@@ -0,0 +1,118 @@
+#include "engine/AudioFileWriter.hpp"
+#include <sndfile.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace beater {
+
+namespace {
+
+int sndfileFormat(AudioFileFormat format) {
+    switch (format) {
+        case AudioFileFormat::Wav16:    return SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+        case AudioFileFormat::Wav24:    return SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+        case AudioFileFormat::WavFloat: return SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        case AudioFileFormat::Flac16:   return SF_FORMAT_FLAC | SF_FORMAT_PCM_16;
+        case AudioFileFormat::Flac24:   return SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+    }
+    return 0;
+}
+
+bool isIntegerFormat(AudioFileFormat format) {
+    return format != AudioFileFormat::WavFloat;
+}
+
+} // namespace
+
+AudioFileWriter::~AudioFileWriter() {
+    close();
+}
+
+bool AudioFileWriter::formatForPath(const std::string& filepath, int bitDepth,
+                                    AudioFileFormat& format) {
+    auto dot = filepath.find_last_of('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    std::string extension = filepath.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    if (extension == "wav") {
+        switch (bitDepth) {
+            case 16: format = AudioFileFormat::Wav16; return true;
+            case 24: format = AudioFileFormat::Wav24; return true;
+            case 32: format = AudioFileFormat::WavFloat; return true;
+        }
+    } else if (extension == "flac") {
+        switch (bitDepth) {
+            case 16: format = AudioFileFormat::Flac16; return true;
+            case 24: format = AudioFileFormat::Flac24; return true;
+        }
+    }
+    return false;
+}
+
+bool AudioFileWriter::open(const std::string& filepath, uint32_t sampleRate,
+                           AudioFileFormat format) {
+    close();
+    error_.clear();
+    framesWritten_ = 0;
+    
+    SF_INFO sfInfo;
+    std::memset(&sfInfo, 0, sizeof(sfInfo));
+    sfInfo.samplerate = static_cast<int>(sampleRate);
+    sfInfo.channels = 2;
+    sfInfo.format = sndfileFormat(format);
+    
+    if (!sf_format_check(&sfInfo)) {
+        error_ = "Unsupported output format";
+        return false;
+    }
+    
+    file_ = sf_open(filepath.c_str(), SFM_WRITE, &sfInfo);
+    if (file_ == nullptr) {
+        error_ = sf_strerror(nullptr);
+        return false;
+    }
+    
+    // The PEAK chunk carries a timestamp; leave it out so renders of the same
+    // project are byte-identical
+    sf_command(file_, SFC_SET_ADD_PEAK_CHUNK, nullptr, SF_FALSE);
+    
+    if (isIntegerFormat(format)) {
+        sf_command(file_, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+    }
+    return true;
+}
+
+bool AudioFileWriter::write(const float* left, const float* right, uint32_t nframes) {
+    if (file_ == nullptr) {
+        error_ = "File not open";
+        return false;
+    }
+    
+    interleaved_.resize(static_cast<size_t>(nframes) * 2);
+    for (uint32_t i = 0; i < nframes; ++i) {
+        interleaved_[i * 2] = left[i];
+        interleaved_[i * 2 + 1] = right[i];
+    }
+    
+    sf_count_t written = sf_writef_float(file_, interleaved_.data(), nframes);
+    framesWritten_ += static_cast<uint64_t>(std::max<sf_count_t>(written, 0));
+    if (written != static_cast<sf_count_t>(nframes)) {
+        error_ = sf_strerror(file_);
+        return false;
+    }
+    return true;
+}
+
+void AudioFileWriter::close() {
+    if (file_ != nullptr) {
+        sf_close(file_);
+        file_ = nullptr;
+    }
+}
+
+} // namespace beater
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// libsndfile handle (SNDFILE), kept out of the public headers
+struct sf_private_tag;
+
+namespace beater {
+
+// Output file encodings
+enum class AudioFileFormat {
+    Wav16,
+    Wav24,
+    WavFloat,
+    Flac16,
+    Flac24
+};
+
+// Stereo audio file writer (libsndfile)
+// Integer formats clip rather than wrap. Output depends only on the samples
+// written: no timestamps or other per-run metadata go into the file.
+class AudioFileWriter {
+public:
+    AudioFileWriter() = default;
+    ~AudioFileWriter();
+    
+    AudioFileWriter(const AudioFileWriter&) = delete;
+    AudioFileWriter& operator=(const AudioFileWriter&) = delete;
+    
+    // Pick a format from the file extension (.wav or .flac) and bit depth
+    // (16, 24, or 32 = float; FLAC has no float). False if unsupported.
+    static bool formatForPath(const std::string& filepath, int bitDepth,
+                              AudioFileFormat& format);
+    
+    // Create (or truncate) the file
+    bool open(const std::string& filepath, uint32_t sampleRate, AudioFileFormat format);
+    
+    // Append frames from separate left/right buffers
+    bool write(const float* left, const float* right, uint32_t nframes);
+    
+    // Finish the file (also done by the destructor)
+    void close();
+    
+    bool isOpen() const { return file_ != nullptr; }
+    uint64_t getFramesWritten() const { return framesWritten_; }
+    const std::string& getError() const { return error_; }
+    
+private:
+    sf_private_tag* file_ = nullptr;
+    uint64_t framesWritten_ = 0;
+    std::vector<float> interleaved_;
+    std::string error_;
+};
+
+} // namespace beater
@@ -1,10 +1,36 @@
 #include "engine/Engine.hpp"
+#include "engine/NullAudioBackend.hpp"
+#include "trace/Trace.hpp"
+#ifdef BEATER_HAVE_JACK
+#include "engine/JackAudioBackend.hpp"
+#endif
 #include <functional>
 #include <iostream>
+#include <vector>
 
 namespace beater {
 
-Engine::Engine() {
+namespace {
+
+std::unique_ptr<AudioBackend> createDefaultBackend() {
+#ifdef BEATER_HAVE_JACK
+    return std::make_unique<JackAudioBackend>();
+#else
+    return std::make_unique<NullAudioBackend>(48000, 256, NullClock::Thread);
+#endif
+}
+
+} // namespace
+
+Engine::Engine(size_t maxVoices)
+    : Engine(createDefaultBackend(), maxVoices) {
+}
+
+Engine::Engine(std::unique_ptr<AudioBackend> backend, size_t maxVoices)
+    : audioBackend_(std::move(backend))
+    , sampler_(sampleLibrary_.getTable(), maxVoices) {
+    sampler_.setInstrumentTable(&instruments_);
+    sampler_.setWorkerPool(&renderWorkers_);
 }
 
 Engine::~Engine() {
@@ -12,85 +38,309 @@ Engine::~Engine() {
 }
 
 bool Engine::initialize(const std::string& clientName) {
-    // Initialize JACK
-    if (!audioBackend_.initialize(clientName)) {
+    // The helper threads and the callback can only be replaced while the
+    // callback is not running
+    if (audioBackend_->isActive()) {
+        std::cerr << "Engine already initialized\n";
         return false;
     }
+    renderWorkers_.stop();
+    lookahead_.stop();
     
-    // Set up audio callback
-    audioBackend_.setAudioCallback(
-        [this](jack_nframes_t nframes, float* outL, float* outR) {
+    // Set up audio callback before the backend starts calling it
+    audioBackend_->setAudioCallback(
+        [this](uint32_t nframes, float* outL, float* outR) {
             this->audioCallback(nframes, outL, outR);
         }
     );
     
+    if (!audioBackend_->initialize(clientName)) {
+        return false;
+    }
+    
+    // Recompile the tempo map now that the real sample rate is known
+    publishProject();
+    
+    // Schedule ahead of a real-time clock; stepped backends stay inline
+    if (audioBackend_->isRealtime() && lookaheadMs_ > 0.0) {
+        lookahead_.start(static_cast<uint32_t>(lookaheadMs_ * getSampleRate() / 1000.0));
+    }
+    
+    // Spread voice rendering over helper threads (created by the backend at
+    // its real-time priority where it can)
+    if (audioBackend_->isRealtime() && renderThreads_ > 0) {
+        renderWorkers_.start(renderThreads_, audioBackend_.get());
+    }
+    
     return true;
 }
 
+void Engine::initializeOffline(uint32_t sampleRate) {
+    setAudioBackend(std::make_unique<NullAudioBackend>(sampleRate));
+    initialize("offline");
+}
+
+void Engine::setAudioBackend(std::unique_ptr<AudioBackend> backend) {
+    audioBackend_->shutdown();
+    lookahead_.stop();
+    renderWorkers_.stop();
+    processCommands();  // No audio thread any more: apply what it left queued
+    audioBackend_ = std::move(backend);
+}
+
 void Engine::shutdown() {
     stopPlayback();
-    audioBackend_.shutdown();
+    audioBackend_->shutdown();
+    lookahead_.stop();
+    renderWorkers_.stop();
+    processCommands();
 }
 
-void Engine::triggerSample(std::shared_ptr<Sample> sample, float velocity,
-                           float gain, float pan) {
-    sampler_.noteOn(sample, velocity, gain, pan, 0);
+void Engine::setProject(const Project& project) {
+    project_ = project;
+    timelineCompiled_ = false;
+    publishProject();
 }
 
-void Engine::playPattern(const Pattern* pattern) {
+void Engine::publishProject() {
+    // Patch the event timeline where the project changed since last time
+    changes_.clear();
+    project_.drainChanges(changes_);
+    if (timelineCompiled_) {
+        compiledTimeline_.update(project_, changes_);
+    } else {
+        compiledTimeline_.compile(project_);
+        timelineCompiled_ = true;
+    }
+    auto snapshot = std::make_unique<ProjectSnapshot>(compiledTimeline_, project_.getRevision());
+    
+    // Tempo integration table: only rebuilt when the map or rate changes
+    const uint32_t sampleRate = getSampleRate();
+    if (project_.getTempoMap() != compiledTempoMap_ ||
+        compiledTempo_.getSampleRate() != sampleRate) {
+        compiledTempoMap_ = project_.getTempoMap();
+        compiledTempo_.compile(compiledTempoMap_, sampleRate);
+    }
+    snapshot->tempo = compiledTempo_;
+    
+    snapshots_.publish(std::move(snapshot));
+    
+    // Instrument table: sample paths resolved to handles here, off the
+    // audio thread; instruments no longer in the rack are dropped
+    std::vector<bool> inRack(MAX_INSTRUMENTS, false);
+    for (const auto& instrument : project_.getInstrumentRack().getInstruments()) {
+        if (!instruments_.set(instrument.getId(),
+                              sampleLibrary_.getHandle(instrument.getSamplePath()),
+                              instrument.getGain(), instrument.getPan(),
+                              instrument.getChokeGroup(), instrument.getMaxPolyphony())) {
+            std::cerr << "Instrument " << instrument.getId()
+                     << " is outside the playable id range and will be silent\n";
+            continue;
+        }
+        inRack[static_cast<size_t>(instrument.getId())] = true;
+    }
+    for (int id = 0; id < MAX_INSTRUMENTS; ++id) {
+        if (!inRack[static_cast<size_t>(id)]) {
+            instruments_.remove(id);
+        }
+    }
+    
+    sampleLibrary_.collect();
+}
+
+void Engine::setTempo(double bpm) {
+    project_.getTempoMap().setBpmAt(0, bpm);
+    project_.incrementRevision();
+    publishProject();
+}
+
+void Engine::setInstrumentGain(int instrumentId, float gain) {
+    if (Instrument* instrument = project_.getInstrumentRack().getInstrument(instrumentId)) {
+        instrument->setGain(gain);
+        instruments_.setGain(instrumentId, gain);
+    }
+}
+
+void Engine::setInstrumentPan(int instrumentId, float pan) {
+    if (Instrument* instrument = project_.getInstrumentRack().getInstrument(instrumentId)) {
+        instrument->setPan(pan);
+        instruments_.setPan(instrumentId, pan);
+    }
+}
+
+CommandId Engine::triggerSample(SampleHandle sample, float velocity,
+                                float gain, float pan) {
+    EngineCommand command;
+    command.type = EngineCommandType::TriggerSample;
+    command.sample = sample;
+    command.velocity = velocity;
+    command.gain = gain;
+    command.pan = pan;
+    return post(command);
+}
+
+CommandId Engine::playPattern(const Pattern* pattern) {
     if (pattern == nullptr) {
-        return;
+        return 0;
     }
     
     std::cout << "Playing pattern: " << pattern->getName() 
               << " (" << pattern->getLengthTicks() << " ticks)\n";
     
-    scheduler_.setPattern(pattern);
-    scheduler_.setLoopLength(pattern->getLengthTicks());
-    scheduler_.setLooping(true);
-    
-    // Reset transport to start
-    transport_.setPosition(0);
-    transport_.play();
-    
-    lastProcessedTick_ = 0;
+    EngineCommand command;
+    command.type = EngineCommandType::PlayPattern;
+    command.pattern = pattern;
+    playRequested_ = true;
+    return post(command);
 }
 
-void Engine::playTimeline() {
+CommandId Engine::playTimeline() {
     std::cout << "Playing timeline from start\n";
     
-    scheduler_.setProject(&project_);
+    // Audio thread binds the scheduler to the newest snapshot's timeline
+    publishProject();
     
-    // Reset transport to start
-    transport_.setPosition(0);
-    transport_.play();
-    
-    lastProcessedTick_ = 0;
+    EngineCommand command;
+    command.type = EngineCommandType::PlayTimeline;
+    command.tick = 0;
+    playRequested_ = true;
+    return post(command);
 }
 
-void Engine::playFromTick(Tick startTick) {
+CommandId Engine::playFromTick(Tick startTick) {
     std::cout << "Playing timeline from tick " << startTick << "\n";
     
-    scheduler_.setProject(&project_);
+    publishProject();
+    
+    EngineCommand command;
+    command.type = EngineCommandType::PlayTimeline;
+    command.tick = startTick;
+    playRequested_ = true;
+    return post(command);
+}
+
+CommandId Engine::stopPlayback() {
+    EngineCommand command;
+    command.type = EngineCommandType::Stop;
+    playRequested_ = false;
+    return post(command);
+}
+
+CommandId Engine::stopTransport() {
+    EngineCommand command;
+    command.type = EngineCommandType::StopTransport;
+    playRequested_ = false;
+    return post(command);
+}
+
+CommandId Engine::locate(Tick tick) {
+    EngineCommand command;
+    command.type = EngineCommandType::Locate;
+    command.tick = tick;
+    return post(command);
+}
+
+EngineStats Engine::getStats() const {
+    EngineStats stats;
+    stats_.snapshot(stats);
+    stats.xruns = audioBackend_->getXrunCount();
+    return stats;
+}
+
+CommandId Engine::resetStats() {
+    EngineCommand command;
+    command.type = EngineCommandType::ResetStats;
+    return post(command);
+}
+
+CommandId Engine::post(EngineCommand command) {
+    command.id = nextCommandId_++;
+    if (nextCommandId_ == 0) {
+        nextCommandId_ = 1;  // 0 means "not posted"
+    }
     
-    // Set transport position
-    transport_.setPosition(startTick);
-    transport_.play();
+    if (!audioBackend_->isActive()) {
+        // No audio thread to race with: apply now, after anything queued
+        processCommands();
+        applyCommand(command);
+        return command.id;
+    }
     
-    lastProcessedTick_ = startTick;
+    if (!commands_.push(command)) {
+        std::cerr << "Engine command queue full, command dropped\n";
+        return 0;
+    }
+    return command.id;
 }
 
-void Engine::stopPlayback() {
-    transport_.stop();
-    scheduler_.clear();
-    sampler_.allNotesOff();
+void Engine::processCommands() {
+    EngineCommand command;
+    while (commands_.pop(command)) {
+        applyCommand(command);
+    }
 }
 
-bool Engine::loadInstrumentSamples() {
-    instrumentSamples_.clear();
+void Engine::applyCommand(const EngineCommand& command) {
+    switch (command.type) {
+    case EngineCommandType::PlayTimeline:
+        timelineMode_ = true;
+        transport_.setPosition(command.tick);
+        transport_.play();
+        lastProcessedTick_ = command.tick;
+        break;
+        
+    case EngineCommandType::PlayPattern:
+        timelineMode_ = false;
+        scheduler_.setPattern(command.pattern);
+        scheduler_.setLoopLength(command.pattern->getLengthTicks());
+        scheduler_.setLooping(true);
+        
+        // Reset transport to start
+        transport_.setPosition(0);
+        transport_.play();
+        lastProcessedTick_ = 0;
+        break;
+        
+    case EngineCommandType::Stop:
+        transport_.stop();
+        timelineMode_ = false;
+        scheduler_.clear();
+        sampler_.allNotesOff();
+        break;
+        
+    case EngineCommandType::StopTransport:
+        transport_.stop();
+        break;
+        
+    case EngineCommandType::Locate:
+        transport_.setPosition(command.tick);
+        lastProcessedTick_ = command.tick;
+        break;
+        
+    case EngineCommandType::TriggerSample:
+        sampler_.noteOn(command.sample, command.velocity, command.gain, command.pan, 0);
+        break;
+        
+    case EngineCommandType::ResetStats:
+        stats_.reset();
+        break;
+    }
     
+    CommandAck ack;
+    ack.id = command.id;
+    ack.type = command.type;
+    ack.rolling = transport_.isRolling();
+    ack.frame = transport_.getState().frame;
+    ack.tick = transport_.getState().tick;
+    acks_.push(ack);  // Dropped if the control thread is not polling
+    completedCommand_.store(command.id, std::memory_order_release);
+}
+
+bool Engine::loadInstrumentSamples() {
     const auto& instruments = project_.getInstrumentRack().getInstruments();
     
+    // Keep going past a failure so every instrument that can play does
+    bool allLoaded = true;
     for (const auto& instrument : instruments) {
         if (instrument.getSamplePath().empty()) {
             std::cerr << "Instrument " << instrument.getId() 
@@ -100,68 +350,135 @@ bool Engine::loadInstrumentSamples() {
         
         auto sample = sampleLibrary_.loadSample(instrument.getSamplePath());
         if (sample) {
-            instrumentSamples_[instrument.getId()] = sample;
             std::cout << "Loaded sample for instrument " << instrument.getId()
                      << ": " << instrument.getName() << "\n";
         } else {
             std::cerr << "Failed to load sample for instrument " 
-                     << instrument.getId() << "\n";
-            return false;
+                     << instrument.getId() << " (" << instrument.getName() << "): "
+                     << instrument.getSamplePath() << "\n";
+            allLoaded = false;
         }
     }
     
-    return true;
+    publishProject();
+    return allLoaded;
 }
 
-std::shared_ptr<Sample> Engine::getSampleForInstrument(int instrumentId) {
-    auto it = instrumentSamples_.find(instrumentId);
-    return (it != instrumentSamples_.end()) ? it->second : nullptr;
-}
-
-void Engine::audioCallback(jack_nframes_t nframes, float* outL, float* outR) {
-    // Update transport (use internal transport for now, JACK sync in Phase 4)
-    transport_.updateInternal(nframes, audioBackend_.getSampleRate());
+void Engine::audioCallback(uint32_t nframes, float* outL, float* outR) {
+    BEATER_TRACE_THREAD("audio");
+    BEATER_TRACE_SCOPE("engine", "Engine::audioCallback");
+    const int64_t blockStartNs = TransportPosition::nowNs();
+    
+    // Samples resolved during this block stay alive until it ends
+    SampleTable::ReadScope sampleScope(sampleLibrary_.getTable());
+    
+    // Adopt the newest project snapshot at the block boundary
+    const ProjectSnapshot* snapshot = snapshots_.acquire();
+    
+    // Convert through the snapshot's tempo map (tempo changes inside this
+    // block land on the right frames)
+    transport_.setTempoTimeline(snapshot != nullptr ? &snapshot->tempo : nullptr);
+    
+    // Control commands take effect on this block's first frame
+    processCommands();
     
-    // Get current state
+    if (timelineMode_ && snapshot != nullptr &&
+        scheduler_.getTimeline() != &snapshot->timeline) {
+        scheduler_.setTimeline(&snapshot->timeline);
+    }
+    
+    // Gain/pan ramps for this block (mixer moves since the last one)
+    instruments_.beginBlock(nframes);
+    
+    const uint32_t sampleRate = getSampleRate();
+    
+    // Transport position at the start of this block
     const auto& state = transport_.getState();
     
+    // Publish it for the UI's playhead
+    TransportPosition position;
+    position.rolling = state.rolling;
+    position.frame = state.frame;
+    position.tick = transport_.getTickPosition();
+    position.bpm = state.bpm;
+    position.sampleRate = sampleRate;
+    position.blockFrames = nframes;
+    position.latencyFrames = audioBackend_->getOutputLatency();
+    position.timestampNs = blockStartNs;
+    position_.store(position);
+    
+    CallbackStats::Block timing;
+    const int64_t schedulingStartNs = TransportPosition::nowNs();
+    timing.transportNs = schedulingStartNs - blockStartNs;
+    
+    // Triggers the lookahead worker has already scheduled for this block
+    LookaheadScheduler::Block block;
+    block.snapshot = snapshot;
+    block.rolling = state.rolling;
+    block.timelineMode = timelineMode_;
+    block.pattern = scheduler_.getPattern();
+    block.loopLength = scheduler_.getLoopLength();
+    block.looping = scheduler_.isLooping();
+    block.bpm = state.bpm;
+    block.sampleRate = sampleRate;
+    block.startFrame = state.frame;
+    block.nframes = nframes;
+    const bool scheduledAhead = lookahead_.takeBlock(block, scheduledEvents_);
+    
     // If transport is rolling, schedule events
     if (state.rolling) {
-        // Calculate tick range for this audio block
-        Tick startTick = state.tick;
-        
-        // Estimate end tick based on frame advancement
-        uint64_t endFrame = state.frame + nframes;
-        Tick endTick = transport_.frameToTick(endFrame, state.bpm, state.sampleRate);
-        
-        // Get events in this range
-        auto events = scheduler_.getEventsInRange(startTick, endTick);
+        // This block covers frames [startFrame, endFrame); take exactly the
+        // ticks whose frame falls inside it so every offset is in range
+        uint64_t startFrame = state.frame;
+        uint64_t endFrame = startFrame + nframes;
+        Tick startTick = transport_.firstTickAtFrame(startFrame);
+        Tick endTick = transport_.firstTickAtFrame(endFrame);
         
-        // Trigger events
-        for (const auto& event : events) {
-            auto sample = getSampleForInstrument(event.instrumentId);
-            if (sample) {
-                // Calculate frame offset within this block
-                uint64_t eventFrame = transport_.tickToFrame(event.tick, state.bpm, state.sampleRate);
-                uint32_t offsetFrames = 0;
-                if (eventFrame >= state.frame && eventFrame < endFrame) {
-                    offsetFrames = static_cast<uint32_t>(eventFrame - state.frame);
-                }
-                
-                // Get instrument settings
-                const auto* instrument = project_.getInstrumentRack().getInstrument(event.instrumentId);
-                float gain = instrument ? instrument->getGain() : 1.0f;
-                float pan = instrument ? instrument->getPan() : 0.0f;
-                
-                sampler_.noteOn(sample, event.velocity, gain, pan, offsetFrames);
+        if (scheduledAhead) {
+            for (const auto& scheduled : scheduledEvents_) {
+                triggerEvent(scheduled.event, static_cast<uint32_t>(scheduled.frame - startFrame));
+            }
+        } else {
+            // Inline: no worker, or it is being re-cued (jump, new snapshot)
+            scheduler_.getEventsInRange(startTick, endTick, blockEvents_);
+            for (const auto& event : blockEvents_) {
+                // Frame offset within this block (sample-accurate start)
+                uint64_t eventFrame = transport_.tickToFrame(event.tick);
+                triggerEvent(event, static_cast<uint32_t>(eventFrame - startFrame));
             }
         }
         
         lastProcessedTick_ = endTick;
     }
     
+    const int64_t transportStartNs = TransportPosition::nowNs();
+    timing.schedulingNs = transportStartNs - schedulingStartNs;
+    timing.voices = sampler_.getActiveVoiceCount();
+    
+    // Advance transport past this block (internal transport; JACK sync later)
+    transport_.updateInternal(nframes, sampleRate);
+    
+    const int64_t renderStartNs = TransportPosition::nowNs();
+    timing.transportNs += renderStartNs - transportStartNs;
+    
     // Render sampler voices
     sampler_.render(outL, outR, nframes);
+    
+    const int64_t blockEndNs = TransportPosition::nowNs();
+    timing.renderingNs = blockEndNs - renderStartNs;
+    timing.totalNs = blockEndNs - blockStartNs;
+    timing.periodNs = static_cast<int64_t>(nframes) * 1000000000 / sampleRate;
+    stats_.record(timing);
+}
+
+void Engine::triggerEvent(const CompiledEvent& event, uint32_t offsetFrames) {
+    InstrumentTable::Trigger trigger;
+    if (instruments_.getTrigger(event.instrumentId, trigger) &&
+        trigger.sample != INVALID_SAMPLE_HANDLE) {
+        sampler_.noteOn(trigger.sample, event.velocity, trigger.gain, trigger.pan,
+                        offsetFrames, event.instrumentId,
+                        trigger.chokeGroup, trigger.maxPolyphony);
+    }
 }
 
 } // namespace beater
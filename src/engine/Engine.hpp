@@ -1,82 +1,222 @@
 #pragma once
 
-#include "engine/JackAudioBackend.hpp"
+#include "engine/AudioBackend.hpp"
+#include "engine/EngineCommand.hpp"
+#include "engine/EngineStats.hpp"
 #include "engine/Sampler.hpp"
+#include "engine/InstrumentTable.hpp"
 #include "engine/SampleLibrary.hpp"
 #include "engine/Transport.hpp"
 #include "engine/Scheduler.hpp"
+#include "engine/LookaheadScheduler.hpp"
+#include "engine/ProjectSnapshot.hpp"
+#include "engine/RenderWorkerPool.hpp"
+#include "engine/SeqLock.hpp"
+#include "engine/SpscQueue.hpp"
 #include "domain/Project.hpp"
+#include <atomic>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 namespace beater {
 
 // Main engine class coordinating audio components
+//
+// Transport and playback control (play, stop, locate, manual triggers) is
+// posted from the control thread as commands through a bounded lock-free
+// queue; the audio thread applies them at the start of its next block and
+// acknowledges each one back. Only the audio thread touches the transport,
+// scheduler and voices. With no audio thread running (backend inactive)
+// commands are applied right away on the calling thread.
 class Engine {
 public:
-    Engine();
+    // maxVoices: sampler polyphony (the voice pool is allocated up front)
+    // Uses JACK when built with it, otherwise a thread-clocked null backend
+    explicit Engine(size_t maxVoices = DEFAULT_MAX_VOICES);
+    explicit Engine(std::unique_ptr<AudioBackend> backend,
+                    size_t maxVoices = DEFAULT_MAX_VOICES);
     ~Engine();
     
-    // Initialize JACK and audio engine
+    // Initialize the audio backend and audio engine
+    // With a real-time backend this also starts the lookahead scheduler
     bool initialize(const std::string& clientName = "beater");
     
+    // Run without an audio device at a fixed sample rate (manual-clock null
+    // backend); the caller drives audioCallback() itself (see OfflineRenderer)
+    void initializeOffline(uint32_t sampleRate);
+    
+    // Replace the audio backend (shuts the current one down first)
+    void setAudioBackend(std::unique_ptr<AudioBackend> backend);
+    
     // Shutdown
     void shutdown();
     
     // Check if engine is running
-    bool isActive() const { return audioBackend_.isActive(); }
+    bool isActive() const { return audioBackend_->isActive(); }
     
     // Get components
-    JackAudioBackend& getAudioBackend() { return audioBackend_; }
+    AudioBackend& getAudioBackend() { return *audioBackend_; }
     Sampler& getSampler() { return sampler_; }
     SampleLibrary& getSampleLibrary() { return sampleLibrary_; }
+    // Audio thread state: read from elsewhere only while no block is running
     Transport& getTransport() { return transport_; }
     Scheduler& getScheduler() { return scheduler_; }
+    InstrumentTable& getInstrumentTable() { return instruments_; }
     
     // Project management
-    void setProject(const Project& project) { project_ = project; }
+    // getProject() is the UI-side working copy; the audio thread only ever
+    // sees immutable snapshots of it, made visible by publishProject()
+    void setProject(const Project& project);
     const Project& getProject() const { return project_; }
     Project& getProject() { return project_; }
     
+    // Snapshot the working copy (and compile its timeline) for the audio
+    // thread. Call from the UI thread after edits; never blocks audio.
+    // Only the timeline chunks named by the project's change journal are
+    // recompiled, and the snapshot shares the rest with the previous one:
+    // an edit costs the events it touches plus one pointer per chunk.
+    void publishProject();
+    
+    // Set the project tempo at tick 0 (later tempo changes are kept, and
+    // so is a ramp starting there)
+    void setTempo(double bpm);
+    
+    // Mixer moves: update the working copy and reach the audio thread at
+    // the next block without publishing a snapshot (smoothed over a block)
+    void setInstrumentGain(int instrumentId, float gain);
+    void setInstrumentPan(int instrumentId, float pan);
+    
+    // How far ahead of the transport the scheduler worker runs (real-time
+    // backends; applies from the next initialize). 0 schedules every block
+    // inline on the audio thread.
+    void setLookahead(double milliseconds) { lookaheadMs_ = milliseconds; }
+    double getLookahead() const { return lookaheadMs_; }
+    LookaheadScheduler& getLookaheadScheduler() { return lookahead_; }
+    
+    // Helper threads sharing voice rendering with the audio thread
+    // (real-time backends; applies from the next initialize). 0 renders
+    // every voice on the audio thread.
+    void setRenderThreads(size_t count) { renderThreads_ = count; }
+    size_t getRenderThreads() const { return renderThreads_; }
+    RenderWorkerPool& getRenderWorkers() { return renderWorkers_; }
+    
     // Get audio info
-    uint32_t getSampleRate() const { return audioBackend_.getSampleRate(); }
-    uint32_t getBufferSize() const { return audioBackend_.getBufferSize(); }
+    uint32_t getSampleRate() const { return audioBackend_->getSampleRate(); }
+    uint32_t getBufferSize() const { return audioBackend_->getBufferSize(); }
+    
+    // Control thread (one only). Each call posts a command and returns its
+    // id, or 0 if nothing was posted (queue full).
     
     // Manual trigger for testing (Phase 2)
-    void triggerSample(std::shared_ptr<Sample> sample, float velocity = 0.8f,
-                      float gain = 1.0f, float pan = 0.0f);
+    // sample: handle from getSampleLibrary().getHandle()
+    CommandId triggerSample(SampleHandle sample, float velocity = 0.8f,
+                            float gain = 1.0f, float pan = 0.0f);
     
     // Pattern playback control (Phase 3)
-    void playPattern(const Pattern* pattern);
-    void stopPlayback();
-    bool isPlaying() const { return transport_.isRolling(); }
+    // The pattern must stay alive (and unedited) while it plays
+    CommandId playPattern(const Pattern* pattern);
+    CommandId stopPlayback();    // Stop and silence all voices
+    CommandId stopTransport();   // Stop, sounding voices ring out
+    
+    // Move the transport without changing whether it rolls
+    CommandId locate(Tick tick);
+    
+    // Playing as last requested by the control thread (the audio thread
+    // follows from its next block)
+    bool isPlaying() const { return playRequested_; }
+    
+    // Control thread: next acknowledgement from the audio thread, in
+    // command order. Acks are dropped while the queue is full, so poll
+    // regularly (or use getCompletedCommand()).
+    bool pollAck(CommandAck& ack) { return acks_.pop(ack); }
+    
+    // Id of the newest command the audio thread has applied (any thread)
+    CommandId getCompletedCommand() const {
+        return completedCommand_.load(std::memory_order_acquire);
+    }
+    
+    // Transport position published by the audio thread at every block
+    // Tear-free from any thread; place a playhead between blocks with
+    // TransportPosition::tickAt(TransportPosition::nowNs())
+    TransportPosition getTransportPosition() const { return position_.load(); }
+    
+    // Callback telemetry: per-phase timing histograms (p50/p99/max), DSP
+    // load and voice counts. Any thread, lock-free; resetStats() clears
+    // them from the next block.
+    EngineStats getStats() const;
+    CommandId resetStats();
     
     // Timeline playback control (Phase 4)
-    void playTimeline();
-    void playFromTick(Tick startTick);
+    CommandId playTimeline();
+    CommandId playFromTick(Tick startTick);
     
-    // Load samples for instruments in project
+    // Load samples for instruments in project (and publish the project so
+    // the audio thread sees them). Tries every instrument; false if any
+    // failed to load (each failure is reported on stderr).
     bool loadInstrumentSamples();
     
-private:
-    // Audio render callback
-    void audioCallback(jack_nframes_t nframes, float* outL, float* outR);
-    
-    // Get sample for instrument ID
-    std::shared_ptr<Sample> getSampleForInstrument(int instrumentId);
+    // Audio render callback: renders one block, mixing into outL/outR
+    // Called by the audio backend; tests drive it directly
+    void audioCallback(uint32_t nframes, float* outL, float* outR);
     
-    JackAudioBackend audioBackend_;
+private:
+    std::unique_ptr<AudioBackend> audioBackend_;
+    RenderWorkerPool renderWorkers_;  // Before sampler_: it renders on them
+    size_t renderThreads_ = RenderWorkerPool::defaultThreadCount();
+    SampleLibrary sampleLibrary_;  // Before sampler_: owns its sample table
+    InstrumentTable instruments_;  // Before sampler_: read while rendering
     Sampler sampler_;
-    SampleLibrary sampleLibrary_;
     Transport transport_;
     Scheduler scheduler_;
     Project project_;
     
-    // Cache: instrument ID -> loaded sample
-    std::unordered_map<int, std::shared_ptr<Sample>> instrumentSamples_;
+    // Project snapshots handed to the audio thread
+    SnapshotExchange snapshots_;
+    
+    // Scheduler worker (pins snapshots_, so declared after it)
+    LookaheadScheduler lookahead_{snapshots_};
+    double lookaheadMs_ = 40.0;
+    
+    // Working copy's timeline, patched from its change journal on publish
+    EventTimeline compiledTimeline_;
+    bool timelineCompiled_ = false;  // False: next publish compiles from scratch
+    std::vector<Change> changes_;    // Drained change records (reused)
+    
+    // Last compiled tempo map, reused while neither it nor the rate changes
+    TempoMap compiledTempoMap_;
+    TempoTimeline compiledTempo_;
+    bool timelineMode_ = false;  // Audio thread: scheduler follows the snapshot's timeline
+    
+    // Control -> audio commands, audio -> control acknowledgements
+    static constexpr size_t COMMAND_QUEUE_CAPACITY = 64;
+    SpscQueue<EngineCommand, COMMAND_QUEUE_CAPACITY> commands_;
+    SpscQueue<CommandAck, COMMAND_QUEUE_CAPACITY> acks_;
+    CommandId nextCommandId_ = 1;              // Control thread
+    bool playRequested_ = false;               // Control thread
+    std::atomic<CommandId> completedCommand_{0};
+    
+    // Events triggered in the current block (preallocated, RT-safe)
+    EventBuffer blockEvents_{MAX_EVENTS_PER_BLOCK};
+    ScheduledBuffer scheduledEvents_{MAX_EVENTS_PER_BLOCK};
     
     // Last processed tick (for event scheduling)
     Tick lastProcessedTick_ = 0;
+    
+    // Start an event's sample at a frame offset into the current block
+    void triggerEvent(const CompiledEvent& event, uint32_t offsetFrames);
+    
+    // Control thread: queue a command (or apply it, with no audio thread)
+    CommandId post(EngineCommand command);
+    
+    // Audio thread, at a block boundary: apply every queued command
+    void processCommands();
+    void applyCommand(const EngineCommand& command);
+    
+    // Audio -> UI transport position, written once per block
+    SeqLock<TransportPosition> position_;
+    
+    // Audio thread timing, recorded once per block
+    CallbackStats stats_;
 };
 
 } // namespace beater
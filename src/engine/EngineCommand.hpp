@@ -0,0 +1,48 @@
+#pragma once
+
+#include "domain/TimeTypes.hpp"
+#include "engine/SampleTable.hpp"
+#include <cstdint>
+
+namespace beater {
+
+class Pattern;
+
+// Sequence number of a posted command (0: not posted, the queue was full)
+using CommandId = uint32_t;
+
+// Transport and playback control, applied by the audio thread
+enum class EngineCommandType : uint8_t {
+    PlayTimeline,   // Roll the timeline from tick
+    PlayPattern,    // Loop pattern from its start
+    Stop,           // Stop the transport and silence every voice
+    StopTransport,  // Stop the transport, let sounding voices ring out
+    Locate,         // Move the transport to tick (rolling or not)
+    TriggerSample,  // Start sample on the first frame of the block
+    ResetStats      // Clear the callback telemetry (Engine::getStats)
+};
+
+// Command posted by the control (UI) thread
+// Applied at the start of the next audio block, so it takes effect exactly
+// on that block's first frame
+struct EngineCommand {
+    EngineCommandType type = EngineCommandType::Stop;
+    CommandId id = 0;
+    Tick tick = 0;                      // PlayTimeline, Locate
+    const Pattern* pattern = nullptr;   // PlayPattern
+    SampleHandle sample = INVALID_SAMPLE_HANDLE;  // TriggerSample
+    float velocity = 0.8f;
+    float gain = 1.0f;
+    float pan = 0.0f;
+};
+
+// Audio -> control thread: a command has been applied
+struct CommandAck {
+    CommandId id = 0;
+    EngineCommandType type = EngineCommandType::Stop;
+    bool rolling = false;   // Transport state after the command
+    uint64_t frame = 0;     // Transport frame it took effect on
+    Tick tick = 0;
+};
+
+} // namespace beater
@@ -0,0 +1,68 @@
+#include "engine/EngineStats.hpp"
+
+namespace beater {
+
+namespace {
+
+uint64_t nonNegative(int64_t ns) {
+    return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+}
+
+} // namespace
+
+void CallbackStats::record(const Block& block) {
+    transport_.record(nonNegative(block.transportNs));
+    scheduling_.record(nonNegative(block.schedulingNs));
+    rendering_.record(nonNegative(block.renderingNs));
+    callback_.record(nonNegative(block.totalNs));
+
+    if (block.periodNs > 0) {
+        const uint64_t load = static_cast<uint64_t>(
+            static_cast<double>(nonNegative(block.totalNs)) * LOAD_SCALE /
+            static_cast<double>(block.periodNs));
+        load_.record(load);
+        lastLoad_.store(load, std::memory_order_relaxed);
+    }
+
+    activeVoices_.store(block.voices, std::memory_order_relaxed);
+    if (block.voices > peakVoices_.load(std::memory_order_relaxed)) {
+        peakVoices_.store(block.voices, std::memory_order_relaxed);
+    }
+}
+
+void CallbackStats::reset() {
+    transport_.reset();
+    scheduling_.reset();
+    rendering_.reset();
+    callback_.reset();
+    load_.reset();
+    lastLoad_.store(0, std::memory_order_relaxed);
+    activeVoices_.store(0, std::memory_order_relaxed);
+    peakVoices_.store(0, std::memory_order_relaxed);
+}
+
+void CallbackStats::snapshot(EngineStats& stats) const {
+    stats.blocks = callback_.getCount();
+    summarize(transport_, stats.transport);
+    summarize(scheduling_, stats.scheduling);
+    summarize(rendering_, stats.rendering);
+    summarize(callback_, stats.callback);
+
+    stats.dspLoad = static_cast<double>(lastLoad_.load(std::memory_order_relaxed)) / LOAD_SCALE;
+    stats.dspLoadP99 = static_cast<double>(load_.getPercentile(99.0)) / LOAD_SCALE;
+    stats.dspLoadMax = static_cast<double>(load_.getMax()) / LOAD_SCALE;
+
+    stats.activeVoices = activeVoices_.load(std::memory_order_relaxed);
+    stats.peakVoices = peakVoices_.load(std::memory_order_relaxed);
+}
+
+void CallbackStats::summarize(const Histogram& histogram, PhaseStats& phase) {
+    constexpr double US_PER_NS = 1e-3;
+    phase.count = histogram.getCount();
+    phase.meanUs = histogram.getMean() * US_PER_NS;
+    phase.p50Us = static_cast<double>(histogram.getPercentile(50.0)) * US_PER_NS;
+    phase.p99Us = static_cast<double>(histogram.getPercentile(99.0)) * US_PER_NS;
+    phase.maxUs = static_cast<double>(histogram.getMax()) * US_PER_NS;
+}
+
+} // namespace beater
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "engine/Histogram.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace beater {
+
+// Timing of one callback phase, in microseconds
+struct PhaseStats {
+    uint64_t count = 0;
+    double meanUs = 0.0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+// Snapshot of the audio callback's telemetry (Engine::getStats)
+struct EngineStats {
+    uint64_t blocks = 0;
+
+    PhaseStats transport;   // Snapshot adoption, commands, transport update
+    PhaseStats scheduling;  // Finding and triggering this block's events
+    PhaseStats rendering;   // Mixing the voices
+    PhaseStats callback;    // The whole callback
+
+    // DSP load: callback time / block period (1.0 = the whole period)
+    double dspLoad = 0.0;   // Latest block
+    double dspLoadP99 = 0.0;
+    double dspLoadMax = 0.0;
+
+    size_t activeVoices = 0;  // After the latest block's triggers
+    size_t peakVoices = 0;
+    uint32_t xruns = 0;       // As counted by the audio backend
+};
+
+// Audio thread side of EngineStats: per-phase histograms of callback times
+// (monotonic clock) plus DSP load and voice counts. Recording is RT-safe;
+// snapshot() may run on any thread at the same time.
+class CallbackStats {
+public:
+    // One block's measurements
+    struct Block {
+        int64_t transportNs = 0;
+        int64_t schedulingNs = 0;
+        int64_t renderingNs = 0;
+        int64_t totalNs = 0;
+        int64_t periodNs = 0;   // nframes / sample rate
+        size_t voices = 0;
+    };
+
+    // Recording thread only (the audio thread, or the caller while it is
+    // stopped)
+    void record(const Block& block);
+    void reset();
+
+    // Any thread; xruns are left to the caller
+    void snapshot(EngineStats& stats) const;
+
+private:
+    static void summarize(const Histogram& histogram, PhaseStats& phase);
+
+    Histogram transport_;
+    Histogram scheduling_;
+    Histogram rendering_;
+    Histogram callback_;
+    Histogram load_;  // Parts per LOAD_SCALE of the block period
+
+    std::atomic<uint64_t> lastLoad_{0};
+    std::atomic<size_t> activeVoices_{0};
+    std::atomic<size_t> peakVoices_{0};
+
+    static constexpr double LOAD_SCALE = 10000.0;
+};
+
+} // namespace beater
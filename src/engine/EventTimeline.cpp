@@ -0,0 +1,248 @@
+#include "engine/EventTimeline.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace beater {
+
+EventTimeline::EventTimeline(const EventTimeline& other)
+    : chunks_(other.chunks_), size_(other.size_), endTick_(other.endTick_) {
+}
+
+EventTimeline& EventTimeline::operator=(const EventTimeline& other) {
+    chunks_ = other.chunks_;
+    size_ = other.size_;
+    endTick_ = other.endTick_;
+    return *this;
+}
+
+void EventTimeline::compile(const Project& project) {
+    endTick_ = 0;
+    patch_.clear();
+
+    for (const auto& track : project.getTracks()) {
+        for (const auto& region : track.getRegions()) {
+            endTick_ = std::max(endTick_, region.getEndTick());
+
+            const Pattern* pattern = project.getPatternLibrary().getPattern(region.getPatternSymbol());
+            if (pattern == nullptr) {
+                continue;
+            }
+
+            appendRegion(region, *pattern, region.getStartTick(), region.getEndTick(), patch_);
+        }
+    }
+
+    // One sort for the whole arrangement; stable so simultaneous hits keep
+    // track/region/note order between compiles
+    std::stable_sort(patch_.begin(), patch_.end());
+
+    // Cut into chunks
+    chunks_.clear();
+    size_ = patch_.size();
+    auto first = patch_.cbegin();
+    while (first != patch_.cend()) {
+        const size_t chunk = chunkIndex(first->tick);
+        const Tick chunkEnd = static_cast<Tick>(chunk + 1) * CHUNK_TICKS;
+        auto last = std::lower_bound(first, patch_.cend(), chunkEnd,
+            [](const CompiledEvent& event, Tick t) {
+                return event.tick < t;
+            });
+        chunks_.resize(chunk + 1);
+        chunks_[chunk] = makeChunk(first, last);
+        first = last;
+    }
+}
+
+void EventTimeline::clear() {
+    chunks_.clear();
+    size_ = 0;
+    endTick_ = 0;
+}
+
+std::vector<CompiledEvent> EventTimeline::getEvents() const {
+    std::vector<CompiledEvent> events;
+    events.reserve(size_);
+    for (const auto& chunk : chunks_) {
+        if (chunk) {
+            events.insert(events.end(), chunk->begin(), chunk->end());
+        }
+    }
+    return events;
+}
+
+size_t EventTimeline::findFirstAt(Tick tick) const {
+    const Cursor cursor = seek(tick);
+    size_t index = cursor.index;
+    for (size_t i = 0; i < cursor.chunk && i < chunks_.size(); ++i) {
+        index += chunks_[i] ? chunks_[i]->size() : 0;
+    }
+    return index;
+}
+
+EventTimeline::Cursor EventTimeline::seek(Tick tick) const {
+    Cursor cursor;
+    cursor.chunk = chunkIndex(tick);
+    if (cursor.chunk < chunks_.size() && chunks_[cursor.chunk]) {
+        const Chunk& events = *chunks_[cursor.chunk];
+        auto it = std::lower_bound(events.begin(), events.end(), tick,
+            [](const CompiledEvent& event, Tick t) {
+                return event.tick < t;
+            });
+        cursor.index = static_cast<size_t>(it - events.begin());
+    }
+    return cursor;
+}
+
+const CompiledEvent* EventTimeline::peek(Cursor& cursor) const {
+    while (cursor.chunk < chunks_.size()) {
+        const Chunk* events = chunks_[cursor.chunk].get();
+        if (events != nullptr && cursor.index < events->size()) {
+            return &(*events)[cursor.index];
+        }
+        ++cursor.chunk;
+        cursor.index = 0;
+    }
+    return nullptr;
+}
+
+void EventTimeline::update(const Project& project, const std::vector<Change>& changes) {
+    endTick_ = 0;
+    for (const auto& track : project.getTracks()) {
+        endTick_ = std::max(endTick_, track.getEndTick());
+    }
+
+    // Chunks whose events may differ: only those holding events before or
+    // after the edit (every event lies before the end of its region)
+    dirtyChunks_.clear();
+    const Tick limit = std::max(static_cast<Tick>(chunks_.size()) * CHUNK_TICKS, endTick_);
+    auto markDirty = [this, limit](Tick start, Tick end) {
+        end = std::min(end, limit);
+        if (start < end) {
+            for (size_t chunk = chunkIndex(start); chunk <= chunkIndex(end - 1); ++chunk) {
+                dirtyChunks_.push_back(chunk);
+            }
+        }
+    };
+
+    for (const auto& change : changes) {
+        switch (change.kind) {
+        case ChangeKind::Reset:
+            compile(project);
+            return;
+        case ChangeKind::RegionAdded:
+        case ChangeKind::RegionRemoved:
+        case ChangeKind::RegionChanged:
+            markDirty(change.oldStart, change.oldEnd);
+            markDirty(change.newStart, change.newEnd);
+            break;
+        case ChangeKind::PatternChanged:
+            // Wherever the pattern is used now (regions that stopped using it
+            // have their own records)
+            for (const auto& track : project.getTracks()) {
+                for (const auto& region : track.getRegions()) {
+                    if (region.getPatternSymbol() == change.target) {
+                        markDirty(region.getStartTick(), region.getEndTick());
+                    }
+                }
+            }
+            break;
+        case ChangeKind::TempoChanged:
+        case ChangeKind::MeterChanged:
+            // Events are placed in ticks: neither moves them
+            break;
+        }
+    }
+
+    // Rebuild each touched chunk once; the others stay shared
+    std::sort(dirtyChunks_.begin(), dirtyChunks_.end());
+    dirtyChunks_.erase(std::unique(dirtyChunks_.begin(), dirtyChunks_.end()), dirtyChunks_.end());
+    for (size_t chunk : dirtyChunks_) {
+        recompileChunk(project, chunk);
+    }
+
+    // No empty chunks at the end
+    while (!chunks_.empty() && !chunks_.back()) {
+        chunks_.pop_back();
+    }
+}
+
+void EventTimeline::recompileChunk(const Project& project, size_t chunk) {
+    const Tick startTick = chunk == 0 ? std::numeric_limits<Tick>::min()
+                                      : static_cast<Tick>(chunk) * CHUNK_TICKS;
+    const Tick endTick = static_cast<Tick>(chunk + 1) * CHUNK_TICKS;
+
+    // Same track/region/note order as compile(), so ties come out identical
+    patch_.clear();
+    for (const auto& track : project.getTracks()) {
+        for (const Region* region : track.getRegionsInRange(startTick, endTick)) {
+            const Pattern* pattern = project.getPatternLibrary().getPattern(region->getPatternSymbol());
+            if (pattern != nullptr) {
+                appendRegion(*region, *pattern, startTick, endTick, patch_);
+            }
+        }
+    }
+    std::stable_sort(patch_.begin(), patch_.end());
+
+    if (chunk >= chunks_.size()) {
+        if (patch_.empty()) {
+            return;
+        }
+        chunks_.resize(chunk + 1);
+    }
+    size_ -= chunks_[chunk] ? chunks_[chunk]->size() : 0;
+    size_ += patch_.size();
+    chunks_[chunk] = makeChunk(patch_.cbegin(), patch_.cend());
+}
+
+std::shared_ptr<const EventTimeline::Chunk> EventTimeline::makeChunk(Chunk::const_iterator first,
+                                                                     Chunk::const_iterator last) {
+    if (first == last) {
+        return nullptr;
+    }
+    return std::make_shared<const Chunk>(first, last);
+}
+
+void EventTimeline::appendRegion(const Region& region, const Pattern& pattern,
+                                 Tick windowStart, Tick windowEnd,
+                                 std::vector<CompiledEvent>& out) {
+    Tick patternLength = pattern.getLengthTicks();
+    const auto& notes = pattern.getNotes();
+    if (patternLength <= 0 || notes.empty()) {
+        return;
+    }
+
+    Tick regionStart = region.getStartTick();
+    Tick regionEnd = region.getEndTick();
+    Tick low = std::max(regionStart, windowStart);
+    Tick high = std::min(regionEnd, windowEnd);
+    if (low >= high) {
+        return;
+    }
+
+    // Skip repeats whose last note (notes are sorted) ends before the window
+    Tick firstRepeat = regionStart;
+    Tick skip = low - regionStart - notes.back().offsetTick;
+    if (skip > 0) {
+        firstRepeat += (skip / patternLength) * patternLength;
+    }
+
+    // Repeat the pattern across the region, truncating the last repeat
+    for (Tick repeatStart = firstRepeat;
+         repeatStart < regionEnd && repeatStart + notes.front().offsetTick < high;
+         repeatStart += patternLength) {
+        for (const auto& note : notes) {
+            Tick eventTick = repeatStart + note.offsetTick;
+            if (eventTick < low || eventTick >= high) {
+                continue;
+            }
+
+            CompiledEvent event;
+            event.tick = eventTick;
+            event.instrumentId = note.instrumentId;
+            event.velocity = note.velocity;
+            out.push_back(event);
+        }
+    }
+}
+
+} // namespace beater
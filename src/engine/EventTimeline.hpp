@@ -0,0 +1,114 @@
+#pragma once
+
+#include "domain/Project.hpp"
+#include "domain/TimeTypes.hpp"
+#include <memory>
+#include <vector>
+
+namespace beater {
+
+// Compiled event ready for scheduling
+struct CompiledEvent {
+    Tick tick;              // Absolute tick position
+    int instrumentId;
+    float velocity;
+
+    bool operator<(const CompiledEvent& other) const {
+        return tick < other.tick;
+    }
+};
+
+// EventTimeline: the whole arrangement flattened into tick-sorted events
+// Compiled off the audio thread; playback only walks it with a cursor
+//
+// The events are stored in immutable chunks of CHUNK_TICKS each, held by
+// shared pointer: copying a timeline (into a project snapshot) shares every
+// chunk, and update() replaces only the chunks an edit touched, so the copy
+// published after an edit costs one pointer per chunk plus the events that
+// actually changed.
+class EventTimeline {
+public:
+    static constexpr Tick CHUNK_TICKS = 4 * 3840;  // Four bars of 4/4
+
+    // Playback position: an event within a chunk
+    struct Cursor {
+        size_t chunk = 0;
+        size_t index = 0;
+    };
+
+    EventTimeline() = default;
+
+    // Copies share the chunks (the update scratch space is not copied)
+    EventTimeline(const EventTimeline& other);
+    EventTimeline& operator=(const EventTimeline& other);
+
+    // Rebuild from all tracks/regions/patterns of a project
+    void compile(const Project& project);
+
+    // Bring the timeline up to date with an edited project by recompiling
+    // only the chunks the change records touched (see Project::drainChanges).
+    // The result equals compile(project) as long as the records cover every
+    // edit since the timeline was last built; a Reset record falls back to
+    // a full compile.
+    void update(const Project& project, const std::vector<Change>& changes);
+
+    // Drop all compiled events
+    void clear();
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // All events in one array (sorted by tick, stable in track/region/note
+    // order). Copies them out: for tests and tools, not for playback.
+    std::vector<CompiledEvent> getEvents() const;
+
+    // End of the last region in the arrangement
+    Tick getEndTick() const { return endTick_; }
+
+    // Index of the first event at or after tick (counts the chunks before it)
+    size_t findFirstAt(Tick tick) const;
+
+    // Chunks: events with ticks in [i * CHUNK_TICKS, (i + 1) * CHUNK_TICKS),
+    // the first also holding any before tick 0; nullptr when empty
+    size_t getChunkCount() const { return chunks_.size(); }
+    const std::vector<CompiledEvent>* getChunk(size_t chunk) const { return chunks_[chunk].get(); }
+
+    // Playback (RT-safe, no allocation): position a cursor on the first
+    // event at or after tick, then read forward with peek()/advance()
+    Cursor seek(Tick tick) const;
+
+    // Event at the cursor (moving it past empty and finished chunks), or
+    // nullptr at the end of the timeline
+    const CompiledEvent* peek(Cursor& cursor) const;
+    void advance(Cursor& cursor) const { ++cursor.index; }
+
+private:
+    using Chunk = std::vector<CompiledEvent>;
+
+    std::vector<std::shared_ptr<const Chunk>> chunks_;
+    size_t size_ = 0;
+    Tick endTick_ = 0;
+
+    // Scratch space for update() (kept to avoid reallocating per edit)
+    std::vector<size_t> dirtyChunks_;
+    Chunk patch_;
+
+    static size_t chunkIndex(Tick tick) {
+        return tick < CHUNK_TICKS ? 0 : static_cast<size_t>(tick / CHUNK_TICKS);
+    }
+
+    // Append the notes of a region (all pattern repeats, clipped to region
+    // bounds) that land in [windowStart, windowEnd), in compile order
+    static void appendRegion(const Region& region, const Pattern& pattern,
+                             Tick windowStart, Tick windowEnd,
+                             std::vector<CompiledEvent>& out);
+
+    // Recompile one chunk from the project
+    void recompileChunk(const Project& project, size_t chunk);
+
+    // Chunk holding a copy of events (nullptr if there are none)
+    static std::shared_ptr<const Chunk> makeChunk(Chunk::const_iterator first,
+                                                  Chunk::const_iterator last);
+};
+
+} // namespace beater
@@ -0,0 +1,43 @@
+#include "engine/FileAudioBackend.hpp"
+#include <iostream>
+
+namespace beater {
+
+FileAudioBackend::FileAudioBackend(const std::string& filepath, AudioFileFormat format,
+                                   uint32_t sampleRate, uint32_t bufferSize, NullClock clock)
+    : NullAudioBackend(sampleRate, bufferSize, clock)
+    , filepath_(filepath)
+    , format_(format) {
+}
+
+FileAudioBackend::~FileAudioBackend() {
+    shutdown();
+}
+
+bool FileAudioBackend::initialize(const std::string& clientName) {
+    if (isActive()) {
+        return false;
+    }
+    
+    if (!writer_.open(filepath_, getSampleRate(), format_)) {
+        std::cerr << "Failed to open " << filepath_ << ": " << writer_.getError() << "\n";
+        return false;
+    }
+    writeError_ = false;
+    
+    return NullAudioBackend::initialize(clientName);
+}
+
+void FileAudioBackend::shutdown() {
+    // Stop the clock before finishing the file it writes to
+    NullAudioBackend::shutdown();
+    writer_.close();
+}
+
+void FileAudioBackend::deliver(const float* left, const float* right, uint32_t nframes) {
+    if (!writer_.write(left, right, nframes)) {
+        writeError_ = true;
+    }
+}
+
+} // namespace beater
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "engine/NullAudioBackend.hpp"
+#include "engine/AudioFileWriter.hpp"
+#include <string>
+
+namespace beater {
+
+// Audio backend that records its output to a file instead of a device
+// Clocked like NullAudioBackend; the file is finished by shutdown().
+class FileAudioBackend : public NullAudioBackend {
+public:
+    FileAudioBackend(const std::string& filepath, AudioFileFormat format,
+                     uint32_t sampleRate = 48000, uint32_t bufferSize = 256,
+                     NullClock clock = NullClock::Manual);
+    ~FileAudioBackend() override;
+    
+    // Opens the file, then starts the clock
+    bool initialize(const std::string& clientName) override;
+    void shutdown() override;
+    
+    const char* getName() const override { return "file"; }
+    
+    // True if any write has failed since initialize()
+    bool hasWriteError() const { return writeError_; }
+    
+protected:
+    void deliver(const float* left, const float* right, uint32_t nframes) override;
+    
+private:
+    std::string filepath_;
+    AudioFileFormat format_;
+    AudioFileWriter writer_;
+    bool writeError_ = false;
+};
+
+} // namespace beater
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace beater {
+
+// Vector with a capacity fixed at construction (RT-safe once built)
+// push_back never reallocates; it refuses items once the buffer is full
+template <typename T>
+class FixedVector {
+public:
+    explicit FixedVector(size_t capacity) : capacity_(capacity) {
+        items_.reserve(capacity);
+    }
+
+    // Returns false (and drops the item) when full
+    bool push_back(const T& item) {
+        if (items_.size() >= capacity_) {
+            return false;
+        }
+        items_.push_back(item);
+        return true;
+    }
+
+    void clear() { items_.clear(); }
+
+    size_t size() const { return items_.size(); }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return items_.empty(); }
+    bool full() const { return items_.size() >= capacity_; }
+
+    T& operator[](size_t index) { return items_[index]; }
+    const T& operator[](size_t index) const { return items_[index]; }
+
+    T* begin() { return items_.data(); }
+    T* end() { return items_.data() + items_.size(); }
+    const T* begin() const { return items_.data(); }
+    const T* end() const { return items_.data() + items_.size(); }
+
+private:
+    std::vector<T> items_;
+    size_t capacity_;
+};
+
+} // namespace beater
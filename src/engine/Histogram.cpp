@@ -0,0 +1,73 @@
+#include "engine/Histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace beater {
+
+void Histogram::record(uint64_t value) {
+    value = std::min(value, MAX_VALUE);
+    bump(buckets_[bucketIndex(value)], 1);
+    bump(count_, 1);
+    bump(sum_, value);
+    if (value > max_.load(std::memory_order_relaxed)) {
+        max_.store(value, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+double Histogram::getMean() const {
+    const uint64_t count = getCount();
+    return count > 0 ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+uint64_t Histogram::getPercentile(double percent) const {
+    // Count from the buckets themselves, so the walk always reaches the rank
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const double clamped = std::min(std::max(percent, 0.0), 100.0);
+    const uint64_t rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketTop(i), getMax());
+        }
+    }
+    return getMax();
+}
+
+size_t Histogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);  // Exact: one bucket per value
+    }
+    // Octave, then one of SUB_BUCKETS linear buckets within it
+    const uint32_t msb = 63u - static_cast<uint32_t>(__builtin_clzll(value));
+    const uint32_t shift = msb - SUB_BUCKET_BITS;
+    return static_cast<size_t>((shift + 1) * SUB_BUCKETS + (value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t Histogram::bucketTop(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const uint64_t shift = index / SUB_BUCKETS - 1;
+    const uint64_t sub = index % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+} // namespace beater
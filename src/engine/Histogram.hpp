@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace beater {
+
+// Log-linear (HDR-style) histogram of non-negative integer values
+//
+// Each power of two is split into SUB_BUCKETS linear buckets, so any
+// recorded value is known to within 1/SUB_BUCKETS (~3%) of itself over the
+// whole range, in a fixed ~9 KB table. One thread records (RT-safe: a few
+// relaxed atomic stores, no allocation); any thread may read while it does,
+// getting a view that is at most a few samples behind.
+class Histogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint32_t MAX_VALUE_BITS = 40;  // Larger values are clamped
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+
+    Histogram() = default;
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    // Recording thread only
+    void record(uint64_t value);
+    void reset();
+
+    // Any thread
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t getMax() const { return max_.load(std::memory_order_relaxed); }
+    double getMean() const;
+
+    // Smallest value at or above which lies no more than (100 - percent)%
+    // of the samples, reported as the top of its bucket (never above the
+    // maximum recorded); 0 when empty
+    uint64_t getPercentile(double percent) const;
+
+private:
+    static constexpr size_t BUCKET_COUNT =
+        (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketTop(size_t index);
+
+    // Written by the recording thread only, so plain load/store suffices
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount,
+                      std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace beater
@@ -0,0 +1,111 @@
+#include "engine/InstrumentTable.hpp"
+
+namespace beater {
+
+InstrumentTable::InstrumentTable()
+    : channels_(new Channel[MAX_INSTRUMENTS]) {
+}
+
+bool InstrumentTable::set(int id, SampleHandle sample, float gain, float pan,
+                          int chokeGroup, int maxPolyphony) {
+    if (id < 0 || id >= MAX_INSTRUMENTS) {
+        return false;
+    }
+
+    Channel& channel = channels_[id];
+    channel.sample.store(sample, std::memory_order_relaxed);
+    channel.gain.store(gain, std::memory_order_relaxed);
+    channel.pan.store(pan, std::memory_order_relaxed);
+    channel.chokeGroup.store(chokeGroup, std::memory_order_relaxed);
+    channel.maxPolyphony.store(maxPolyphony, std::memory_order_relaxed);
+    channel.present.store(true, std::memory_order_release);
+    return true;
+}
+
+void InstrumentTable::setGain(int id, float gain) {
+    if (id >= 0 && id < MAX_INSTRUMENTS) {
+        channels_[id].gain.store(gain, std::memory_order_relaxed);
+    }
+}
+
+void InstrumentTable::setPan(int id, float pan) {
+    if (id >= 0 && id < MAX_INSTRUMENTS) {
+        channels_[id].pan.store(pan, std::memory_order_relaxed);
+    }
+}
+
+void InstrumentTable::remove(int id) {
+    if (id >= 0 && id < MAX_INSTRUMENTS) {
+        channels_[id].present.store(false, std::memory_order_release);
+    }
+}
+
+void InstrumentTable::clear() {
+    for (int id = 0; id < MAX_INSTRUMENTS; ++id) {
+        remove(id);
+    }
+}
+
+void InstrumentTable::beginBlock(uint32_t nframes) {
+    const float perFrame = nframes > 0 ? 1.0f / static_cast<float>(nframes) : 0.0f;
+
+    for (int id = 0; id < MAX_INSTRUMENTS; ++id) {
+        Channel& channel = channels_[id];
+        if (!channel.present.load(std::memory_order_acquire)) {
+            channel.primed = false;
+            continue;
+        }
+
+        float targetL;
+        float targetR;
+        panGains(channel.gain.load(std::memory_order_relaxed),
+                 channel.pan.load(std::memory_order_relaxed), targetL, targetR);
+
+        // A newly seen instrument starts at its target instead of fading in
+        if (!channel.primed) {
+            channel.endL = targetL;
+            channel.endR = targetR;
+            channel.primed = true;
+        }
+
+        channel.ramp.startL = channel.endL;
+        channel.ramp.startR = channel.endR;
+        channel.ramp.stepL = (targetL - channel.endL) * perFrame;
+        channel.ramp.stepR = (targetR - channel.endR) * perFrame;
+        channel.endL = targetL;
+        channel.endR = targetR;
+    }
+}
+
+bool InstrumentTable::getTrigger(int id, Trigger& trigger) const {
+    if (id < 0 || id >= MAX_INSTRUMENTS) {
+        return false;
+    }
+
+    const Channel& channel = channels_[id];
+    if (!channel.present.load(std::memory_order_acquire)) {
+        return false;
+    }
+    trigger.sample = channel.sample.load(std::memory_order_relaxed);
+    trigger.gain = channel.gain.load(std::memory_order_relaxed);
+    trigger.pan = channel.pan.load(std::memory_order_relaxed);
+    trigger.chokeGroup = channel.chokeGroup.load(std::memory_order_relaxed);
+    trigger.maxPolyphony = channel.maxPolyphony.load(std::memory_order_relaxed);
+    return true;
+}
+
+void InstrumentTable::panGains(float gain, float pan, float& gainL, float& gainR) {
+    float panL = 1.0f;
+    float panR = 1.0f;
+    if (pan < 0.0f) {
+        // Pan left: reduce right channel
+        panR = 1.0f + pan;
+    } else if (pan > 0.0f) {
+        // Pan right: reduce left channel
+        panL = 1.0f - pan;
+    }
+    gainL = gain * panL;
+    gainR = gain * panR;
+}
+
+} // namespace beater
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "engine/SampleTable.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace beater {
+
+// Instrument ids the audio thread can play (0..MAX_INSTRUMENTS-1)
+constexpr int MAX_INSTRUMENTS = 256;
+
+// Per-block gain ramp of one instrument: frame i of the block mixes at
+// startL + i * stepL (likewise R), reaching the target at the block end
+struct GainRamp {
+    float startL = 1.0f;
+    float startR = 1.0f;
+    float stepL = 0.0f;
+    float stepR = 0.0f;
+
+    bool isFlat() const { return stepL == 0.0f && stepR == 0.0f; }
+};
+
+// Dense, instrument-id-indexed state for the audio thread
+//
+// Replaces per-event map lookups and rack scans with one array index. The UI
+// thread sets targets through atomics at any time (no snapshot needed for a
+// fader move); the audio thread turns gain/pan into L/R gains once per block
+// and ramps to them sample by sample over that block, so parameter changes
+// land within one block without zipper noise.
+class InstrumentTable {
+public:
+    InstrumentTable();
+
+    InstrumentTable(const InstrumentTable&) = delete;
+    InstrumentTable& operator=(const InstrumentTable&) = delete;
+
+    // UI thread: add or update an instrument; ids outside the table are
+    // rejected (returns false)
+    bool set(int id, SampleHandle sample, float gain, float pan,
+             int chokeGroup, int maxPolyphony);
+    void setGain(int id, float gain);
+    void setPan(int id, float pan);
+    void remove(int id);
+    void clear();
+
+    // Audio thread: compute this block's gain ramps (call once per block,
+    // before triggering or rendering)
+    void beginBlock(uint32_t nframes);
+
+    // Audio thread: trigger settings; false for unknown instruments
+    struct Trigger {
+        SampleHandle sample;
+        float gain;
+        float pan;
+        int chokeGroup;
+        int maxPolyphony;
+    };
+    bool getTrigger(int id, Trigger& trigger) const;
+
+    // Audio thread: ramp for this block, or nullptr for unknown instruments
+    const GainRamp* getRamp(int id) const {
+        if (id < 0 || id >= MAX_INSTRUMENTS || !channels_[id].present.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &channels_[id].ramp;
+    }
+
+    // Linear pan law shared with the sampler's untracked voices:
+    // pan < 0 attenuates the right channel, pan > 0 the left
+    static void panGains(float gain, float pan, float& gainL, float& gainR);
+
+private:
+    struct Channel {
+        // Written by the UI thread
+        std::atomic<bool> present{false};
+        std::atomic<SampleHandle> sample{INVALID_SAMPLE_HANDLE};
+        std::atomic<float> gain{1.0f};
+        std::atomic<float> pan{0.0f};
+        std::atomic<int> chokeGroup{0};
+        std::atomic<int> maxPolyphony{0};
+
+        // Audio thread only
+        bool primed = false;   // Ramps start from the current values once seen
+        float endL = 1.0f;     // L/R gains reached at the end of the last block
+        float endR = 1.0f;
+        GainRamp ramp;
+    };
+
+    std::unique_ptr<Channel[]> channels_;  // MAX_INSTRUMENTS, allocated once
+};
+
+} // namespace beater
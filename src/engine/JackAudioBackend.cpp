@@ -1,4 +1,5 @@
 #include "engine/JackAudioBackend.hpp"
+#include <jack/thread.h>
 #include <iostream>
 #include <cstring>
 
@@ -129,6 +130,34 @@ bool JackAudioBackend::isTransportRolling() const {
     return state == JackTransportRolling;
 }
 
+uint32_t JackAudioBackend::getOutputLatency() const {
+    if (!client_ || !outPortLeft_) {
+        return 0;
+    }
+    jack_latency_range_t range;
+    jack_port_get_latency_range(outPortLeft_, JackPlaybackLatency, &range);
+    return range.max;
+}
+
+bool JackAudioBackend::createRealtimeThread(pthread_t& thread, void* (*function)(void*),
+                                            void* arg) {
+    if (client_ == nullptr) {
+        return false;
+    }
+    return jack_client_create_thread(client_, &thread,
+                                     jack_client_real_time_priority(client_),
+                                     jack_is_realtime(client_), function, arg) == 0;
+}
+
+void JackAudioBackend::joinRealtimeThread(pthread_t thread) {
+    if (client_ != nullptr) {
+        jack_client_stop_thread(client_, thread);
+    } else {
+        // Client already closed: the thread is a plain pthread now
+        pthread_join(thread, nullptr);
+    }
+}
+
 // JACK callback implementations
 
 int JackAudioBackend::processCallback(jack_nframes_t nframes, void* arg) {
@@ -1,39 +1,43 @@
 #pragma once
 
+#include "engine/AudioBackend.hpp"
 #include <jack/jack.h>
 #include <string>
-#include <functional>
 #include <atomic>
 
 namespace beater {
 
-// Callback function type for audio rendering
-// Parameters: nframes, outL, outR
-using AudioCallback = std::function<void(jack_nframes_t, float*, float*)>;
-
 // JACK audio backend for real-time audio output
-class JackAudioBackend {
+class JackAudioBackend : public AudioBackend {
 public:
     JackAudioBackend();
-    ~JackAudioBackend();
+    ~JackAudioBackend() override;
     
     // Initialize JACK client and create ports
-    bool initialize(const std::string& clientName);
+    bool initialize(const std::string& clientName) override;
     
     // Shutdown and cleanup
-    void shutdown();
+    void shutdown() override;
     
     // Check if JACK is running and connected
-    bool isActive() const { return client_ != nullptr; }
-    
-    // Set the audio rendering callback
-    void setAudioCallback(AudioCallback callback) { audioCallback_ = callback; }
+    bool isActive() const override { return client_ != nullptr; }
     
     // Get current sample rate
-    uint32_t getSampleRate() const { return sampleRate_; }
+    uint32_t getSampleRate() const override { return sampleRate_; }
     
     // Get current buffer size
-    jack_nframes_t getBufferSize() const { return bufferSize_; }
+    uint32_t getBufferSize() const override { return bufferSize_; }
+    
+    // Playback latency of the output ports (includes the period buffering)
+    uint32_t getOutputLatency() const override;
+    
+    uint32_t getXrunCount() const override { return xrunCount_.load(std::memory_order_relaxed); }
+    
+    const char* getName() const override { return "jack"; }
+    
+    // Helper threads at the JACK client's real-time priority
+    bool createRealtimeThread(pthread_t& thread, void* (*function)(void*), void* arg) override;
+    void joinRealtimeThread(pthread_t thread) override;
     
     // Get transport state
     jack_position_t getTransportPosition() const;
@@ -51,8 +55,6 @@ private:
     jack_port_t* outPortLeft_ = nullptr;
     jack_port_t* outPortRight_ = nullptr;
     
-    AudioCallback audioCallback_;
-    
     std::atomic<uint32_t> sampleRate_{48000};
     std::atomic<jack_nframes_t> bufferSize_{256};
     std::atomic<uint32_t> xrunCount_{0};
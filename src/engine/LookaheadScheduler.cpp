@@ -0,0 +1,170 @@
+#include "engine/LookaheadScheduler.hpp"
+#include "trace/Trace.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace beater {
+
+LookaheadScheduler::LookaheadScheduler(SnapshotExchange& snapshots)
+    : snapshots_(snapshots) {
+}
+
+LookaheadScheduler::~LookaheadScheduler() {
+    stop();
+}
+
+void LookaheadScheduler::start(uint32_t lookaheadFrames) {
+    stop();
+    lookaheadFrames_ = lookaheadFrames;
+    running_.store(true, std::memory_order_release);
+    worker_ = std::thread([this]() { run(); });
+}
+
+void LookaheadScheduler::stop() {
+    running_.store(false, std::memory_order_release);
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    snapshots_.unpin();
+}
+
+uint64_t LookaheadScheduler::getHorizonFrame() const {
+    const Horizon horizon = horizon_.load();
+    return horizon.generation == cue_.load().generation ? horizon.frame : 0;
+}
+
+bool LookaheadScheduler::sameCue(const Block& block) const {
+    return current_.generation != 0 &&
+           current_.active == block.rolling &&
+           current_.snapshot == block.snapshot &&
+           current_.timelineMode == block.timelineMode &&
+           current_.pattern == block.pattern &&
+           current_.loopLength == block.loopLength &&
+           current_.looping == block.looping &&
+           current_.bpm == block.bpm &&
+           current_.sampleRate == block.sampleRate &&
+           (!block.rolling || block.startFrame == expectedFrame_);  // No jump
+}
+
+bool LookaheadScheduler::takeBlock(const Block& block, ScheduledBuffer& out) {
+    out.clear();
+    const bool running = isRunning();
+    const bool restarted = running && !wasRunning_;
+    wasRunning_ = running;
+    if (!running) {
+        return false;
+    }
+
+    playFrame_.store(block.startFrame, std::memory_order_relaxed);
+    const uint64_t endFrame = block.startFrame + block.nframes;
+
+    // Has the worker scheduled this block for what is playing?
+    const bool cued = !restarted && sameCue(block);
+    bool covered = false;
+    if (cued && block.rolling) {
+        const Horizon horizon = horizon_.load();
+        covered = horizon.generation == current_.generation && horizon.frame >= endFrame;
+    }
+
+    if (!cued || (block.rolling && !covered)) {
+        // Re-cue to continue after this block; anything queued is now stale
+        Cue cue;
+        cue.generation = current_.generation + 1;
+        cue.active = block.rolling;
+        cue.startFrame = endFrame;
+        cue.snapshot = block.snapshot;
+        cue.timelineMode = block.timelineMode;
+        cue.pattern = block.pattern;
+        cue.loopLength = block.loopLength;
+        cue.looping = block.looping;
+        cue.bpm = block.bpm;
+        cue.sampleRate = block.sampleRate;
+        current_ = cue;
+        cue_.store(cue);
+    }
+    expectedFrame_ = block.rolling ? endFrame : block.startFrame;
+
+    // Drop stale triggers, take this block's
+    ScheduledEvent scheduled;
+    while (const ScheduledEvent* next = ring_.peek()) {
+        const bool stale = next->generation != current_.generation ||
+                           next->frame < block.startFrame;
+        if (!stale && (!covered || next->frame >= endFrame)) {
+            break;
+        }
+        ring_.pop(scheduled);
+        if (!stale) {
+            out.push_back(scheduled);  // A full buffer drops the rest, as inline
+        }
+    }
+
+    return covered;
+}
+
+void LookaheadScheduler::run() {
+    BEATER_TRACE_THREAD("lookahead scheduler");
+    // Worker-owned scheduling state (allocation is fine here)
+    Scheduler scheduler;
+    EventBuffer events(MAX_EVENTS_PER_BLOCK);
+    TempoTimeline constantTempo;
+    uint32_t generation = 0;
+    bool configured = false;
+    uint64_t frame = 0;  // Next frame to schedule from
+
+    while (running_.load(std::memory_order_acquire)) {
+        const Cue cue = cue_.load();
+        if (cue.generation != generation) {
+            generation = cue.generation;
+            frame = cue.startFrame;
+            configured = false;
+            horizon_.store({generation, frame});
+        }
+
+        // The snapshot stays alive while pinned; a newer one than the cue's
+        // means the audio thread is about to re-cue
+        const ProjectSnapshot* snapshot = cue.active ? snapshots_.pin() : nullptr;
+        if (cue.active && snapshot == cue.snapshot) {
+            if (!configured) {
+                if (cue.timelineMode) {
+                    scheduler.clear();
+                    if (snapshot != nullptr) {
+                        scheduler.setTimeline(&snapshot->timeline);
+                    }
+                } else {
+                    scheduler.setLoopLength(cue.loopLength);
+                    scheduler.setLooping(cue.looping);
+                    scheduler.setPattern(cue.pattern);
+                }
+                if (snapshot == nullptr) {
+                    constantTempo.compileConstant(cue.bpm, cue.sampleRate);
+                }
+                configured = true;
+            }
+            const TempoTimeline& tempo = snapshot != nullptr ? snapshot->tempo : constantTempo;
+
+            const uint64_t target = playFrame_.load(std::memory_order_relaxed) + lookaheadFrames_;
+            while (frame < target) {
+                const uint64_t end = std::min<uint64_t>(target, frame + CHUNK_FRAMES);
+                scheduler.getEventsInRange(tempo.firstTickAtFrame(frame),
+                                           tempo.firstTickAtFrame(end), events);
+                if (ring_.capacity() - ring_.size() < events.size()) {
+                    break;  // Retry once the audio thread has taken some
+                }
+                for (const CompiledEvent& event : events) {
+                    ScheduledEvent scheduled;
+                    scheduled.frame = tempo.tickToFrame(event.tick);
+                    scheduled.generation = generation;
+                    scheduled.event = event;
+                    ring_.push(scheduled);
+                }
+                frame = end;
+                horizon_.store({generation, frame});
+            }
+        }
+        snapshots_.unpin();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace beater
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "engine/Scheduler.hpp"
+#include "engine/ProjectSnapshot.hpp"
+#include "engine/SeqLock.hpp"
+#include "engine/SpscQueue.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace beater {
+
+// Trigger computed ahead of the audio thread: the event and the transport
+// frame it starts on
+struct ScheduledEvent {
+    uint64_t frame = 0;
+    uint32_t generation = 0;  // Cue it was scheduled under (stale once re-cued)
+    CompiledEvent event{};
+};
+
+using ScheduledBuffer = FixedVector<ScheduledEvent>;
+
+// Lookahead scheduling off the audio thread
+//
+// A worker thread stays a fixed number of frames ahead of the transport,
+// runs its own Scheduler over the current snapshot's timeline (or the loop
+// pattern), converts ticks to frames with the snapshot's tempo and pushes
+// the triggers into a wait-free SPSC ring. The audio thread only pops the
+// triggers that fall inside its block.
+//
+// Every block the audio thread checks the worker is still scheduling what
+// it is playing. A transport jump, a new snapshot (edits, tempo changes),
+// a mode change or a worker that has fallen behind re-cues it: the block
+// is then scheduled inline by the caller, triggers from the old cue are
+// dropped and the worker starts again after the block.
+class LookaheadScheduler {
+public:
+    // What the audio thread is about to play
+    struct Block {
+        const ProjectSnapshot* snapshot = nullptr;  // Adopted for this block
+        bool rolling = false;
+        bool timelineMode = false;
+        const Pattern* pattern = nullptr;  // Pattern mode (loop settings below)
+        Tick loopLength = 0;
+        bool looping = true;
+        double bpm = 120.0;                // Tempo without a snapshot
+        uint32_t sampleRate = 48000;
+        uint64_t startFrame = 0;
+        uint32_t nframes = 0;
+    };
+
+    explicit LookaheadScheduler(SnapshotExchange& snapshots);
+    ~LookaheadScheduler();
+
+    LookaheadScheduler(const LookaheadScheduler&) = delete;
+    LookaheadScheduler& operator=(const LookaheadScheduler&) = delete;
+
+    // Start/stop the worker (non-RT threads); lookahead in frames
+    void start(uint32_t lookaheadFrames);
+    void stop();
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    // Audio thread, once per block: the worker's triggers for the block
+    // into out (cleared first). False when they are not available (worker
+    // stopped, just re-cued or behind): schedule the block inline instead.
+    // RT-safe: no allocation, no locks.
+    bool takeBlock(const Block& block, ScheduledBuffer& out);
+
+    // Furthest frame scheduled under the latest cue; 0 until the worker has
+    // picked it up (tests, diagnostics)
+    uint64_t getHorizonFrame() const;
+
+private:
+    // Audio -> worker: where and what to schedule
+    struct Cue {
+        uint32_t generation = 0;
+        bool active = false;                 // Rolling: schedule from startFrame
+        uint64_t startFrame = 0;
+        const ProjectSnapshot* snapshot = nullptr;
+        bool timelineMode = false;
+        const Pattern* pattern = nullptr;
+        Tick loopLength = 0;
+        bool looping = true;
+        double bpm = 120.0;
+        uint32_t sampleRate = 48000;
+    };
+
+    // Worker -> audio: everything before frame is in the ring
+    struct Horizon {
+        uint32_t generation = 0;
+        uint64_t frame = 0;
+    };
+
+    static constexpr size_t RING_CAPACITY = 2048;
+    static constexpr uint32_t CHUNK_FRAMES = 1024;  // Worker's scheduling step
+
+    void run();
+    bool sameCue(const Block& block) const;
+
+    SnapshotExchange& snapshots_;
+    SpscQueue<ScheduledEvent, RING_CAPACITY> ring_;  // Worker -> audio
+    SeqLock<Cue> cue_;
+    SeqLock<Horizon> horizon_;
+    std::atomic<uint64_t> playFrame_{0};  // Audio thread's latest block start
+    uint32_t lookaheadFrames_ = 0;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+
+    // Audio thread state
+    Cue current_;                  // Last cue given to the worker
+    uint64_t expectedFrame_ = 0;   // Start of the next contiguous block
+    bool wasRunning_ = false;      // Worker (re)started: re-cue
+};
+
+} // namespace beater
@@ -0,0 +1,179 @@
+#include "engine/MixKernels.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BEATER_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace beater {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Scalar (portable fallback, also handles SIMD tails)
+// ----------------------------------------------------------------------------
+
+void mixStereoScalar(const float* srcL, const float* srcR,
+                     float* outL, float* outR, uint32_t nframes,
+                     float gainL, float gainR) {
+    for (uint32_t i = 0; i < nframes; ++i) {
+        outL[i] += srcL[i] * gainL;
+        outR[i] += srcR[i] * gainR;
+    }
+}
+
+#ifdef BEATER_X86_KERNELS
+
+// ----------------------------------------------------------------------------
+// SSE2: 4 frames per step
+// ----------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+void mixStereoSSE2(const float* srcL, const float* srcR,
+                   float* outL, float* outR, uint32_t nframes,
+                   float gainL, float gainR) {
+    const __m128 gl = _mm_set1_ps(gainL);
+    const __m128 gr = _mm_set1_ps(gainR);
+
+    uint32_t i = 0;
+    for (; i + 4 <= nframes; i += 4) {
+        __m128 l = _mm_add_ps(_mm_loadu_ps(outL + i), _mm_mul_ps(_mm_loadu_ps(srcL + i), gl));
+        __m128 r = _mm_add_ps(_mm_loadu_ps(outR + i), _mm_mul_ps(_mm_loadu_ps(srcR + i), gr));
+        _mm_storeu_ps(outL + i, l);
+        _mm_storeu_ps(outR + i, r);
+    }
+
+    mixStereoScalar(srcL + i, srcR + i, outL + i, outR + i, nframes - i, gainL, gainR);
+}
+
+// ----------------------------------------------------------------------------
+// AVX2: 8 frames per step
+// ----------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+void mixStereoAVX2(const float* srcL, const float* srcR,
+                   float* outL, float* outR, uint32_t nframes,
+                   float gainL, float gainR) {
+    const __m256 gl = _mm256_set1_ps(gainL);
+    const __m256 gr = _mm256_set1_ps(gainR);
+
+    uint32_t i = 0;
+    for (; i + 8 <= nframes; i += 8) {
+        __m256 l = _mm256_add_ps(_mm256_loadu_ps(outL + i), _mm256_mul_ps(_mm256_loadu_ps(srcL + i), gl));
+        __m256 r = _mm256_add_ps(_mm256_loadu_ps(outR + i), _mm256_mul_ps(_mm256_loadu_ps(srcR + i), gr));
+        _mm256_storeu_ps(outL + i, l);
+        _mm256_storeu_ps(outR + i, r);
+    }
+
+    // Avoid AVX->SSE transition penalties in the scalar tail
+    _mm256_zeroupper();
+    mixStereoScalar(srcL + i, srcR + i, outL + i, outR + i, nframes - i, gainL, gainR);
+}
+
+// ----------------------------------------------------------------------------
+// AVX-512: 16 frames per step, masked tail
+// ----------------------------------------------------------------------------
+
+__attribute__((target("avx512f")))
+void mixStereoAVX512(const float* srcL, const float* srcR,
+                     float* outL, float* outR, uint32_t nframes,
+                     float gainL, float gainR) {
+    const __m512 gl = _mm512_set1_ps(gainL);
+    const __m512 gr = _mm512_set1_ps(gainR);
+
+    uint32_t i = 0;
+    for (; i + 16 <= nframes; i += 16) {
+        __m512 l = _mm512_add_ps(_mm512_loadu_ps(outL + i), _mm512_mul_ps(_mm512_loadu_ps(srcL + i), gl));
+        __m512 r = _mm512_add_ps(_mm512_loadu_ps(outR + i), _mm512_mul_ps(_mm512_loadu_ps(srcR + i), gr));
+        _mm512_storeu_ps(outL + i, l);
+        _mm512_storeu_ps(outR + i, r);
+    }
+
+    if (i < nframes) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (nframes - i)) - 1u);
+        __m512 l = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, outL + i),
+                                 _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, srcL + i), gl));
+        __m512 r = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, outR + i),
+                                 _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, srcR + i), gr));
+        _mm512_mask_storeu_ps(outL + i, mask, l);
+        _mm512_mask_storeu_ps(outR + i, mask, r);
+    }
+}
+
+#endif // BEATER_X86_KERNELS
+
+const MixKernels SCALAR_KERNELS = {MixIsa::Scalar, "scalar", mixStereoScalar};
+#ifdef BEATER_X86_KERNELS
+const MixKernels SSE2_KERNELS = {MixIsa::SSE2, "sse2", mixStereoSSE2};
+const MixKernels AVX2_KERNELS = {MixIsa::AVX2, "avx2", mixStereoAVX2};
+const MixKernels AVX512_KERNELS = {MixIsa::AVX512, "avx512", mixStereoAVX512};
+#endif
+
+// Highest ISA allowed by the BEATER_SIMD environment variable
+MixIsa isaCap() {
+    const char* env = std::getenv("BEATER_SIMD");
+    if (env == nullptr) {
+        return MixIsa::AVX512;
+    }
+    if (std::strcmp(env, "scalar") == 0) return MixIsa::Scalar;
+    if (std::strcmp(env, "sse2") == 0) return MixIsa::SSE2;
+    if (std::strcmp(env, "avx2") == 0) return MixIsa::AVX2;
+    return MixIsa::AVX512;
+}
+
+const MixKernels* selectKernels() {
+    const MixIsa cap = isaCap();
+    const MixIsa order[] = {MixIsa::AVX512, MixIsa::AVX2, MixIsa::SSE2};
+    for (MixIsa isa : order) {
+        if (static_cast<int>(isa) <= static_cast<int>(cap)) {
+            if (const MixKernels* kernels = mixKernelsFor(isa)) {
+                return kernels;
+            }
+        }
+    }
+    return &SCALAR_KERNELS;
+}
+
+} // namespace
+
+const MixKernels& mixKernels() {
+    // Resolved on first use (a Sampler constructor, not the audio thread),
+    // so callers running in other static initializers get a valid table
+    static const MixKernels* const active = selectKernels();
+    return *active;
+}
+
+void mixStereoRamp(const float* srcL, const float* srcR,
+                   float* outL, float* outR, uint32_t nframes,
+                   float gainL, float gainR, float stepL, float stepR) {
+    for (uint32_t i = 0; i < nframes; ++i) {
+        const float t = static_cast<float>(i);
+        outL[i] += srcL[i] * (gainL + t * stepL);
+        outR[i] += srcR[i] * (gainR + t * stepR);
+    }
+}
+
+const MixKernels* mixKernelsFor(MixIsa isa) {
+#ifdef BEATER_X86_KERNELS
+    // The cpu model is only filled in by a constructor; init in case we run first
+    __builtin_cpu_init();
+#endif
+    switch (isa) {
+        case MixIsa::Scalar:
+            return &SCALAR_KERNELS;
+#ifdef BEATER_X86_KERNELS
+        case MixIsa::SSE2:
+            return __builtin_cpu_supports("sse2") ? &SSE2_KERNELS : nullptr;
+        case MixIsa::AVX2:
+            return __builtin_cpu_supports("avx2") ? &AVX2_KERNELS : nullptr;
+        case MixIsa::AVX512:
+            return __builtin_cpu_supports("avx512f") ? &AVX512_KERNELS : nullptr;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace beater
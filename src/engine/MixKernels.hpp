@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace beater {
+
+// Instruction set a kernel set is written for
+enum class MixIsa {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// Mix a stereo source span into the stereo output with constant gains:
+//   outL[i] += srcL[i] * gainL;  outR[i] += srcR[i] * gainR;
+// No alignment requirements. All kernels use separate multiply and add (no
+// FMA), so every ISA produces bit-identical output.
+using MixStereoFn = void (*)(const float* srcL, const float* srcR,
+                             float* outL, float* outR, uint32_t nframes,
+                             float gainL, float gainR);
+
+// One set of mixing kernels for a given ISA
+struct MixKernels {
+    MixIsa isa;
+    const char* name;
+    MixStereoFn mixStereo;
+};
+
+// Mix with a per-frame linear gain ramp (fades; short spans, scalar only):
+//   outL[i] += srcL[i] * (gainL + i * stepL);  likewise for R
+void mixStereoRamp(const float* srcL, const float* srcR,
+                   float* outL, float* outR, uint32_t nframes,
+                   float gainL, float gainR, float stepL, float stepR);
+
+// Kernels for the best ISA this CPU supports, picked once at startup by cpuid
+// BEATER_SIMD=scalar|sse2|avx2|avx512 caps the choice (debugging/benchmarks)
+const MixKernels& mixKernels();
+
+// Kernels for a specific ISA, or nullptr if the build or CPU lacks it
+const MixKernels* mixKernelsFor(MixIsa isa);
+
+} // namespace beater
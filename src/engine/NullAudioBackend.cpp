@@ -0,0 +1,88 @@
+#include "engine/NullAudioBackend.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace beater {
+
+NullAudioBackend::NullAudioBackend(uint32_t sampleRate, uint32_t bufferSize, NullClock clock)
+    : sampleRate_(sampleRate)
+    , bufferSize_(std::max<uint32_t>(bufferSize, 1))
+    , clock_(clock)
+    , outL_(bufferSize_, 0.0f)
+    , outR_(bufferSize_, 0.0f) {
+}
+
+NullAudioBackend::~NullAudioBackend() {
+    shutdown();
+}
+
+bool NullAudioBackend::initialize(const std::string& clientName) {
+    if (isActive()) {
+        std::cerr << "Null audio backend already initialized\n";
+        return false;
+    }
+    
+    framesProcessed_.store(0, std::memory_order_relaxed);
+    active_.store(true, std::memory_order_release);
+    
+    if (clock_ == NullClock::Thread) {
+        thread_ = std::thread(&NullAudioBackend::clockThread, this);
+    }
+    
+    std::cout << "Null audio backend '" << clientName << "' running at "
+              << sampleRate_ << " Hz, " << bufferSize_ << " frames"
+              << (clock_ == NullClock::Manual ? " (manual clock)\n" : "\n");
+    return true;
+}
+
+void NullAudioBackend::shutdown() {
+    active_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void NullAudioBackend::step(uint64_t frames) {
+    if (clock_ != NullClock::Manual || !isActive()) {
+        return;
+    }
+    while (frames > 0) {
+        uint32_t nframes = static_cast<uint32_t>(std::min<uint64_t>(frames, bufferSize_));
+        processBlock(nframes);
+        frames -= nframes;
+    }
+}
+
+void NullAudioBackend::deliver(const float*, const float*, uint32_t) {
+}
+
+void NullAudioBackend::processBlock(uint32_t nframes) {
+    std::fill(outL_.begin(), outL_.begin() + nframes, 0.0f);
+    std::fill(outR_.begin(), outR_.begin() + nframes, 0.0f);
+    
+    if (audioCallback_) {
+        audioCallback_(nframes, outL_.data(), outR_.data());
+    }
+    
+    lastBlockFrames_ = nframes;
+    framesProcessed_.fetch_add(nframes, std::memory_order_relaxed);
+    deliver(outL_.data(), outR_.data(), nframes);
+}
+
+void NullAudioBackend::clockThread() {
+    // One block per buffer period, scheduled against absolute deadlines so
+    // the average rate does not drift
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(bufferSize_) / sampleRate_));
+    
+    auto deadline = Clock::now();
+    while (isActive()) {
+        processBlock(bufferSize_);
+        deadline += period;
+        std::this_thread::sleep_until(deadline);
+    }
+}
+
+} // namespace beater
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "engine/AudioBackend.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace beater {
+
+// How a NullAudioBackend advances time
+enum class NullClock {
+    Manual,   // Only when step() is called (deterministic; tests, offline)
+    Thread    // A thread runs one block per buffer period, like a device
+};
+
+// Audio backend with no device
+// Runs the audio callback into its own buffers, so the engine works without
+// a sound server (CI, headless machines). With the manual clock the caller
+// decides exactly which blocks run, which makes renders reproducible.
+class NullAudioBackend : public AudioBackend {
+public:
+    explicit NullAudioBackend(uint32_t sampleRate = 48000, uint32_t bufferSize = 256,
+                              NullClock clock = NullClock::Manual);
+    ~NullAudioBackend() override;
+    
+    bool initialize(const std::string& clientName) override;
+    void shutdown() override;
+    bool isActive() const override { return active_.load(std::memory_order_acquire); }
+    
+    uint32_t getSampleRate() const override { return sampleRate_; }
+    uint32_t getBufferSize() const override { return bufferSize_; }
+    const char* getName() const override { return "null"; }
+    bool isRealtime() const override { return clock_ == NullClock::Thread; }
+    
+    NullClock getClock() const { return clock_; }
+    
+    // Manual clock: run the callback over this many frames, in buffer-size
+    // blocks (the last one shorter if needed). Ignored while inactive or
+    // when thread clocked.
+    void step(uint64_t frames);
+    
+    // Output of the most recent block (audio thread, or after step())
+    const float* getLeft() const { return outL_.data(); }
+    const float* getRight() const { return outR_.data(); }
+    uint32_t getLastBlockFrames() const { return lastBlockFrames_; }
+    
+    // Frames run through the callback since initialize()
+    uint64_t getFramesProcessed() const { return framesProcessed_.load(std::memory_order_relaxed); }
+    
+protected:
+    // Receives every block after the callback has filled it
+    virtual void deliver(const float* left, const float* right, uint32_t nframes);
+    
+private:
+    void processBlock(uint32_t nframes);
+    void clockThread();
+    
+    const uint32_t sampleRate_;
+    const uint32_t bufferSize_;
+    const NullClock clock_;
+    
+    std::atomic<bool> active_{false};
+    std::atomic<uint64_t> framesProcessed_{0};
+    std::thread thread_;
+    
+    std::vector<float> outL_;
+    std::vector<float> outR_;
+    uint32_t lastBlockFrames_ = 0;
+};
+
+} // namespace beater
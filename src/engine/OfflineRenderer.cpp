@@ -0,0 +1,123 @@
+#include "engine/OfflineRenderer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace beater {
+
+OfflineRenderer::OfflineRenderer(Engine& engine)
+    : engine_(engine) {
+}
+
+Tick OfflineRenderer::projectEndTick(const Project& project) {
+    Tick end = 0;
+    for (const auto& track : project.getTracks()) {
+        for (const auto& region : track.getRegions()) {
+            end = std::max(end, region.getEndTick());
+        }
+    }
+    return end;
+}
+
+bool OfflineRenderer::render(const OfflineRenderOptions& options, const RenderSink& sink) {
+    stats_ = OfflineRenderStats();
+    error_.clear();
+    
+    if (options.sampleRate == 0 || options.blockSize == 0) {
+        error_ = "Sample rate and block size must be nonzero";
+        return false;
+    }
+    
+    const Tick endTick = options.endTick >= 0 ? options.endTick
+                                              : projectEndTick(engine_.getProject());
+    if (endTick <= options.startTick) {
+        error_ = "Nothing to render";
+        return false;
+    }
+    
+    // Frame span of [startTick, endTick) under the project's tempo map
+    engine_.initializeOffline(options.sampleRate);
+    TempoTimeline tempo(engine_.getProject().getTempoMap(), options.sampleRate);
+    const uint64_t musicFrames = tempo.tickToFrame(endTick) - tempo.tickToFrame(options.startTick);
+    const uint64_t tailFrames = static_cast<uint64_t>(
+        std::llround(std::max(0.0, options.tailSeconds) * options.sampleRate));
+    
+    std::vector<float> outL(options.blockSize), outR(options.blockSize);
+    auto renderBlock = [&](uint32_t nframes, bool tail) {
+        std::fill(outL.begin(), outL.begin() + nframes, 0.0f);
+        std::fill(outR.begin(), outR.begin() + nframes, 0.0f);
+        engine_.audioCallback(nframes, outL.data(), outR.data());
+        
+        // Once the last voice has ended, cut the tail at its last sound so
+        // the file length does not depend on the block size
+        if (tail && engine_.getSampler().getActiveVoiceCount() == 0) {
+            while (nframes > 0 && outL[nframes - 1] == 0.0f && outR[nframes - 1] == 0.0f) {
+                --nframes;
+            }
+            if (nframes == 0) {
+                return true;
+            }
+        }
+        
+        stats_.frames += nframes;
+        return sink(outL.data(), outR.data(), nframes);
+    };
+    
+    const auto wallStart = std::chrono::steady_clock::now();
+    bool ok = true;
+    
+    engine_.playFromTick(options.startTick);
+    
+    // Music: exactly the frames of the tick range (a short last block keeps
+    // events at endTick and beyond out)
+    for (uint64_t done = 0; ok && done < musicFrames; ) {
+        uint32_t nframes = static_cast<uint32_t>(
+            std::min<uint64_t>(options.blockSize, musicFrames - done));
+        ok = renderBlock(nframes, false);
+        done += nframes;
+    }
+    
+    // Tail: no new events, let sounding voices finish
+    engine_.stopTransport();
+    for (uint64_t done = 0; ok && done < tailFrames &&
+                            engine_.getSampler().getActiveVoiceCount() > 0; ) {
+        uint32_t nframes = static_cast<uint32_t>(
+            std::min<uint64_t>(options.blockSize, tailFrames - done));
+        ok = renderBlock(nframes, true);
+        done += nframes;
+    }
+    
+    engine_.stopPlayback();
+    
+    stats_.wallSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - wallStart).count();
+    stats_.audioSeconds = static_cast<double>(stats_.frames) / options.sampleRate;
+    
+    if (!ok && error_.empty()) {
+        error_ = "Render aborted";
+    }
+    return ok;
+}
+
+bool OfflineRenderer::renderToFile(const std::string& filepath, AudioFileFormat format,
+                                   const OfflineRenderOptions& options) {
+    AudioFileWriter writer;
+    if (!writer.open(filepath, options.sampleRate, format)) {
+        error_ = "Cannot open " + filepath + ": " + writer.getError();
+        return false;
+    }
+    
+    bool ok = render(options, [&](const float* left, const float* right, uint32_t nframes) {
+        if (!writer.write(left, right, nframes)) {
+            error_ = "Write failed: " + writer.getError();
+            return false;
+        }
+        return true;
+    });
+    
+    writer.close();
+    return ok;
+}
+
+} // namespace beater
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "engine/Engine.hpp"
+#include "engine/AudioFileWriter.hpp"
+#include <functional>
+#include <string>
+
+namespace beater {
+
+// Offline render settings
+struct OfflineRenderOptions {
+    uint32_t sampleRate = 48000;
+    uint32_t blockSize = 256;
+    Tick startTick = 0;
+    Tick endTick = -1;          // -1: end of the last region
+    double tailSeconds = 2.0;   // Longest ring-out after endTick
+};
+
+// Timing of the last render
+struct OfflineRenderStats {
+    uint64_t frames = 0;        // Frames produced, tail included
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+    
+    // How many times faster than realtime the render ran
+    double realtimeFactor() const {
+        return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0;
+    }
+};
+
+// Receives each rendered block in order; return false to abort the render
+using RenderSink = std::function<bool(const float* left, const float* right, uint32_t nframes)>;
+
+// Faster-than-realtime render driver
+//
+// Runs the engine without an audio backend: the same audioCallback() JACK
+// would call is driven in a loop as fast as the CPU allows. The project's
+// region span is rendered exactly, then voices ring out until they fall
+// silent or tailSeconds passes. Output depends only on the project, the
+// samples, and the options, so renders are repeatable bit for bit.
+class OfflineRenderer {
+public:
+    // engine: project set and instrument samples loaded. Rendering swaps
+    // its audio backend for a manual-clock null backend at the render rate.
+    explicit OfflineRenderer(Engine& engine);
+    
+    // Render into a sink
+    bool render(const OfflineRenderOptions& options, const RenderSink& sink);
+    
+    // Render into an audio file
+    bool renderToFile(const std::string& filepath, AudioFileFormat format,
+                      const OfflineRenderOptions& options);
+    
+    const OfflineRenderStats& getStats() const { return stats_; }
+    const std::string& getError() const { return error_; }
+    
+    // End of the last region on any track (0 for an empty project)
+    static Tick projectEndTick(const Project& project);
+    
+private:
+    Engine& engine_;
+    OfflineRenderStats stats_;
+    std::string error_;
+};
+
+} // namespace beater
@@ -0,0 +1,91 @@
+#include "engine/ProjectSnapshot.hpp"
+
+namespace beater {
+
+ProjectSnapshot::ProjectSnapshot(const Project& source)
+    : revision(source.getRevision()) {
+    timeline.compile(source);
+}
+
+ProjectSnapshot::ProjectSnapshot(const EventTimeline& compiled, uint64_t projectRevision)
+    : timeline(compiled), revision(projectRevision) {
+}
+
+SnapshotExchange::~SnapshotExchange() {
+    // Audio (and the pinning thread) must be stopped by now
+    hazard_.store(nullptr, std::memory_order_relaxed);
+    collect();
+    delete pending_.exchange(nullptr, std::memory_order_acq_rel);
+    delete current_.exchange(nullptr, std::memory_order_relaxed);
+}
+
+void SnapshotExchange::publish(std::unique_ptr<ProjectSnapshot> snapshot) {
+    collect();
+
+    ProjectSnapshot* previous = pending_.exchange(snapshot.release(),
+                                                  std::memory_order_acq_rel);
+
+    // The audio thread never saw the snapshot we just replaced
+    delete previous;
+}
+
+void SnapshotExchange::collect() {
+    // Snapshots retired while pinned wait for a later collect
+    const ProjectSnapshot* pinned = hazard_.load(std::memory_order_seq_cst);
+    size_t kept = 0;
+    for (ProjectSnapshot* snapshot : deferred_) {
+        if (snapshot == pinned) {
+            deferred_[kept++] = snapshot;
+        } else {
+            delete snapshot;
+        }
+    }
+    deferred_.resize(kept);
+
+    ProjectSnapshot* retired = nullptr;
+    while (retired_.pop(retired)) {
+        if (retired == hazard_.load(std::memory_order_seq_cst)) {
+            deferred_.push_back(retired);
+        } else {
+            delete retired;
+        }
+    }
+}
+
+const ProjectSnapshot* SnapshotExchange::acquire() {
+    ProjectSnapshot* current = current_.load(std::memory_order_relaxed);
+
+    // Keep the current snapshot if there is nowhere to retire it; the new one
+    // stays pending until the UI has collected
+    if (retired_.full()) {
+        return current;
+    }
+
+    ProjectSnapshot* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+    if (next != nullptr) {
+        // Replace before retiring: a pin that still saw the old snapshot is
+        // then visible to the collect that would free it
+        current_.store(next, std::memory_order_seq_cst);
+        if (current != nullptr) {
+            retired_.push(current);
+        }
+        current = next;
+    }
+
+    return current;
+}
+
+const ProjectSnapshot* SnapshotExchange::pin() {
+    const ProjectSnapshot* snapshot = current_.load(std::memory_order_seq_cst);
+    for (;;) {
+        // Published hazard, then still current: not retired before the hazard
+        hazard_.store(snapshot, std::memory_order_seq_cst);
+        const ProjectSnapshot* again = current_.load(std::memory_order_seq_cst);
+        if (again == snapshot) {
+            return snapshot;
+        }
+        snapshot = again;
+    }
+}
+
+} // namespace beater
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "domain/Project.hpp"
+#include "domain/TempoTimeline.hpp"
+#include "engine/EventTimeline.hpp"
+#include "engine/SpscQueue.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace beater {
+
+// Immutable view of the project as seen by the audio thread: what playback
+// reads, compiled entirely on the publishing thread. The timeline shares its
+// unchanged chunks with the snapshot before it, so publishing after an edit
+// does not copy the arrangement.
+struct ProjectSnapshot {
+    EventTimeline timeline;
+    TempoTimeline tempo;    // Compiled tempo map at the engine's sample rate
+    uint64_t revision = 0;  // Project revision it was built from
+
+    // Compiles the timeline of source
+    explicit ProjectSnapshot(const Project& source);
+
+    // With a timeline already compiled (or patched) for the project
+    ProjectSnapshot(const EventTimeline& compiled, uint64_t projectRevision);
+};
+
+// RCU-style hand-off of project snapshots from the UI to the audio thread
+//
+// The UI publishes with one atomic pointer swap; the audio thread adopts the
+// newest snapshot at a block boundary and hands the one it replaced back
+// through a ring, so snapshots are only ever freed off the RT thread.
+// One more (non-RT) thread may read the current snapshot by pinning it;
+// a pinned snapshot is not freed until it is unpinned.
+class SnapshotExchange {
+public:
+    SnapshotExchange() = default;
+    ~SnapshotExchange();
+
+    SnapshotExchange(const SnapshotExchange&) = delete;
+    SnapshotExchange& operator=(const SnapshotExchange&) = delete;
+
+    // UI thread: make a snapshot visible to the next audio block
+    void publish(std::unique_ptr<ProjectSnapshot> snapshot);
+
+    // UI thread: free snapshots the audio thread has stopped using
+    void collect();
+
+    // Audio thread: adopt the newest published snapshot (if any) and return
+    // the one to use for this block. Wait-free, never frees memory.
+    const ProjectSnapshot* acquire();
+
+    // Audio thread: snapshot adopted by the last acquire()
+    const ProjectSnapshot* current() const { return current_.load(std::memory_order_relaxed); }
+
+    // Pinning thread (one only): the audio thread's current snapshot, kept
+    // alive until unpin() even if the audio thread moves on meanwhile
+    const ProjectSnapshot* pin();
+    void unpin() { hazard_.store(nullptr, std::memory_order_release); }
+
+private:
+    std::atomic<ProjectSnapshot*> pending_{nullptr};
+    std::atomic<ProjectSnapshot*> current_{nullptr};  // Written by the audio thread
+    SpscQueue<ProjectSnapshot*, 16> retired_;         // Audio -> UI
+
+    // Snapshot the pinning thread may be reading (hazard pointer)
+    std::atomic<const ProjectSnapshot*> hazard_{nullptr};
+    std::vector<ProjectSnapshot*> deferred_;  // Retired while pinned (UI thread)
+};
+
+} // namespace beater
@@ -0,0 +1,140 @@
+#include "engine/RenderWorkerPool.hpp"
+#include "engine/AudioBackend.hpp"
+#include "trace/Trace.hpp"
+#include <algorithm>
+#include <cerrno>
+
+namespace beater {
+
+namespace {
+
+constexpr uint64_t TASK_MASK = 0xFFFF;
+
+// Spin-wait hint
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+} // namespace
+
+RenderWorkerPool::~RenderWorkerPool() {
+    stop();
+}
+
+void RenderWorkerPool::start(size_t count, AudioBackend* backend) {
+    stop();
+    backend_ = backend;
+    running_.store(true, std::memory_order_release);
+
+    count = std::min(count, MAX_THREADS);
+    for (size_t i = 0; i < count; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->pool = this;
+        sem_init(&worker->wake, 0, 0);
+        if (backend != nullptr &&
+            backend->createRealtimeThread(worker->native, &RenderWorkerPool::threadEntry,
+                                          worker.get())) {
+            worker->realtime = true;
+        } else {
+            Worker* raw = worker.get();
+            worker->thread = std::thread([raw]() { threadEntry(raw); });
+        }
+        workers_.push_back(std::move(worker));
+    }
+
+    // The audio thread only looks at workers_ once they are all in place
+    threadCount_.store(workers_.size(), std::memory_order_release);
+}
+
+void RenderWorkerPool::stop() {
+    threadCount_.store(0, std::memory_order_release);
+    running_.store(false, std::memory_order_release);
+    for (auto& worker : workers_) {
+        sem_post(&worker->wake);
+    }
+    for (auto& worker : workers_) {
+        if (worker->realtime) {
+            backend_->joinRealtimeThread(worker->native);
+        } else if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        sem_destroy(&worker->wake);
+    }
+    workers_.clear();
+}
+
+void RenderWorkerPool::run(size_t taskCount, TaskFn function, void* context) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    // Publish the job: parameters first, then the claim word
+    function_ = function;
+    context_ = context;
+    pending_.store(taskCount, std::memory_order_relaxed);
+    ++generation_;
+    claim_.store((static_cast<uint64_t>(generation_) << 32) |
+                 (static_cast<uint64_t>(taskCount) << 16), std::memory_order_release);
+
+    // Wake as many helpers as there are tasks beyond our own
+    const size_t helpers = std::min(getThreadCount(), taskCount - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        sem_post(&workers_[i]->wake);
+    }
+
+    // Work alongside them, then wait for tasks still running elsewhere
+    runTasks();
+    while (pending_.load(std::memory_order_acquire) != 0) {
+        cpuRelax();
+    }
+}
+
+size_t RenderWorkerPool::defaultThreadCount() {
+    const unsigned cores = std::thread::hardware_concurrency();
+    return cores > 2 ? std::min<size_t>(3, cores - 2) : 0;
+}
+
+void* RenderWorkerPool::threadEntry(void* arg) {
+    Worker* worker = static_cast<Worker*>(arg);
+    worker->pool->workLoop(*worker);
+    return nullptr;
+}
+
+void RenderWorkerPool::workLoop(Worker& worker) {
+    BEATER_TRACE_THREAD("render worker");
+    for (;;) {
+        while (sem_wait(&worker.wake) != 0 && errno == EINTR) {
+        }
+        if (!running_.load(std::memory_order_acquire)) {
+            return;
+        }
+        runTasks();
+    }
+}
+
+void RenderWorkerPool::runTasks() {
+    uint64_t claim = claim_.load(std::memory_order_acquire);
+    for (;;) {
+        const uint64_t next = claim & TASK_MASK;
+        const uint64_t count = (claim >> 16) & TASK_MASK;
+        if (next >= count) {
+            return;
+        }
+        // Claiming also checks the generation, so a stale view of an
+        // earlier job can never take a task of a newer one
+        if (!claim_.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+            continue;
+        }
+
+        // The job cannot finish while this task is pending: its
+        // parameters are stable
+        function_(context_, static_cast<size_t>(next));
+        pending_.fetch_sub(1, std::memory_order_release);
+        claim = claim_.load(std::memory_order_acquire);
+    }
+}
+
+} // namespace beater
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace beater {
+
+class AudioBackend;
+
+// Helper threads that share the audio callback's rendering work
+//
+// The audio thread hands out a small fork-join job (task i of n) once per
+// block and works on it itself: tasks are claimed from one atomic counter,
+// so a helper that wakes late simply finds nothing left and the block never
+// waits for a thread that has not started. The join is a wait on the count
+// of claimed tasks still running; helpers never block the audio thread.
+class RenderWorkerPool {
+public:
+    // Task function: runs task index of the current job
+    using TaskFn = void (*)(void* context, size_t task);
+
+    static constexpr size_t MAX_THREADS = 8;
+
+    RenderWorkerPool() = default;
+    ~RenderWorkerPool();
+
+    RenderWorkerPool(const RenderWorkerPool&) = delete;
+    RenderWorkerPool& operator=(const RenderWorkerPool&) = delete;
+
+    // Start count helpers (at most MAX_THREADS), replacing any running
+    // ones. They are created through backend at the callback's real-time
+    // priority when it can (JACK), ordinary threads otherwise. Only while
+    // no job can be running (callback stopped): it stops the old helpers.
+    void start(size_t count, AudioBackend* backend);
+
+    // Join the helpers; only while no job can be running (callback stopped)
+    void stop();
+
+    // Helpers ready to take work (0: run everything on the calling thread)
+    size_t getThreadCount() const { return threadCount_.load(std::memory_order_acquire); }
+
+    // Audio thread: run tasks [0, taskCount) across the helpers and the
+    // calling thread, returning once all are done. RT-safe: no allocation,
+    // no locks (waking a helper is a semaphore post).
+    void run(size_t taskCount, TaskFn function, void* context);
+
+    // Helpers worth starting on this machine (leaves cores for the audio
+    // and UI threads)
+    static size_t defaultThreadCount();
+
+private:
+    struct Worker {
+        RenderWorkerPool* pool = nullptr;
+        sem_t wake;
+        bool realtime = false;  // Created by the backend
+        pthread_t native{};
+        std::thread thread;
+    };
+
+    static void* threadEntry(void* arg);
+    void workLoop(Worker& worker);
+
+    // Claim and run tasks of the current job until none are left
+    void runTasks();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    AudioBackend* backend_ = nullptr;
+    std::atomic<size_t> threadCount_{0};
+    std::atomic<bool> running_{false};
+
+    // Current job: written by the audio thread before claim_ publishes it,
+    // stable until its last claimed task has finished
+    TaskFn function_ = nullptr;
+    void* context_ = nullptr;
+    uint32_t generation_ = 0;
+
+    // Generation (high 32 bits), task count (bits 16-31), next task (0-15)
+    std::atomic<uint64_t> claim_{0};
+    std::atomic<size_t> pending_{0};  // Tasks not finished yet
+};
+
+} // namespace beater
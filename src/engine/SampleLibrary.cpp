@@ -1,4 +1,5 @@
 #include "engine/SampleLibrary.hpp"
+#include "trace/Trace.hpp"
 #include <sndfile.h>
 #include <iostream>
 #include <cstring>
@@ -6,9 +7,10 @@
 namespace beater {
 
 std::shared_ptr<Sample> SampleLibrary::loadSample(const std::string& filepath) {
+    BEATER_TRACE_SCOPE("io", "SampleLibrary::loadSample");
     // Check cache first
     if (hasSample(filepath)) {
-        return cache_[filepath];
+        return cache_[filepath].sample;
     }
     
     SF_INFO sfInfo;
@@ -72,14 +74,41 @@ std::shared_ptr<Sample> SampleLibrary::loadSample(const std::string& filepath) {
     std::cout << "Sample loaded successfully: " << sample->lengthFrames << " frames\n";
     
     // Cache the sample
-    cache_[filepath] = sample;
+    insert(filepath, sample);
     
     return sample;
 }
 
+void SampleLibrary::addSample(const std::string& key, std::shared_ptr<Sample> sample) {
+    if (!sample) {
+        unloadSample(key);
+        return;
+    }
+    insert(key, std::move(sample));
+}
+
+void SampleLibrary::insert(const std::string& key, std::shared_ptr<Sample> sample) {
+    // Replacing a sample retires the old table entry; voices still playing
+    // it stop at their next block instead of reading freed memory
+    unloadSample(key);
+    
+    CachedSample& entry = cache_[key];
+    entry.handle = table_.add(sample);
+    entry.sample = std::move(sample);
+    
+    if (entry.handle == INVALID_SAMPLE_HANDLE) {
+        std::cerr << "Sample table full, " << key << " cannot be played\n";
+    }
+}
+
 std::shared_ptr<Sample> SampleLibrary::getSample(const std::string& filepath) {
     auto it = cache_.find(filepath);
-    return (it != cache_.end()) ? it->second : nullptr;
+    return (it != cache_.end()) ? it->second.sample : nullptr;
+}
+
+SampleHandle SampleLibrary::getHandle(const std::string& filepath) const {
+    auto it = cache_.find(filepath);
+    return (it != cache_.end()) ? it->second.handle : INVALID_SAMPLE_HANDLE;
 }
 
 bool SampleLibrary::hasSample(const std::string& filepath) const {
@@ -87,10 +116,18 @@ bool SampleLibrary::hasSample(const std::string& filepath) const {
 }
 
 void SampleLibrary::unloadSample(const std::string& filepath) {
-    cache_.erase(filepath);
+    auto it = cache_.find(filepath);
+    if (it == cache_.end()) {
+        return;
+    }
+    table_.remove(it->second.handle);
+    cache_.erase(it);
 }
 
 void SampleLibrary::clear() {
+    for (const auto& entry : cache_) {
+        table_.remove(entry.second.handle);
+    }
     cache_.clear();
 }
 
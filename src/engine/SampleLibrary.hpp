@@ -1,5 +1,6 @@
 #pragma once
 
+#include "engine/SampleTable.hpp"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -21,6 +22,9 @@ struct Sample {
 };
 
 // Sample library: loads and caches audio samples
+// Every cached sample is also registered in the library's SampleTable, which
+// is how the audio thread refers to it (by handle). Unloading retires the
+// table entry; the buffer is freed once the audio thread has moved on.
 class SampleLibrary {
 public:
     SampleLibrary() = default;
@@ -30,9 +34,15 @@ public:
     // Returns nullptr on failure
     std::shared_ptr<Sample> loadSample(const std::string& filepath);
     
+    // Register an in-memory sample under a key (as if loaded from that path)
+    void addSample(const std::string& key, std::shared_ptr<Sample> sample);
+    
     // Get a cached sample (returns nullptr if not loaded)
     std::shared_ptr<Sample> getSample(const std::string& filepath);
     
+    // Table handle of a cached sample (INVALID_SAMPLE_HANDLE if not loaded)
+    SampleHandle getHandle(const std::string& filepath) const;
+    
     // Check if sample is already loaded
     bool hasSample(const std::string& filepath) const;
     
@@ -45,8 +55,24 @@ public:
     // Get cache size
     size_t getCacheSize() const { return cache_.size(); }
     
+    // Free unloaded samples the audio thread is no longer using
+    void collect() { table_.collect(); }
+    
+    // Handle table read by the audio thread
+    SampleTable& getTable() { return table_; }
+    const SampleTable& getTable() const { return table_; }
+    
 private:
-    std::unordered_map<std::string, std::shared_ptr<Sample>> cache_;
+    struct CachedSample {
+        std::shared_ptr<Sample> sample;
+        SampleHandle handle = INVALID_SAMPLE_HANDLE;
+    };
+    
+    // Cache a sample under a key and publish it to the table
+    void insert(const std::string& key, std::shared_ptr<Sample> sample);
+    
+    SampleTable table_;
+    std::unordered_map<std::string, CachedSample> cache_;
 };
 
 } // namespace beater
@@ -0,0 +1,114 @@
+#include "engine/SampleTable.hpp"
+#include "engine/SampleLibrary.hpp"
+#include <algorithm>
+
+namespace beater {
+
+namespace {
+
+constexpr uint32_t SLOT_BITS = 16;
+constexpr uint32_t SLOT_MASK = (1u << SLOT_BITS) - 1;
+
+} // namespace
+
+SampleTable::SampleTable(size_t capacity)
+    : slots_(new Slot[std::min<size_t>(capacity, SLOT_MASK + 1)]),
+      capacity_(std::min<size_t>(capacity, SLOT_MASK + 1)),
+      owners_(capacity_),
+      generations_(capacity_, 0) {
+    // Hand out low slots first
+    freeSlots_.reserve(capacity_);
+    for (size_t i = capacity_; i > 0; --i) {
+        freeSlots_.push_back(static_cast<uint32_t>(i - 1));
+    }
+}
+
+SampleTable::~SampleTable() {
+    // Audio must be stopped by now; owners_ and retired_ release everything
+}
+
+SampleHandle SampleTable::add(std::shared_ptr<const Sample> sample) {
+    collect();
+
+    if (!sample || freeSlots_.empty()) {
+        return INVALID_SAMPLE_HANDLE;
+    }
+
+    const uint32_t slot = freeSlots_.back();
+    freeSlots_.pop_back();
+
+    // Generation 0 is skipped so no handle is ever 0
+    uint16_t generation = static_cast<uint16_t>(generations_[slot] + 1);
+    if (generation == 0) {
+        generation = 1;
+    }
+    generations_[slot] = generation;
+
+    const SampleHandle handle = (static_cast<uint32_t>(generation) << SLOT_BITS) | slot;
+    slots_[slot].sample.store(sample.get(), std::memory_order_release);
+    slots_[slot].handle.store(handle, std::memory_order_release);
+    owners_[slot] = std::move(sample);
+    return handle;
+}
+
+void SampleTable::remove(SampleHandle handle) {
+    const uint32_t slot = handle & SLOT_MASK;
+    if (handle == INVALID_SAMPLE_HANDLE || slot >= capacity_ ||
+        slots_[slot].handle.load(std::memory_order_relaxed) != handle) {
+        return;
+    }
+
+    // Unpublish, then stamp with a new epoch: a reader entering after the
+    // bump cannot observe the old pointer
+    slots_[slot].handle.store(INVALID_SAMPLE_HANDLE, std::memory_order_seq_cst);
+    slots_[slot].sample.store(nullptr, std::memory_order_seq_cst);
+    const uint64_t epoch = globalEpoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+    retired_.push_back({std::move(owners_[slot]), epoch});
+    owners_[slot].reset();
+    freeSlots_.push_back(slot);
+
+    collect();
+}
+
+void SampleTable::collect() {
+    const uint64_t reader = readerEpoch_.load(std::memory_order_seq_cst);
+    retired_.erase(
+        std::remove_if(retired_.begin(), retired_.end(),
+            [reader](const Retired& r) { return reader == 0 || reader >= r.epoch; }),
+        retired_.end());
+}
+
+const Sample* SampleTable::resolve(SampleHandle handle) const {
+    const uint32_t slot = handle & SLOT_MASK;
+    if (handle == INVALID_SAMPLE_HANDLE || slot >= capacity_) {
+        return nullptr;
+    }
+
+    const Slot& entry = slots_[slot];
+    if (entry.handle.load(std::memory_order_seq_cst) != handle) {
+        return nullptr;
+    }
+    const Sample* sample = entry.sample.load(std::memory_order_seq_cst);
+
+    // The slot may have been removed (and reused) between the two loads
+    if (entry.handle.load(std::memory_order_seq_cst) != handle) {
+        return nullptr;
+    }
+    return sample;
+}
+
+void SampleTable::beginRead() {
+    if (readDepth_++ == 0) {
+        readerEpoch_.store(globalEpoch_.load(std::memory_order_seq_cst),
+                           std::memory_order_seq_cst);
+    }
+}
+
+void SampleTable::endRead() {
+    if (--readDepth_ == 0) {
+        readerEpoch_.store(0, std::memory_order_release);
+    }
+}
+
+} // namespace beater
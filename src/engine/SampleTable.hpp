@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace beater {
+
+struct Sample;
+
+// Reference to a sample in a SampleTable: slot index in the low 16 bits,
+// slot generation in the high 16 bits. 0 is never a valid handle.
+using SampleHandle = uint32_t;
+constexpr SampleHandle INVALID_SAMPLE_HANDLE = 0;
+
+constexpr size_t DEFAULT_SAMPLE_SLOTS = 4096;
+
+// Sample table shared by the loader (UI) thread and the audio thread
+//
+// The audio thread only ever sees handles and resolves them to plain
+// pointers inside a read section; it never touches a refcount or frees
+// memory. Removing a sample retires its buffer with an epoch stamp, and
+// collect() frees it only once the audio thread has left every read section
+// that could still hold the old pointer. Stale handles resolve to nullptr.
+class SampleTable {
+public:
+    explicit SampleTable(size_t capacity = DEFAULT_SAMPLE_SLOTS);
+    ~SampleTable();
+
+    SampleTable(const SampleTable&) = delete;
+    SampleTable& operator=(const SampleTable&) = delete;
+
+    // Loader thread: register a sample; INVALID_SAMPLE_HANDLE if full
+    SampleHandle add(std::shared_ptr<const Sample> sample);
+
+    // Loader thread: unpublish a sample; its memory is freed by a later
+    // collect() once the audio thread can no longer be using it
+    void remove(SampleHandle handle);
+
+    // Loader thread: free retired samples the audio thread has moved past
+    void collect();
+
+    // Loader thread: samples retired but not yet freed
+    size_t getRetiredCount() const { return retired_.size(); }
+
+    // Audio thread: sample for a handle, nullptr if removed or invalid.
+    // The pointer stays valid until the enclosing read section ends.
+    const Sample* resolve(SampleHandle handle) const;
+
+    // Audio thread: bracket all resolve() calls and uses of the pointers
+    // (nestable; wait-free)
+    void beginRead();
+    void endRead();
+
+    class ReadScope {
+    public:
+        explicit ReadScope(SampleTable& table) : table_(table) { table_.beginRead(); }
+        ~ReadScope() { table_.endRead(); }
+
+        ReadScope(const ReadScope&) = delete;
+        ReadScope& operator=(const ReadScope&) = delete;
+
+    private:
+        SampleTable& table_;
+    };
+
+private:
+    struct Slot {
+        std::atomic<const Sample*> sample{nullptr};
+        std::atomic<SampleHandle> handle{INVALID_SAMPLE_HANDLE};
+    };
+
+    struct Retired {
+        std::shared_ptr<const Sample> sample;
+        uint64_t epoch;  // Safe to free once the reader is idle or past this
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_;
+
+    // Loader thread only
+    std::vector<std::shared_ptr<const Sample>> owners_;  // Per slot
+    std::vector<uint16_t> generations_;                  // Per slot
+    std::vector<uint32_t> freeSlots_;
+    std::vector<Retired> retired_;
+
+    // Epoch reclamation (single reader: the audio thread)
+    std::atomic<uint64_t> globalEpoch_{1};
+    std::atomic<uint64_t> readerEpoch_{0};  // 0 = outside any read section
+    uint32_t readDepth_ = 0;                // Audio thread only
+};
+
+} // namespace beater
@@ -1,114 +1,450 @@
 #include "engine/Sampler.hpp"
+#include "trace/Trace.hpp"
 #include <algorithm>
 #include <cmath>
 
 namespace beater {
 
-Sampler::Sampler() {
-    // Initialize all voices as inactive
-    for (auto& voice : voices_) {
-        voice.reset();
-    }
+Sampler::Sampler(SampleTable& table, size_t maxVoices)
+    : table_(table),
+      voices_(std::max<size_t>(maxVoices, 1) + STEAL_FADE_SLOTS),
+      maxVoices_(std::max<size_t>(maxVoices, 1)),
+      kernels_(&mixKernels()),
+      maskWords_((voices_.size() + 63) / 64),
+      chokeMasks_((MAX_CHOKE_GROUPS + 1) * maskWords_, 0) {
+    resetPool();
 }
 
-void Sampler::noteOn(std::shared_ptr<Sample> sample, float velocity,
-                     float gain, float pan, uint32_t offsetFrames) {
-    if (sample == nullptr || sample->lengthFrames == 0) {
+void Sampler::noteOn(SampleHandle sample, float velocity,
+                     float gain, float pan, uint32_t offsetFrames,
+                     int instrumentId, int chokeGroup, int maxPolyphony) {
+    SampleTable::ReadScope readScope(table_);
+    const Sample* data = table_.resolve(sample);
+    if (data == nullptr || data->lengthFrames == 0) {
         return;
     }
-    
-    Voice* voice = allocateVoice();
+
+    if (chokeGroup < 0 || chokeGroup > MAX_CHOKE_GROUPS) {
+        chokeGroup = 0;
+    }
+
+    // Silence what this hit replaces before looking for a voice, so chokes
+    // and per-instrument limits free up room instead of forcing a steal
+    if (chokeGroup > 0) {
+        chokeVoices(chokeGroup, offsetFrames);
+    }
+    if (maxPolyphony > 0 && instrumentId >= 0) {
+        limitPolyphony(instrumentId, maxPolyphony, offsetFrames);
+    }
+
+    Voice* voice = allocateVoice(instrumentId, offsetFrames);
     if (voice == nullptr) {
-        // No free voices available (voice stealing could be implemented here)
+        // At the polyphony limit with stealing disabled
         return;
     }
-    
+
     // Initialize voice
     voice->sample = sample;
+    voice->lengthFrames = data->lengthFrames;
     voice->playbackPosition = 0;
     voice->velocity = velocity;
     voice->gain = gain;
     voice->pan = pan;
+    voice->startOffset = offsetFrames;
+    voice->instrumentId = instrumentId;
+    voice->chokeGroup = chokeGroup;
     voice->active = true;
-    
-    // Note: offsetFrames is stored for sample-accurate triggering
-    // For now, we trigger immediately at the start of the block
-    (void)offsetFrames;  // Suppress unused warning for MVP
+    setChokeBit(*voice, static_cast<int32_t>(voice - voices_.data()), true);
 }
 
 void Sampler::allNotesOff() {
-    for (auto& voice : voices_) {
-        voice.reset();
+    resetPool();
+}
+
+void Sampler::setWorkerPool(RenderWorkerPool* pool) {
+    pool_ = pool;
+    if (pool_ == nullptr) {
+        return;
     }
+    renderList_.assign(voices_.size(), -1);
+    renderSamples_.assign(voices_.size(), nullptr);
+    renderAlive_.assign(voices_.size(), 0);
+    partials_.assign(RenderWorkerPool::MAX_THREADS * 2 * MAX_PARALLEL_BLOCK_FRAMES, 0.0f);
 }
 
 void Sampler::render(float* outL, float* outR, uint32_t nframes) {
-    // Render all active voices
-    for (auto& voice : voices_) {
-        if (voice.active) {
-            renderVoice(voice, outL, outR, 0, nframes);
+    BEATER_TRACE_SCOPE("engine", "Sampler::render");
+    SampleTable::ReadScope readScope(table_);
+    
+    const size_t stripes = stripesFor(nframes);
+    if (stripes > 1) {
+        renderParallel(outL, outR, nframes, stripes);
+        return;
+    }
+    
+    // Render all active voices, oldest first
+    int32_t index = activeHead_;
+    while (index >= 0) {
+        Voice& voice = voices_[index];
+        const int32_t next = voice.next;
+        const Sample* sample = table_.resolve(voice.sample);
+        if (sample == nullptr || !renderVoice(voice, *sample, outL, outR, 0, nframes)) {
+            releaseVoice(index);
         }
+        index = next;
     }
 }
 
-size_t Sampler::getActiveVoiceCount() const {
+size_t Sampler::stripesFor(uint32_t nframes) const {
+    if (pool_ == nullptr || nframes > MAX_PARALLEL_BLOCK_FRAMES) {
+        return 1;
+    }
+    // The calling thread takes a stripe too
+    const size_t threads = pool_->getThreadCount() + 1;
+    return std::max<size_t>(1, std::min(threads, activeCount_ / MIN_VOICES_PER_STRIPE));
+}
+
+void Sampler::renderParallel(float* outL, float* outR, uint32_t nframes, size_t stripes) {
+    // Flatten the active list and resolve every sample here: the stripes
+    // only ever touch their own voices
     size_t count = 0;
-    for (const auto& voice : voices_) {
-        if (voice.active) {
-            ++count;
+    for (int32_t index = activeHead_; index >= 0; index = voices_[index].next) {
+        renderList_[count] = index;
+        renderSamples_[count] = table_.resolve(voices_[index].sample);
+        ++count;
+    }
+
+    stripeOutL_ = outL;
+    stripeOutR_ = outR;
+    stripeFrames_ = nframes;
+    stripeVoices_ = count;
+    stripeCount_ = stripes;
+    pool_->run(stripes, &Sampler::renderStripe, this);
+
+    // Sum the partial buffers (a gain of 1 keeps the adds exact)
+    for (size_t stripe = 1; stripe < stripes; ++stripe) {
+        kernels_->mixStereo(partialLeft(stripe), partialRight(stripe), outL, outR,
+                            nframes, 1.0f, 1.0f);
+    }
+
+    // List bookkeeping back on this thread
+    for (size_t i = 0; i < count; ++i) {
+        if (!renderAlive_[i]) {
+            releaseVoice(renderList_[i]);
         }
     }
-    return count;
 }
 
-Voice* Sampler::allocateVoice() {
-    // Find first inactive voice
-    for (auto& voice : voices_) {
-        if (!voice.active) {
-            return &voice;
+void Sampler::renderStripe(void* context, size_t stripe) {
+    BEATER_TRACE_SCOPE("engine", "Sampler::renderStripe");
+    Sampler& sampler = *static_cast<Sampler*>(context);
+    const uint32_t nframes = sampler.stripeFrames_;
+    const size_t begin = sampler.stripeVoices_ * stripe / sampler.stripeCount_;
+    const size_t end = sampler.stripeVoices_ * (stripe + 1) / sampler.stripeCount_;
+
+    float* outL = sampler.stripeOutL_;
+    float* outR = sampler.stripeOutR_;
+    if (stripe > 0) {
+        outL = sampler.partialLeft(stripe);
+        outR = sampler.partialRight(stripe);
+        std::fill(outL, outL + nframes, 0.0f);
+        std::fill(outR, outR + nframes, 0.0f);
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        Voice& voice = sampler.voices_[sampler.renderList_[i]];
+        const Sample* sample = sampler.renderSamples_[i];
+        sampler.renderAlive_[i] = sample != nullptr &&
+                                  sampler.renderVoice(voice, *sample, outL, outR, 0, nframes);
+    }
+}
+
+size_t Sampler::getActiveVoiceCount() const {
+    return activeCount_;
+}
+
+Voice* Sampler::allocateVoice(int instrumentId, uint32_t offsetFrames) {
+    if (soundingCount_ >= maxVoices_) {
+        const int32_t victim = findVictim(instrumentId);
+        if (victim < 0) {
+            return nullptr;
+        }
+        // Fade out in a reserve slot instead of cutting (which would click)
+        beginFade(victim, offsetFrames);
+    }
+
+    int32_t index = freeHead_;
+    if (index < 0) {
+        // Every reserve slot is fading: cut the fade closest to silence
+        int32_t quietest = -1;
+        for (int32_t i = activeHead_; i >= 0; i = voices_[i].next) {
+            if (voices_[i].isFading() &&
+                (quietest < 0 || voices_[i].fadeRemaining < voices_[quietest].fadeRemaining)) {
+                quietest = i;
+            }
+        }
+        if (quietest < 0) {
+            return nullptr;
         }
+        releaseVoice(quietest);
+        index = freeHead_;
     }
-    return nullptr;  // No free voices
+
+    // Pop from the free list, append to the active list (newest last)
+    Voice& voice = voices_[index];
+    freeHead_ = voice.next;
+    voice.prev = activeTail_;
+    voice.next = -1;
+    if (activeTail_ >= 0) {
+        voices_[activeTail_].next = index;
+    } else {
+        activeHead_ = index;
+    }
+    activeTail_ = index;
+
+    ++activeCount_;
+    ++soundingCount_;
+    return &voice;
 }
 
-void Sampler::renderVoice(Voice& voice, float* outL, float* outR,
-                          uint32_t startFrame, uint32_t nframes) {
-    if (!voice.active || voice.sample == nullptr) {
+int32_t Sampler::findVictim(int instrumentId) const {
+    const StealPolicy policy = stealPolicy_.load(std::memory_order_relaxed);
+    if (policy == StealPolicy::None) {
+        return -1;
+    }
+
+    int32_t oldest = -1;
+    int32_t quietest = -1;
+    float quietestLevel = 0.0f;
+
+    // The active list is in start order, so the first match is the oldest
+    for (int32_t i = activeHead_; i >= 0; i = voices_[i].next) {
+        const Voice& voice = voices_[i];
+        if (voice.isFading()) {
+            continue;
+        }
+
+        if (oldest < 0) {
+            oldest = i;
+            if (policy == StealPolicy::Oldest) {
+                break;
+            }
+        }
+
+        if (policy == StealPolicy::SameInstrumentFirst) {
+            if (instrumentId >= 0 && voice.instrumentId == instrumentId) {
+                return i;
+            }
+        } else if (policy == StealPolicy::Quietest) {
+            // One-shot drum samples decay over their length, so the
+            // remaining fraction stands in for the envelope
+            const float remaining = 1.0f - static_cast<float>(voice.playbackPosition) /
+                                           static_cast<float>(voice.lengthFrames);
+            const float level = voice.velocity * voice.gain * remaining;
+            if (quietest < 0 || level < quietestLevel) {
+                quietest = i;
+                quietestLevel = level;
+            }
+        }
+    }
+
+    return policy == StealPolicy::Quietest ? quietest : oldest;
+}
+
+void Sampler::chokeVoices(int group, uint32_t offsetFrames) {
+    // Only the group's own voices are visited
+    uint64_t* mask = chokeMask(group);
+    for (size_t word = 0; word < maskWords_; ++word) {
+        uint64_t bits = mask[word];
+        while (bits != 0) {
+            const int bit = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            beginFade(static_cast<int32_t>(word * 64 + bit), offsetFrames);
+        }
+    }
+}
+
+void Sampler::limitPolyphony(int instrumentId, int maxPolyphony, uint32_t offsetFrames) {
+    // Count sounding voices of this instrument, newest first, and fade out
+    // everything past maxPolyphony - 1 to leave room for the new hit
+    int count = 0;
+    for (int32_t i = activeTail_; i >= 0;) {
+        const int32_t prev = voices_[i].prev;
+        if (!voices_[i].isFading() && voices_[i].instrumentId == instrumentId) {
+            if (++count >= maxPolyphony) {
+                beginFade(i, offsetFrames);
+            }
+        }
+        i = prev;
+    }
+}
+
+void Sampler::beginFade(int32_t index, uint32_t offsetFrames) {
+    Voice& voice = voices_[index];
+    if (voice.isFading()) {
         return;
     }
-    
-    const auto& sample = voice.sample;
-    const float* sampleL = sample->dataLeft.data();
-    const float* sampleR = sample->dataRight.data();
-    
-    // Calculate pan gains
-    float panL = 1.0f;
-    float panR = 1.0f;
-    if (voice.pan < 0.0f) {
-        // Pan left: reduce right channel
-        panR = 1.0f + voice.pan;
-    } else if (voice.pan > 0.0f) {
-        // Pan right: reduce left channel
-        panL = 1.0f - voice.pan;
+
+    if (voice.playbackPosition == 0 && voice.startOffset >= offsetFrames) {
+        // Would not be heard before the fade starts: nothing to fade
+        releaseVoice(index);
+        return;
     }
-    
-    const float gainL = voice.velocity * voice.gain * panL;
-    const float gainR = voice.velocity * voice.gain * panR;
-    
-    // Render frames
-    for (uint32_t i = startFrame; i < nframes; ++i) {
-        if (voice.playbackPosition >= sample->lengthFrames) {
-            // Sample finished
-            voice.reset();
-            return;
+
+    setChokeBit(voice, index, false);
+    voice.fadeRemaining = STEAL_FADE_FRAMES;
+    voice.fadeDelay = offsetFrames;
+    --soundingCount_;
+}
+
+void Sampler::releaseVoice(int32_t index) {
+    Voice& voice = voices_[index];
+    if (!voice.isFading()) {
+        --soundingCount_;
+    }
+    --activeCount_;
+    setChokeBit(voice, index, false);
+
+    // Unlink from the active list
+    if (voice.prev >= 0) {
+        voices_[voice.prev].next = voice.next;
+    } else {
+        activeHead_ = voice.next;
+    }
+    if (voice.next >= 0) {
+        voices_[voice.next].prev = voice.prev;
+    } else {
+        activeTail_ = voice.prev;
+    }
+
+    // Push onto the free list
+    voice.reset();
+    voice.prev = -1;
+    voice.next = freeHead_;
+    freeHead_ = index;
+}
+
+void Sampler::resetPool() {
+    const int32_t count = static_cast<int32_t>(voices_.size());
+    for (int32_t i = 0; i < count; ++i) {
+        voices_[i].reset();
+        voices_[i].prev = -1;
+        voices_[i].next = i + 1 < count ? i + 1 : -1;
+    }
+    freeHead_ = count > 0 ? 0 : -1;
+    activeHead_ = -1;
+    activeTail_ = -1;
+    activeCount_ = 0;
+    soundingCount_ = 0;
+    std::fill(chokeMasks_.begin(), chokeMasks_.end(), 0);
+}
+
+void Sampler::setChokeBit(const Voice& voice, int32_t index, bool set) {
+    if (voice.chokeGroup <= 0) {
+        return;
+    }
+    uint64_t& word = chokeMask(voice.chokeGroup)[index / 64];
+    const uint64_t bit = uint64_t(1) << (index % 64);
+    word = set ? (word | bit) : (word & ~bit);
+}
+
+bool Sampler::renderVoice(Voice& voice, const Sample& sample, float* outL, float* outR,
+                          uint32_t startFrame, uint32_t nframes) {
+    if (!voice.active) {
+        return false;
+    }
+
+    // Gains across this block: the instrument's smoothed ramp, or the
+    // trigger-time gain/pan for voices not tied to an instrument
+    GainRamp gain;
+    const GainRamp* ramp = (instruments_ != nullptr && voice.instrumentId >= 0)
+        ? instruments_->getRamp(voice.instrumentId) : nullptr;
+    if (ramp != nullptr) {
+        gain.startL = voice.velocity * ramp->startL;
+        gain.startR = voice.velocity * ramp->startR;
+        gain.stepL = voice.velocity * ramp->stepL;
+        gain.stepR = voice.velocity * ramp->stepR;
+    } else {
+        InstrumentTable::panGains(voice.velocity * voice.gain, voice.pan, gain.startL, gain.startR);
+    }
+
+    // Newly triggered voices start at their offset within the block
+    uint32_t frame = startFrame;
+    if (voice.startOffset > 0) {
+        if (voice.startOffset >= nframes) {
+            // Trigger lies beyond this block
+            voice.startOffset -= nframes;
+            if (voice.isFading()) {
+                voice.fadeDelay -= std::min(voice.fadeDelay, nframes);
+            }
+            return true;
+        }
+        frame = std::max(frame, voice.startOffset);
+        voice.startOffset = 0;
+    }
+
+    if (!voice.isFading()) {
+        mixFrames(voice, sample, outL, outR, frame, nframes - frame, gain);
+        return voice.playbackPosition < sample.lengthFrames;
+    }
+
+    // Fading voice: full level until the fade point (the frame of the hit
+    // that stole or choked it), then a linear ramp to silence
+    const uint32_t fadeStart = std::min(voice.fadeDelay, nframes);
+    voice.fadeDelay -= fadeStart;
+    if (fadeStart > frame) {
+        frame += mixFrames(voice, sample, outL, outR, frame, fadeStart - frame, gain);
+        if (voice.playbackPosition >= sample.lengthFrames) {
+            return false;
         }
-        
-        const uint64_t pos = voice.playbackPosition;
-        outL[i] += sampleL[pos] * gainL;
-        outR[i] += sampleR[pos] * gainR;
-        
-        voice.playbackPosition++;
     }
+    if (voice.fadeDelay > 0 || frame >= nframes) {
+        return true;
+    }
+
+    const uint64_t remaining = sample.lengthFrames - voice.playbackPosition;
+    const uint32_t frames = static_cast<uint32_t>(
+        std::min<uint64_t>({nframes - frame, remaining, voice.fadeRemaining}));
+    const uint64_t pos = voice.playbackPosition;
+    const float step = 1.0f / static_cast<float>(STEAL_FADE_FRAMES);
+    const float level = static_cast<float>(voice.fadeRemaining) * step;
+    
+    // The fade is short: hold the parameter gain where it starts
+    const float gainL = gain.startL + static_cast<float>(frame) * gain.stepL;
+    const float gainR = gain.startR + static_cast<float>(frame) * gain.stepR;
+    mixStereoRamp(sample.dataLeft.data() + pos, sample.dataRight.data() + pos,
+                  outL + frame, outR + frame, frames,
+                  gainL * level, gainR * level, -gainL * step, -gainR * step);
+
+    if (frames >= voice.fadeRemaining) {
+        // Faded out (stays marked as fading until released)
+        return false;
+    }
+    voice.fadeRemaining -= frames;
+    voice.playbackPosition += frames;
+    return voice.playbackPosition < sample.lengthFrames;
+}
+
+uint32_t Sampler::mixFrames(Voice& voice, const Sample& sample, float* outL, float* outR,
+                            uint32_t first, uint32_t count, const GainRamp& gain) {
+    // Frames requested vs. frames left in the sample
+    const uint64_t remaining = sample.lengthFrames - voice.playbackPosition;
+    const uint32_t frames = static_cast<uint32_t>(std::min<uint64_t>(count, remaining));
+
+    const uint64_t pos = voice.playbackPosition;
+    if (gain.isFlat()) {
+        kernels_->mixStereo(sample.dataLeft.data() + pos, sample.dataRight.data() + pos,
+                            outL + first, outR + first, frames, gain.startL, gain.startR);
+    } else {
+        // Parameter change in progress: per-sample ramp (one block at most)
+        mixStereoRamp(sample.dataLeft.data() + pos, sample.dataRight.data() + pos,
+                      outL + first, outR + first, frames,
+                      gain.startL + static_cast<float>(first) * gain.stepL,
+                      gain.startR + static_cast<float>(first) * gain.stepR,
+                      gain.stepL, gain.stepR);
+    }
+    voice.playbackPosition += frames;
+    return frames;
 }
 
 } // namespace beater
@@ -1,27 +1,76 @@
 #pragma once
 
 #include "engine/SampleLibrary.hpp"
+#include "engine/InstrumentTable.hpp"
+#include "engine/MixKernels.hpp"
+#include "engine/RenderWorkerPool.hpp"
+#include <atomic>
 #include <memory>
 #include <vector>
-#include <array>
 
 namespace beater {
 
-// Maximum number of simultaneous voices (RT-safe fixed size)
-constexpr size_t MAX_VOICES = 64;
+// Default polyphony (the pool itself is sized at construction)
+constexpr size_t DEFAULT_MAX_VOICES = 64;
+
+// Length of the fade-out applied to a stolen or choked voice (~1.3 ms at 48 kHz)
+constexpr uint32_t STEAL_FADE_FRAMES = 64;
+
+// Extra pool slots for stolen/choked voices that are still fading out
+constexpr size_t STEAL_FADE_SLOTS = 16;
+
+// Choke groups 1..MAX_CHOKE_GROUPS (0 = no group)
+constexpr int MAX_CHOKE_GROUPS = 32;
+
+// Parallel rendering: voices per helper below which one thread is faster
+// (waking a helper and summing its buffer cost about this many voices)
+constexpr size_t MIN_VOICES_PER_STRIPE = 8;
+
+// Longest block rendered in parallel (longer ones render on one thread)
+constexpr uint32_t MAX_PARALLEL_BLOCK_FRAMES = 4096;
+
+// What to do when noteOn finds every voice busy
+enum class StealPolicy {
+    None,                 // Drop the new note
+    Oldest,               // Steal the voice that started first
+    Quietest,             // Steal the voice with the lowest remaining level
+    SameInstrumentFirst   // Oldest voice of the same instrument, else oldest
+};
 
 // Voice state for sample playback
+// Refers to its sample by table handle, resolved once per block: starting
+// and stopping voices never touches a refcount, and a sample unloaded
+// mid-note simply ends the voice
 struct Voice {
-    std::shared_ptr<Sample> sample;
+    SampleHandle sample = INVALID_SAMPLE_HANDLE;
+    uint64_t lengthFrames = 0;  // Of the sample, cached for voice stealing
     uint64_t playbackPosition = 0;  // Current position in sample
     float velocity = 1.0f;
-    float gain = 1.0f;
-    float pan = 0.0f;  // -1.0 (left) to +1.0 (right)
+    float gain = 1.0f;  // Trigger-time gain/pan; instrument voices follow the
+    float pan = 0.0f;   // instrument table instead (-1.0 left to +1.0 right)
+    uint32_t startOffset = 0;  // Frames to wait before sounding (within the trigger block)
+    uint32_t fadeRemaining = 0;  // Non-zero while fading out (stolen or choked)
+    uint32_t fadeDelay = 0;  // Frames into the next block before the fade starts
+    int instrumentId = -1;  // -1 for previews not tied to an instrument
+    int chokeGroup = 0;
     bool active = false;
-    
+
+    // Pool links: indices into the voice pool, -1 for none
+    int32_t prev = -1;
+    int32_t next = -1;
+
+    bool isFading() const { return fadeRemaining > 0; }
+
+    // Clears playback state; pool links are managed by the Sampler
     void reset() {
-        sample = nullptr;
+        sample = INVALID_SAMPLE_HANDLE;
+        lengthFrames = 0;
         playbackPosition = 0;
+        startOffset = 0;
+        fadeRemaining = 0;
+        fadeDelay = 0;
+        instrumentId = -1;
+        chokeGroup = 0;
         velocity = 1.0f;
         gain = 1.0f;
         pan = 0.0f;
@@ -30,35 +79,132 @@ struct Voice {
 };
 
 // Sampler engine with voice management
+// Voices live in a pool allocated up front: a free list gives O(1) voice
+// allocation and an intrusive active list (in start order) is all render()
+// and voice stealing ever walk.
+// With a worker pool and enough voices, render() splits the active voices
+// into stripes rendered concurrently into partial buffers, which are then
+// summed into the output. Only the audio thread touches the voice lists.
 class Sampler {
 public:
-    Sampler();
+    // Samples are resolved through table, which must outlive the sampler
+    explicit Sampler(SampleTable& table, size_t maxVoices = DEFAULT_MAX_VOICES);
     ~Sampler() = default;
-    
+
     // Trigger a voice (sample-accurate within block)
-    // offsetFrames: offset within the current audio block
-    void noteOn(std::shared_ptr<Sample> sample, float velocity, 
-                float gain, float pan, uint32_t offsetFrames = 0);
-    
+    // offsetFrames: offset within the next rendered block; the voice starts
+    // mixing at exactly that frame
+    // instrumentId: used by SameInstrumentFirst stealing and maxPolyphony
+    // chokeGroup: voices already sounding in this group fade out (0 = none)
+    // maxPolyphony: voice limit for this instrument, oldest fades out (0 = none)
+    void noteOn(SampleHandle sample, float velocity,
+                float gain, float pan, uint32_t offsetFrames = 0,
+                int instrumentId = -1, int chokeGroup = 0, int maxPolyphony = 0);
+
     // Stop all voices
     void allNotesOff();
-    
+
     // Render audio for nframes
     // Mixes all active voices into outL/outR buffers
     void render(float* outL, float* outR, uint32_t nframes);
-    
-    // Get number of active voices
+
+    // Get number of active voices (including voices still fading out)
     size_t getActiveVoiceCount() const;
+
+    // Polyphony limit
+    size_t getMaxVoices() const { return maxVoices_; }
+
+    // Per-instrument gains for voices with an instrument id: they follow the
+    // table's smoothed gain/pan instead of their trigger-time values.
+    // Set before rendering starts; must outlive the sampler.
+    void setInstrumentTable(const InstrumentTable* instruments) { instruments_ = instruments; }
+
+    // Helper threads for render() (nullptr: always one thread). Set before
+    // rendering starts; must outlive the sampler. Allocates the partial
+    // buffers up front.
+    void setWorkerPool(RenderWorkerPool* pool);
     
+    // Voice stealing policy (safe to change while rendering)
+    void setStealPolicy(StealPolicy policy) { stealPolicy_.store(policy, std::memory_order_relaxed); }
+    StealPolicy getStealPolicy() const { return stealPolicy_.load(std::memory_order_relaxed); }
+
 private:
-    std::array<Voice, MAX_VOICES> voices_;
-    
-    // Find an available voice slot
-    Voice* allocateVoice();
-    
-    // Render a single voice
-    void renderVoice(Voice& voice, float* outL, float* outR, 
+    SampleTable& table_;
+    std::vector<Voice> voices_;  // maxVoices_ + STEAL_FADE_SLOTS
+    size_t maxVoices_;
+    const MixKernels* kernels_;  // SIMD kernels chosen at startup
+    const InstrumentTable* instruments_ = nullptr;
+    std::atomic<StealPolicy> stealPolicy_{StealPolicy::Oldest};
+
+    // Parallel rendering (preallocated; written by the audio thread before
+    // each job, read by the stripes)
+    RenderWorkerPool* pool_ = nullptr;
+    std::vector<int32_t> renderList_;           // Active voices, in list order
+    std::vector<const Sample*> renderSamples_;  // Resolved for this block
+    std::vector<uint8_t> renderAlive_;          // Per entry: still sounding after it
+    std::vector<float> partials_;               // Stereo buffer per stripe after the first
+    float* stripeOutL_ = nullptr;
+    float* stripeOutR_ = nullptr;
+    uint32_t stripeFrames_ = 0;
+    size_t stripeVoices_ = 0;
+    size_t stripeCount_ = 0;
+
+    int32_t freeHead_ = -1;    // Singly linked through Voice::next
+    int32_t activeHead_ = -1;  // Oldest active voice
+    int32_t activeTail_ = -1;  // Newest active voice
+    size_t activeCount_ = 0;   // All active voices
+    size_t soundingCount_ = 0; // Active voices not fading out
+
+    // Per choke group: bitmask of its sounding voices (indexed by pool slot)
+    size_t maskWords_;
+    std::vector<uint64_t> chokeMasks_;  // (MAX_CHOKE_GROUPS + 1) * maskWords_
+
+    // Get a voice slot for a new note, stealing if at the polyphony limit
+    Voice* allocateVoice(int instrumentId, uint32_t offsetFrames);
+
+    // Pick the voice to steal according to the current policy
+    int32_t findVictim(int instrumentId) const;
+
+    // Fade out every sounding voice in a choke group
+    void chokeVoices(int group, uint32_t offsetFrames);
+
+    // Fade out the oldest voices of an instrument beyond its polyphony limit
+    void limitPolyphony(int instrumentId, int maxPolyphony, uint32_t offsetFrames);
+
+    // Start fading a sounding voice out at offsetFrames into the next block;
+    // voices that would not be heard before then are released immediately
+    void beginFade(int32_t index, uint32_t offsetFrames);
+
+    // Return an active voice to the free list
+    void releaseVoice(int32_t index);
+
+    // Rebuild the free list with every voice inactive
+    void resetPool();
+
+    // Choke group bitmask bookkeeping
+    uint64_t* chokeMask(int group) { return &chokeMasks_[static_cast<size_t>(group) * maskWords_]; }
+    void setChokeBit(const Voice& voice, int32_t index, bool set);
+
+    // Stripes to render this block in (1: on this thread, as usual)
+    size_t stripesFor(uint32_t nframes) const;
+
+    // Render the active voices across the worker pool
+    void renderParallel(float* outL, float* outR, uint32_t nframes, size_t stripes);
+
+    // Pool task: the voices of one stripe (the first mixes straight into
+    // the output, the others into their partial buffer)
+    static void renderStripe(void* context, size_t stripe);
+    float* partialLeft(size_t stripe) { return &partials_[(stripe - 1) * 2 * MAX_PARALLEL_BLOCK_FRAMES]; }
+    float* partialRight(size_t stripe) { return partialLeft(stripe) + MAX_PARALLEL_BLOCK_FRAMES; }
+
+    // Render a single voice; returns false once the voice has finished
+    bool renderVoice(Voice& voice, const Sample& sample, float* outL, float* outR,
                      uint32_t startFrame, uint32_t nframes);
+
+    // Mix up to count frames of a voice from frame first, with the gain at
+    // block frame i being gain + i * step; returns frames mixed
+    uint32_t mixFrames(Voice& voice, const Sample& sample, float* outL, float* outR,
+                       uint32_t first, uint32_t count, const GainRamp& gain);
 };
 
 } // namespace beater
@@ -1,4 +1,5 @@
 #include "engine/Scheduler.hpp"
+#include "trace/Trace.hpp"
 #include <algorithm>
 #include <iostream>
 
@@ -7,14 +8,16 @@ namespace beater {
 Scheduler::Scheduler() {
 }
 
-void Scheduler::setProject(const Project* project) {
-    project_ = project;
+void Scheduler::setTimeline(const EventTimeline* timeline) {
+    timeline_ = timeline;
     pattern_ = nullptr;  // Clear legacy mode
+    cursor_ = EventTimeline::Cursor();
+    cursorTick_ = -1;
 }
 
 void Scheduler::setPattern(const Pattern* pattern) {
     pattern_ = pattern;
-    project_ = nullptr;  // Clear timeline mode
+    timeline_ = nullptr;  // Clear timeline mode
     if (pattern_ && loopLengthTicks_ == 0) {
         loopLengthTicks_ = pattern_->getLengthTicks();
     }
@@ -22,113 +25,52 @@ void Scheduler::setPattern(const Pattern* pattern) {
 
 void Scheduler::clear() {
     pattern_ = nullptr;
-    project_ = nullptr;
+    timeline_ = nullptr;
+    cursor_ = EventTimeline::Cursor();
+    cursorTick_ = -1;
 }
 
-std::vector<CompiledEvent> Scheduler::getEventsInRange(Tick startTick, Tick endTick) {
-    // Phase 4: Use timeline if project is set
-    if (project_ != nullptr) {
-        return getEventsFromTimeline(startTick, endTick);
+void Scheduler::getEventsInRange(Tick startTick, Tick endTick, EventBuffer& events) {
+    BEATER_TRACE_SCOPE("engine", "Scheduler::getEventsInRange");
+    events.clear();
+    
+    // Phase 4: Use timeline if one is set
+    if (timeline_ != nullptr) {
+        getEventsFromTimeline(startTick, endTick, events);
+        return;
     }
     
     // Phase 3: Fall back to single pattern mode
     if (pattern_ != nullptr) {
-        return getEventsFromSinglePattern(startTick, endTick);
+        getEventsFromSinglePattern(startTick, endTick, events);
     }
-    
-    return {};
 }
 
-std::vector<CompiledEvent> Scheduler::getEventsFromTimeline(Tick startTick, Tick endTick) {
-    std::vector<CompiledEvent> allEvents;
-    
-    // Iterate through all tracks
-    for (const auto& track : project_->getTracks()) {
-        // Get regions that overlap with [startTick, endTick)
-        auto regions = track.getRegionsInRange(startTick, endTick);
-        
-        for (const Region* region : regions) {
-            // Get the pattern for this region
-            const Pattern* pattern = project_->getPatternLibrary().getPattern(region->getPatternId());
-            if (pattern == nullptr) {
-                continue;
-            }
-            
-            // Get events from this region
-            auto regionEvents = getEventsFromRegion(*region, pattern, startTick, endTick);
-            
-            // Merge into all events
-            allEvents.insert(allEvents.end(), regionEvents.begin(), regionEvents.end());
-        }
-    }
-    
-    // Sort by tick
-    std::sort(allEvents.begin(), allEvents.end());
-    
-    return allEvents;
-}
-
-std::vector<CompiledEvent> Scheduler::getEventsFromRegion(const Region& region,
-                                                            const Pattern* pattern,
-                                                            Tick startTick,
-                                                            Tick endTick) {
-    std::vector<CompiledEvent> events;
-    
-    Tick regionStart = region.getStartTick();
-    Tick regionEnd = regionStart + region.getLengthTicks();
-    
-    // Only process if region overlaps with query range
-    if (regionEnd <= startTick || regionStart >= endTick) {
-        return events;
-    }
-    
-    Tick patternLength = pattern->getLengthTicks();
-    if (patternLength == 0) {
-        return events;
+void Scheduler::getEventsFromTimeline(Tick startTick, Tick endTick, EventBuffer& events) {
+    // Contiguous blocks continue where the last one stopped; anything else
+    // (locate, loop, scrub, new timeline) re-seeks with a binary search
+    if (startTick != cursorTick_) {
+        cursor_ = timeline_->seek(startTick);
     }
     
-    // Calculate how many times the pattern repeats in this region
-    Tick regionLength = region.getLengthTicks();
-    int numRepeats = (regionLength + patternLength - 1) / patternLength;
-    
-    // Generate events for each pattern repetition within the region
-    for (int rep = 0; rep < numRepeats; ++rep) {
-        Tick repeatStart = regionStart + (rep * patternLength);
-        Tick repeatEnd = repeatStart + patternLength;
-        
-        // Skip if this repeat is outside query range
-        if (repeatEnd <= startTick || repeatStart >= endTick) {
-            continue;
-        }
-        
-        // Add pattern notes, offset by repeat position
-        for (const auto& note : pattern->getNotes()) {
-            Tick eventTick = repeatStart + note.offsetTick;
-            
-            // Only include events in the requested range and within region bounds
-            if (eventTick >= startTick && eventTick < endTick && 
-                eventTick >= regionStart && eventTick < regionEnd) {
-                CompiledEvent event;
-                event.tick = eventTick;
-                event.instrumentId = note.instrumentId;
-                event.velocity = note.velocity;
-                events.push_back(event);
-            }
-        }
+    for (const CompiledEvent* event = timeline_->peek(cursor_);
+         event != nullptr && event->tick < endTick;
+         event = timeline_->peek(cursor_)) {
+        // A full buffer drops the rest of this block, never carries it over
+        events.push_back(*event);
+        timeline_->advance(cursor_);
     }
     
-    return events;
+    cursorTick_ = endTick;
 }
 
-std::vector<CompiledEvent> Scheduler::getEventsFromSinglePattern(Tick startTick, Tick endTick) {
-    std::vector<CompiledEvent> events;
-    
+void Scheduler::getEventsFromSinglePattern(Tick startTick, Tick endTick, EventBuffer& events) {
     if (pattern_ == nullptr || pattern_->getNotes().empty()) {
-        return events;
+        return;
     }
     
     if (loopLengthTicks_ == 0) {
-        return events;
+        return;
     }
     
     // For looping pattern: generate events across all loop iterations in range
@@ -168,10 +110,8 @@ std::vector<CompiledEvent> Scheduler::getEventsFromSinglePattern(Tick startTick,
         }
     }
     
-    // Sort events by tick
+    // Sort events by tick (in place, no allocation)
     std::sort(events.begin(), events.end());
-    
-    return events;
 }
 
 } // namespace beater
@@ -2,64 +2,66 @@
 
 #include "domain/Pattern.hpp"
 #include "domain/Instrument.hpp"
-#include "domain/Project.hpp"
 #include "domain/TimeTypes.hpp"
 #include "engine/Transport.hpp"
+#include "engine/EventTimeline.hpp"
+#include "engine/FixedVector.hpp"
 #include <vector>
 #include <memory>
 
 namespace beater {
 
-// Compiled event ready for scheduling
-struct CompiledEvent {
-    Tick tick;              // Absolute tick position
-    int instrumentId;
-    float velocity;
-    
-    bool operator<(const CompiledEvent& other) const {
-        return tick < other.tick;
-    }
-};
+// Maximum number of events triggered in one audio block (RT-safe fixed size)
+constexpr size_t MAX_EVENTS_PER_BLOCK = 1024;
+
+// Per-block event buffer, preallocated by the caller
+using EventBuffer = FixedVector<CompiledEvent>;
 
 // Scheduler: generates sample triggers from timeline arrangement
 class Scheduler {
 public:
     Scheduler();
     
-    // Phase 4: Set project for timeline-based playback
-    void setProject(const Project* project);
+    // Phase 4: Set compiled arrangement for timeline-based playback
+    // The timeline is borrowed (it lives in a project snapshot); swapping it
+    // mid-playback re-seeks the cursor on the next block
+    void setTimeline(const EventTimeline* timeline);
+    const EventTimeline* getTimeline() const { return timeline_; }
     
     // Phase 3 compatibility: Set single pattern for simple loop playback
     void setPattern(const Pattern* pattern);
     void setLoopLength(Tick ticks) { loopLengthTicks_ = ticks; }
     void setLooping(bool enabled) { looping_ = enabled; }
+    const Pattern* getPattern() const { return pattern_; }
+    Tick getLoopLength() const { return loopLengthTicks_; }
+    bool isLooping() const { return looping_; }
     
-    // Get events for the current cycle
-    // Phase 4: Queries all active regions across all tracks
+    // Get events for the current cycle into a preallocated buffer (cleared
+    // first; events past its capacity are dropped). RT-safe, no allocation.
+    // Phase 4: Advances a cursor through the compiled timeline; contiguous
+    //          blocks cost O(events in block), a jump costs one binary search
     // Phase 3: Returns events from single looping pattern
-    std::vector<CompiledEvent> getEventsInRange(Tick startTick, Tick endTick);
+    void getEventsInRange(Tick startTick, Tick endTick, EventBuffer& events);
     
     // Clear scheduler state
     void clear();
     
 private:
     // Phase 4: Timeline mode
-    const Project* project_ = nullptr;
+    const EventTimeline* timeline_ = nullptr;
+    EventTimeline::Cursor cursor_;  // Next event in timeline_
+    Tick cursorTick_ = -1;       // Tick the cursor is positioned for (-1: re-seek)
     
     // Phase 3: Single pattern mode (legacy)
     const Pattern* pattern_ = nullptr;
     Tick loopLengthTicks_ = 0;
     bool looping_ = true;
     
-    // Phase 4 helpers
-    std::vector<CompiledEvent> getEventsFromTimeline(Tick startTick, Tick endTick);
-    std::vector<CompiledEvent> getEventsFromRegion(const Region& region, 
-                                                     const Pattern* pattern,
-                                                     Tick startTick, 
-                                                     Tick endTick);
+    // Phase 4 helper
+    void getEventsFromTimeline(Tick startTick, Tick endTick, EventBuffer& events);
     
     // Phase 3 helper
-    std::vector<CompiledEvent> getEventsFromSinglePattern(Tick startTick, Tick endTick);
+    void getEventsFromSinglePattern(Tick startTick, Tick endTick, EventBuffer& events);
 };
 
 } // namespace beater
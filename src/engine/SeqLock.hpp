@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace beater {
+
+// Single-writer sequence lock for a small trivially copyable value
+//
+// The writer never waits (RT-safe: one counter bump on each side of the
+// copy); readers retry while a write is in progress, so they always see a
+// complete value. The payload is kept in relaxed atomic words, so the
+// overlapping read is not a data race.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() { store(T{}); }
+    explicit SeqLock(const T& value) { store(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer side (one thread only): publish a new value
+    void store(const T& value) {
+        std::array<uint64_t, WORDS> buffer{};
+        std::memcpy(buffer.data(), &value, sizeof(T));
+
+        const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);  // Odd: writing
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Reader side (any thread): the latest complete value
+    T load() const {
+        std::array<uint64_t, WORDS> buffer;
+        for (;;) {
+            const uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1u) {
+                continue;  // Write in progress
+            }
+            for (size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), buffer.data(), sizeof(T));
+        return value;
+    }
+
+    // Number of stores so far (the constructor's initial value included)
+    uint32_t getVersion() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, WORDS> words_{};
+};
+
+} // namespace beater
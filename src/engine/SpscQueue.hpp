@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace beater {
+
+// Bounded wait-free single-producer/single-consumer ring buffer
+// One thread may push, one (other) thread may pop; no locks, no allocation
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side: returns false if the queue is full
+    bool push(const T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        slots_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side: true if a push would fail
+    bool full() const {
+        return head_.load(std::memory_order_relaxed) -
+               tail_.load(std::memory_order_acquire) >= Capacity;
+    }
+
+    // Consumer side: returns false if the queue is empty
+    bool pop(T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: look at the oldest item without removing it
+    const T* peek() const {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[tail & (Capacity - 1)];
+    }
+
+    // Approximate when called from a third thread
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+    // Items queued; from the producer's side, at most this many (pops may
+    // be under way), so capacity() - size() is safe to push
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) -
+               tail_.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    std::array<T, Capacity> slots_{};
+    alignas(64) std::atomic<size_t> head_{0};  // Written by producer
+    alignas(64) std::atomic<size_t> tail_{0};  // Written by consumer
+};
+
+} // namespace beater
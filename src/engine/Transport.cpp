@@ -1,4 +1,7 @@
 #include "engine/Transport.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 
 namespace beater {
@@ -6,6 +9,7 @@ namespace beater {
 Transport::Transport() {
 }
 
+#ifdef BEATER_HAVE_JACK
 void Transport::updateFromJack(const jack_position_t& jackPos,
                                jack_transport_state_t jackState,
                                uint32_t sampleRate) {
@@ -29,11 +33,13 @@ void Transport::updateFromJack(const jack_position_t& jackPos,
         int tick = static_cast<int>(jackPos.tick);
         
         state_.tick = bar * ticksPerBar + beat * ticksPerBeat + tick;
+        tickPosition_ = static_cast<double>(state_.tick);
     } else {
         // No BBT info, calculate tick from frames
-        state_.tick = frameToTick(state_.frame, state_.bpm, sampleRate);
+        syncFromFrame();
     }
 }
+#endif
 
 void Transport::updateInternal(uint32_t nframes, uint32_t sampleRate) {
     if (!state_.rolling) {
@@ -41,27 +47,76 @@ void Transport::updateInternal(uint32_t nframes, uint32_t sampleRate) {
     }
     
     state_.sampleRate = sampleRate;
+    if (internalTempo_.getSampleRate() != sampleRate) {
+        // Single segment, storage already there: no allocation
+        internalTempo_.compileConstant(internalTempo_.getBpmAt(0), sampleRate);
+    }
     state_.frame += nframes;
     
     // Update tick based on frame position
-    state_.tick = frameToTick(state_.frame, state_.bpm, sampleRate);
+    syncFromFrame();
 }
 
 void Transport::setPosition(Tick tick) {
     state_.tick = tick;
-    state_.frame = tickToFrame(tick, state_.bpm, state_.sampleRate);
+    tickPosition_ = static_cast<double>(tick);
+    state_.frame = tickToFrame(tick);
+    state_.bpm = getTempoTimeline().getBpmAt(tick);
 }
 
 void Transport::setTempo(double bpm) {
-    state_.bpm = bpm;
+    internalTempo_.compileConstant(bpm, state_.sampleRate);
+    if (external_ == nullptr) {
+        // Keep the musical position under the new tempo
+        state_.frame = tickToFrame(state_.tick);
+        tickPosition_ = static_cast<double>(state_.tick);
+        state_.bpm = bpm;
+    }
+}
+
+void Transport::setTempoTimeline(const TempoTimeline* timeline) {
+    if (timeline == external_) {
+        return;
+    }
+    
+    // The previous timeline may already be gone; re-place the transport
+    // from the musical position recorded under it
+    external_ = timeline;
+    const double frame = std::round(getTempoTimeline().tickToFrameExact(tickPosition_));
+    state_.frame = frame > 0.0 ? static_cast<uint64_t>(frame) : 0;
+    state_.bpm = getTempoTimeline().getBpmAt(state_.tick);
 }
 
-Tick Transport::frameToTick(uint64_t frame, double bpm, uint32_t sampleRate) const {
-    return TimeUtils::framesToTicks(frame, bpm, sampleRate);
+void Transport::syncFromFrame() {
+    const TempoTimeline& tempo = getTempoTimeline();
+    tickPosition_ = tempo.frameToTickExact(static_cast<double>(state_.frame));
+    state_.tick = static_cast<Tick>(std::round(tickPosition_));
+    state_.bpm = tempo.getBpmAt(state_.tick);
+}
+
+double TransportPosition::frameAt(int64_t now) const {
+    if (!rolling || sampleRate == 0) {
+        return static_cast<double>(frame);
+    }
+    
+    double elapsed = static_cast<double>(now - timestampNs) * sampleRate / 1e9;
+    elapsed = std::min(std::max(elapsed, 0.0), static_cast<double>(blockFrames));
+    return std::max(0.0, static_cast<double>(frame) + elapsed - latencyFrames);
+}
+
+double TransportPosition::tickAt(int64_t now) const {
+    if (!rolling || sampleRate == 0) {
+        return tick;
+    }
+    
+    // Within a block the tempo is close enough to constant for display
+    const double frames = frameAt(now) - static_cast<double>(frame);
+    return std::max(0.0, tick + frames * bpm * PPQ / (60.0 * sampleRate));
 }
 
-uint64_t Transport::tickToFrame(Tick tick, double bpm, uint32_t sampleRate) const {
-    return TimeUtils::ticksToFrames(tick, bpm, sampleRate);
+int64_t TransportPosition::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 } // namespace beater
@@ -2,7 +2,10 @@
 
 #include "domain/TimeTypes.hpp"
 #include "domain/TempoMap.hpp"
+#include "domain/TempoTimeline.hpp"
+#ifdef BEATER_HAVE_JACK
 #include <jack/jack.h>
+#endif
 #include <cstdint>
 
 namespace beater {
@@ -12,42 +15,95 @@ struct TransportState {
     bool rolling = false;
     uint64_t frame = 0;          // Current frame position
     Tick tick = 0;               // Current musical tick position
-    double bpm = 120.0;
+    double bpm = 120.0;          // Tempo at the current position
     TimeSignature signature = {4, 4};
     uint32_t sampleRate = 48000;
 };
 
+// Transport position as published by the audio thread once per block
+// (through a SeqLock, see Engine::getTransportPosition). Lets other threads
+// place the playhead between blocks without touching TransportState.
+struct TransportPosition {
+    bool rolling = false;
+    uint64_t frame = 0;           // First frame of the published block
+    double tick = 0.0;            // Exact musical position of frame
+    double bpm = 120.0;           // Tempo at frame
+    uint32_t sampleRate = 48000;
+    uint32_t blockFrames = 0;     // Length of the published block
+    uint32_t latencyFrames = 0;   // Output latency: frame is heard this much later
+    int64_t timestampNs = 0;      // steady_clock time the block started rendering
+
+    // Position being heard at a steady_clock time, extrapolated from the
+    // block at its tempo and held at the block's end if no newer block
+    // arrives (stalled or stopped audio never runs ahead)
+    double frameAt(int64_t nowNs) const;
+    double tickAt(int64_t nowNs) const;
+
+    // steady_clock now, in the units of timestampNs
+    static int64_t nowNs();
+};
+
 // Transport manager - handles timing and position
+// Ticks and frames are converted through a compiled TempoTimeline: the
+// project's (set per block by the engine) or, without one, an internal
+// constant tempo set with setTempo().
 class Transport {
 public:
     Transport();
-    
+
+#ifdef BEATER_HAVE_JACK
     // Update from JACK transport
-    void updateFromJack(const jack_position_t& jackPos, 
+    void updateFromJack(const jack_position_t& jackPos,
                        jack_transport_state_t jackState,
                        uint32_t sampleRate);
-    
+#endif
+
     // Update with internal transport (when not following JACK)
     void updateInternal(uint32_t nframes, uint32_t sampleRate);
-    
+
     // Get current state
     const TransportState& getState() const { return state_; }
-    
-    // Transport controls (internal)
+
+    // Transport controls (internal; audio thread, see Engine's commands)
     void play() { state_.rolling = true; }
     void stop() { state_.rolling = false; }
     void setPosition(Tick tick);
     void setTempo(double bpm);
-    
-    // Convert between time domains
-    Tick frameToTick(uint64_t frame, double bpm, uint32_t sampleRate) const;
-    uint64_t tickToFrame(Tick tick, double bpm, uint32_t sampleRate) const;
-    
+
+    // Tempo timeline to convert with (audio thread, at a block boundary)
+    // The musical position is kept when the timeline changes; nullptr
+    // reverts to the internal constant tempo. Must stay alive while set.
+    void setTempoTimeline(const TempoTimeline* timeline);
+    const TempoTimeline& getTempoTimeline() const {
+        return external_ != nullptr ? *external_ : internalTempo_;
+    }
+
+    // Convert between time domains (tempo-map aware)
+    Tick frameToTick(uint64_t frame) const { return getTempoTimeline().frameToTick(frame); }
+    uint64_t tickToFrame(Tick tick) const { return getTempoTimeline().tickToFrame(tick); }
+
+    // First tick whose frame position is at or after the given frame
+    // Used to split the timeline into per-block tick ranges whose events all
+    // land inside the block: [firstTickAtFrame(start), firstTickAtFrame(end))
+    Tick firstTickAtFrame(uint64_t frame) const { return getTempoTimeline().firstTickAtFrame(frame); }
+
     // Check if transport has advanced
     bool isRolling() const { return state_.rolling; }
     
+    // Exact (unrounded) musical position of the current frame
+    double getTickPosition() const { return tickPosition_; }
+
 private:
     TransportState state_;
+    TempoTimeline internalTempo_;
+    const TempoTimeline* external_ = nullptr;
+
+    // Exact musical position of state_.frame, used to re-place the transport
+    // when the tempo timeline changes under it
+    double tickPosition_ = 0.0;
+
+    // Derive tick and tempo from the current frame
+    void syncFromFrame();
 };
 
 } // namespace beater
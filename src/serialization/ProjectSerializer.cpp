@@ -3,9 +3,11 @@
 #include "domain/Region.hpp"
 #include "domain/Pattern.hpp"
 #include "domain/Instrument.hpp"
+#include "trace/Trace.hpp"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -40,14 +42,18 @@ Pattern deserializePattern(const json& j) {
         j["lengthTicks"].get<Tick>()
     );
     
+    // Collect, then sort once
+    std::vector<StepNote> notes;
+    notes.reserve(j["notes"].size());
     for (const auto& noteJson : j["notes"]) {
         StepNote note;
         note.instrumentId = noteJson["instrumentId"].get<int>();
         note.offsetTick = noteJson["offsetTick"].get<Tick>();
         note.velocity = noteJson["velocity"].get<float>();
         note.probability = noteJson.value("probability", 1.0f);
-        pattern.addNote(note);
+        notes.push_back(note);
     }
+    pattern.addNotes(notes);
     
     return pattern;
 }
@@ -94,9 +100,13 @@ json serializeTrack(const Track& track) {
 Track deserializeTrack(const json& j) {
     Track track(j["id"].get<std::string>(), j["name"].get<std::string>());
     
+    // Collect, then sort and index once
+    std::vector<Region> regions;
+    regions.reserve(j["regions"].size());
     for (const auto& regionJson : j["regions"]) {
-        track.addRegion(deserializeRegion(regionJson));
+        regions.push_back(deserializeRegion(regionJson));
     }
+    track.addRegions(regions);
     
     return track;
 }
@@ -109,6 +119,8 @@ json serializeInstrument(const Instrument& instrument) {
     j["gain"] = instrument.getGain();
     j["pan"] = instrument.getPan();
     j["samplePath"] = instrument.getSamplePath();
+    j["chokeGroup"] = instrument.getChokeGroup();
+    j["maxPolyphony"] = instrument.getMaxPolyphony();
     return j;
 }
 
@@ -121,10 +133,14 @@ Instrument deserializeInstrument(const json& j) {
     instrument.setGain(j["gain"].get<float>());
     instrument.setPan(j["pan"].get<float>());
     instrument.setSamplePath(j["samplePath"].get<std::string>());
+    // Absent in projects saved before choke groups existed
+    instrument.setChokeGroup(j.value("chokeGroup", 0));
+    instrument.setMaxPolyphony(j.value("maxPolyphony", 0));
     return instrument;
 }
 
 bool ProjectSerializer::saveToFile(const Project& project, const std::string& filepath) {
+    BEATER_TRACE_SCOPE("io", "ProjectSerializer::saveToFile");
     try {
         json j;
         j["version"] = 1;
@@ -156,6 +172,19 @@ bool ProjectSerializer::saveToFile(const Project& project, const std::string& fi
         }
         j["instruments"] = instruments;
         
+        // Serialize tempo map
+        json tempoChanges = json::array();
+        for (const auto& change : project.getTempoMap().getChanges()) {
+            json changeJson;
+            changeJson["tick"] = change.atTick;
+            changeJson["bpm"] = change.bpm;
+            if (change.ramp) {
+                changeJson["ramp"] = true;
+            }
+            tempoChanges.push_back(changeJson);
+        }
+        j["tempoChanges"] = tempoChanges;
+        
         // Serialize meter map (time signatures)
         json meterChanges = json::array();
         // Note: MeterMap doesn't expose its changes, so we'd need to add that API
@@ -188,6 +217,7 @@ bool ProjectSerializer::saveToFile(const Project& project, const std::string& fi
 }
 
 bool ProjectSerializer::loadFromFile(Project& project, const std::string& filepath) {
+    BEATER_TRACE_SCOPE("io", "ProjectSerializer::loadFromFile");
     try {
         std::ifstream file(filepath);
         if (!file.is_open()) {
@@ -234,6 +264,17 @@ bool ProjectSerializer::loadFromFile(Project& project, const std::string& filepa
             }
         }
         
+        // Load tempo map (older projects have none: keep the default)
+        if (j.contains("tempoChanges") && !j["tempoChanges"].empty()) {
+            TempoMap& tempoMap = project.getTempoMap();
+            tempoMap.clear();
+            for (const auto& changeJson : j["tempoChanges"]) {
+                tempoMap.addChange(changeJson["tick"].get<Tick>(),
+                                   changeJson["bpm"].get<double>(),
+                                   changeJson.value("ramp", false));
+            }
+        }
+        
         // Load meter map
         if (j.contains("meterChanges")) {
             for (const auto& changeJson : j["meterChanges"]) {
@@ -246,6 +287,9 @@ bool ProjectSerializer::loadFromFile(Project& project, const std::string& filepa
             }
         }
         
+        // The whole load is one edit
+        project.incrementRevision();
+        
         std::cout << "Project loaded from: " << filepath << std::endl;
         return true;
         
@@ -0,0 +1,232 @@
+#include "trace/Trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace beater {
+
+// One thread's events. Only the owning thread writes; dumps read the
+// fields as relaxed atomics and drop any slot the writer may have reached
+// meanwhile (claimed is bumped, then fenced, before a slot is rewritten).
+struct Tracer::Ring {
+    struct Event {
+        std::atomic<const char*> category{nullptr};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> startNs{0};
+        std::atomic<int64_t> durationNs{0};
+    };
+
+    std::unique_ptr<Event[]> events;
+    std::atomic<uint64_t> head{0};       // Events completely written
+    std::atomic<uint64_t> claimed{0};    // Events written or being written
+    std::atomic<uint64_t> dumpFrom{0};   // First event a dump includes (clear())
+    std::atomic<const char*> threadName{nullptr};
+};
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+
+// The calling thread's ring (nullptr until it first traces) and name
+thread_local Tracer::Ring* currentRing = nullptr;
+thread_local bool ringUnavailable = false;
+thread_local const char* currentThreadName = nullptr;
+
+constexpr uint64_t RING_MASK = Tracer::EVENTS_PER_THREAD - 1;
+static_assert((Tracer::EVENTS_PER_THREAD & RING_MASK) == 0,
+              "EVENTS_PER_THREAD must be a power of two");
+
+// A copied event, ready to print
+struct Copied {
+    const char* category;
+    const char* name;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+void writeString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text != nullptr ? text : ""; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() = default;
+
+Tracer::~Tracer() {
+    waitForDump();
+}
+
+void Tracer::setEnabled(bool enabled) {
+    if (enabled && !ringsReady_.load(std::memory_order_acquire)) {
+        rings_ = std::make_unique<Ring[]>(MAX_THREADS);
+        for (size_t i = 0; i < MAX_THREADS; ++i) {
+            rings_[i].events = std::make_unique<Ring::Event[]>(EVENTS_PER_THREAD);
+        }
+        ringsReady_.store(true, std::memory_order_release);
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::clear() {
+    const size_t claimed = std::min(ringsClaimed_.load(std::memory_order_acquire), MAX_THREADS);
+    for (size_t i = 0; i < claimed; ++i) {
+        rings_[i].dumpFrom.store(rings_[i].head.load(std::memory_order_acquire),
+                                 std::memory_order_relaxed);
+    }
+}
+
+void Tracer::setThreadName(const char* name) {
+    currentThreadName = name;
+    if (currentRing != nullptr) {
+        currentRing->threadName.store(name, std::memory_order_relaxed);
+    }
+}
+
+int64_t Tracer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Tracer::Ring* Tracer::threadRing() {
+    if (currentRing != nullptr || ringUnavailable) {
+        return currentRing;
+    }
+    if (!ringsReady_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    // First event on this thread: claim a ring (no allocation)
+    const size_t index = ringsClaimed_.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= MAX_THREADS) {
+        ringUnavailable = true;
+        return nullptr;
+    }
+    currentRing = &rings_[index];
+    currentRing->threadName.store(currentThreadName, std::memory_order_relaxed);
+    return currentRing;
+}
+
+void Tracer::record(const char* category, const char* name, int64_t startNs, int64_t endNs) {
+    Ring* ring = threadRing();
+    if (ring == nullptr) {
+        return;
+    }
+
+    const uint64_t index = ring->head.load(std::memory_order_relaxed);
+    ring->claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Ring::Event& event = ring->events[index & RING_MASK];
+    event.category.store(category, std::memory_order_relaxed);
+    event.name.store(name, std::memory_order_relaxed);
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.durationNs.store(endNs - startNs, std::memory_order_relaxed);
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::writeJson(std::ostream& out) {
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+    };
+
+    out << std::fixed << std::setprecision(3);
+    std::vector<Copied> copied;
+    const size_t claimed = ringsReady_.load(std::memory_order_acquire)
+        ? std::min(ringsClaimed_.load(std::memory_order_acquire), MAX_THREADS) : 0;
+    for (size_t i = 0; i < claimed; ++i) {
+        Ring& ring = rings_[i];
+        const int tid = static_cast<int>(i) + 1;
+
+        // Copy the live part of the ring...
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t begin = std::max(ring.dumpFrom.load(std::memory_order_relaxed),
+                                  head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0);
+        copied.clear();
+        for (uint64_t index = begin; index < head; ++index) {
+            const Ring::Event& event = ring.events[index & RING_MASK];
+            copied.push_back({event.category.load(std::memory_order_relaxed),
+                              event.name.load(std::memory_order_relaxed),
+                              event.startNs.load(std::memory_order_relaxed),
+                              event.durationNs.load(std::memory_order_relaxed)});
+        }
+
+        // ...then drop the slots the writer may have rewritten meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t claimedNow = ring.claimed.load(std::memory_order_relaxed);
+        const uint64_t valid = claimedNow > EVENTS_PER_THREAD ? claimedNow - EVENTS_PER_THREAD : 0;
+        const size_t skip = static_cast<size_t>(std::min<uint64_t>(
+            copied.size(), valid > begin ? valid - begin : 0));
+
+        // Thread name (metadata event)
+        const char* threadName = ring.threadName.load(std::memory_order_relaxed);
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":";
+        if (threadName != nullptr) {
+            writeString(out, threadName);
+        } else {
+            out << "\"thread " << tid << "\"";
+        }
+        out << "}}";
+
+        // Complete events, timestamps in microseconds
+        for (size_t e = skip; e < copied.size(); ++e) {
+            separator();
+            out << "{\"name\":";
+            writeString(out, copied[e].name);
+            out << ",\"cat\":";
+            writeString(out, copied[e].category);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                << ",\"ts\":" << static_cast<double>(copied[e].startNs) / 1000.0
+                << ",\"dur\":" << static_cast<double>(copied[e].durationNs) / 1000.0 << "}";
+        }
+    }
+    out << "]}\n";
+}
+
+bool Tracer::dump(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open trace file: " << path << "\n";
+        return false;
+    }
+    writeJson(file);
+    return file.good();
+}
+
+void Tracer::dumpInBackground(const std::string& path) {
+    waitForDump();
+    dumpThread_ = std::thread([this, path]() {
+        BEATER_TRACE_THREAD("trace dump");
+        if (dump(path)) {
+            std::cout << "Trace written to " << path << "\n";
+        }
+    });
+}
+
+void Tracer::waitForDump() {
+    if (dumpThread_.joinable()) {
+        dumpThread_.join();
+    }
+}
+
+} // namespace beater
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace beater {
+
+// Low-overhead timeline tracing, exported as Chrome trace-event JSON
+// (opens in Perfetto or chrome://tracing)
+//
+// Each thread records into its own preallocated ring the first time it
+// traces; a record is a few relaxed stores, never a lock or an allocation,
+// so the audio thread may trace. When the ring wraps the oldest events are
+// overwritten. Disabled, a trace point costs one relaxed load and a branch;
+// building with BEATER_NO_TRACING removes them altogether.
+//
+// Names and categories are kept by pointer: pass string literals.
+class Tracer {
+public:
+    static constexpr size_t MAX_THREADS = 16;          // Rings; later threads go untraced
+    static constexpr size_t EVENTS_PER_THREAD = 16384; // Per ring (power of two)
+
+    struct Ring;  // One thread's events (defined in Trace.cpp)
+
+    static Tracer& instance();
+
+    // Start/stop recording (control thread). The rings are allocated the
+    // first time tracing is enabled.
+    void setEnabled(bool enabled);
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Forget what has been recorded so far (dumps start after this point)
+    void clear();
+
+    // Copy the rings out and write them as trace-event JSON. Safe while
+    // threads keep tracing; events overwritten during the copy are dropped.
+    void writeJson(std::ostream& out);
+    bool dump(const std::string& path);
+
+    // Dump on a background thread (waits for a previous dump first)
+    void dumpInBackground(const std::string& path);
+    void waitForDump();
+
+    // Recording thread: name shown for it in the trace (a literal)
+    static void setThreadName(const char* name);
+
+    // Recording thread: one complete event, [startNs, endNs) on nowNs()
+    void record(const char* category, const char* name, int64_t startNs, int64_t endNs);
+
+    // steady_clock now, in nanoseconds
+    static int64_t nowNs();
+
+private:
+    Tracer();
+    ~Tracer();
+
+    Ring* threadRing();
+
+    static std::atomic<bool> enabled_;
+
+    std::unique_ptr<Ring[]> rings_;       // MAX_THREADS, once enabled
+    std::atomic<bool> ringsReady_{false};
+    std::atomic<size_t> ringsClaimed_{0};
+    std::thread dumpThread_;
+};
+
+// Traces the enclosing scope as one complete event
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name)
+        : category_(category), name_(name),
+          startNs_(Tracer::isEnabled() ? Tracer::nowNs() : 0) {
+    }
+
+    ~TraceScope() {
+        if (startNs_ != 0) {
+            Tracer::instance().record(category_, name_, startNs_, Tracer::nowNs());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* category_;
+    const char* name_;
+    int64_t startNs_;  // 0: tracing was off at the start of the scope
+};
+
+} // namespace beater
+
+#ifdef BEATER_NO_TRACING
+#define BEATER_TRACE_SCOPE(category, name) ((void)0)
+#define BEATER_TRACE_THREAD(name) ((void)0)
+#else
+#define BEATER_TRACE_CONCAT_(a, b) a##b
+#define BEATER_TRACE_CONCAT(a, b) BEATER_TRACE_CONCAT_(a, b)
+#define BEATER_TRACE_SCOPE(category, name) \
+    ::beater::TraceScope BEATER_TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#define BEATER_TRACE_THREAD(name) ::beater::Tracer::setThreadName(name)
+#endif
@@ -4,6 +4,7 @@
 #include "engine/Engine.hpp"
 #include "domain/Project.hpp"
 #include "serialization/ProjectSerializer.hpp"
+#include "trace/Trace.hpp"
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -28,6 +29,8 @@
 #include <QDialogButtonBox>
 #include <QDir>
 #include <QDirIterator>
+#include <QSignalBlocker>
+#include <cmath>
 
 namespace beater {
 
@@ -35,10 +38,17 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     applyDarkTheme();
     setupUI();
     
-    // Create update timer for playhead position
+    // Playhead timer at display rate: each tick only reads the position the
+    // audio thread publishes and extrapolates it to now
     updateTimer_ = new QTimer(this);
+    updateTimer_->setTimerType(Qt::PreciseTimer);
     connect(updateTimer_, &QTimer::timeout, this, &MainWindow::updatePlayhead);
-    updateTimer_->start(50);  // Update at 20 Hz
+    updateTimer_->start(16);  // ~60 Hz
+    
+    // Callback telemetry changes slowly; twice a second is plenty to read
+    statsTimer_ = new QTimer(this);
+    connect(statsTimer_, &QTimer::timeout, this, &MainWindow::updateStats);
+    statsTimer_->start(500);
 }
 
 void MainWindow::applyDarkTheme() {
@@ -172,14 +182,19 @@ void MainWindow::setEngine(Engine* engine) {
     engine_ = engine;
     
     if (engine_) {
-        statusLabel_->setText(QString("🟢 Engine Ready | Sample Rate: %1 Hz | Buffer: %2 frames")
+        statusLabel_->setText(QString("🟢 Engine Ready (%1) | Sample Rate: %2 Hz | Buffer: %3 frames")
+                            .arg(engine_->getAudioBackend().getName())
                             .arg(engine_->getSampleRate())
                             .arg(engine_->getBufferSize()));
         
-        // Set initial tempo from engine
-        const auto& state = engine_->getTransport().getState();
-        tempoSpinBox_->setValue(state.bpm);
-        meterLabel_->setText(QString("%1/%2").arg(state.signature.numerator).arg(state.signature.denominator));
+        // Set initial tempo and meter from the project (signals blocked:
+        // showing the tempo must not write it back, rounded, as an edit)
+        const TimeSignature signature = engine_->getProject().getMeterMap().getSignatureAt(0);
+        {
+            const QSignalBlocker blocker(tempoSpinBox_);
+            tempoSpinBox_->setValue(engine_->getProject().getTempoMap().getBpmAt(0));
+        }
+        meterLabel_->setText(QString("%1/%2").arg(signature.numerator).arg(signature.denominator));
         
         // Connect timeline widget to engine and project
         if (timelineWidget_) {
@@ -415,6 +430,14 @@ void MainWindow::createMenuBar() {
     viewMenu->addAction("Zoom &Out")->setShortcut(QKeySequence::ZoomOut);
     viewMenu->addAction("&Reset Zoom");
     
+    // Tools menu
+    QMenu* toolsMenu = menuBar->addMenu("&Tools");
+    QAction* recordTraceAction = toolsMenu->addAction("&Record Trace");
+    recordTraceAction->setCheckable(true);
+    connect(recordTraceAction, &QAction::toggled, this, &MainWindow::onRecordTraceToggled);
+    QAction* saveTraceAction = toolsMenu->addAction("Save &Trace...");
+    connect(saveTraceAction, &QAction::triggered, this, &MainWindow::onSaveTrace);
+    
     // Help menu
     QMenu* helpMenu = menuBar->addMenu("&Help");
     helpMenu->addAction("&About Beater");
@@ -425,42 +448,61 @@ void MainWindow::createMenuBar() {
 void MainWindow::createStatusBar() {
     statusLabel_ = new QLabel("🔴 Engine: Not connected", this);
     statusBar()->addWidget(statusLabel_, 1);
+    
+    statsLabel_ = new QLabel(this);
+    statsLabel_->setToolTip("Audio callback: DSP load (time / buffer period), "
+                            "callback time, voices and xruns since the last reset");
+    statusBar()->addPermanentWidget(statsLabel_);
+}
+
+void MainWindow::updateStats() {
+    if (!engine_ || !engine_->isActive()) {
+        statsLabel_->clear();
+        return;
+    }
+    
+    const EngineStats stats = engine_->getStats();
+    statsLabel_->setText(QString("DSP %1% (p99 %2%, max %3%) | Callback p99 %4 ms, max %5 ms | "
+                                 "Voices %6 (peak %7) | Xruns %8")
+                         .arg(stats.dspLoad * 100.0, 0, 'f', 0)
+                         .arg(stats.dspLoadP99 * 100.0, 0, 'f', 0)
+                         .arg(stats.dspLoadMax * 100.0, 0, 'f', 0)
+                         .arg(stats.callback.p99Us / 1000.0, 0, 'f', 2)
+                         .arg(stats.callback.maxUs / 1000.0, 0, 'f', 2)
+                         .arg(stats.activeVoices)
+                         .arg(stats.peakVoices)
+                         .arg(stats.xruns));
 }
 
 void MainWindow::onPlayClicked() {
     if (engine_) {
         // Play from current transport position
-        Tick currentTick = engine_->getTransport().getState().tick;
+        Tick currentTick = static_cast<Tick>(std::llround(engine_->getTransportPosition().tick));
         engine_->playFromTick(currentTick);
-        playButton_->setEnabled(false);
-        stopButton_->setEnabled(true);
     }
 }
 
 void MainWindow::onStopClicked() {
     if (engine_) {
         engine_->stopPlayback();
-        playButton_->setEnabled(true);
-        stopButton_->setEnabled(false);
     }
 }
 
 void MainWindow::onRewindClicked() {
     if (engine_) {
-        bool wasPlaying = engine_->isPlaying();
-        if (wasPlaying) {
-            engine_->stopPlayback();
-        }
-        engine_->playFromTick(0);
-        if (!wasPlaying) {
-            engine_->stopPlayback();
+        // Back to the start; keeps rolling if it was
+        if (engine_->isPlaying()) {
+            engine_->playFromTick(0);
+        } else {
+            engine_->locate(0);
         }
     }
 }
 
 void MainWindow::onTempoChanged(double value) {
     if (engine_) {
-        engine_->getTransport().setTempo(value);
+        // Goes into the project's tempo map, which the transport follows
+        engine_->setTempo(value);
     }
 }
 
@@ -600,19 +642,29 @@ void MainWindow::onSettingsClicked() {
 }
 
 void MainWindow::updatePlayhead() {
-    if (engine_ && engine_->isPlaying()) {
-        const auto& state = engine_->getTransport().getState();
+    // Buttons follow what the audio thread has actually applied
+    CommandAck ack;
+    while (engine_ && engine_->pollAck(ack)) {
+        playButton_->setEnabled(!ack.rolling);
+        stopButton_->setEnabled(ack.rolling);
+    }
+    
+    const TransportPosition position = engine_ ? engine_->getTransportPosition() : TransportPosition();
+    if (engine_ && position.rolling) {
+        // Where the listener is now, from the last block the audio thread published
+        const int64_t now = TransportPosition::nowNs();
+        const Tick tick = static_cast<Tick>(position.tickAt(now));
         
         // Calculate time position
-        double seconds = static_cast<double>(state.frame) / state.sampleRate;
+        double seconds = position.frameAt(now) / position.sampleRate;
         int minutes = static_cast<int>(seconds) / 60;
         double secs = seconds - (minutes * 60);
         
         // Calculate bar/beat position
-        Tick ticksPerBeat = PPQ;
-        Tick ticksPerBar = TimeUtils::ticksPerBar(state.signature);
-        int bar = static_cast<int>(state.tick / ticksPerBar) + 1;
-        int beat = static_cast<int>((state.tick % ticksPerBar) / ticksPerBeat) + 1;
+        const MeterMap& meterMap = engine_->getProject().getMeterMap();
+        Tick ticksPerBeat = TimeUtils::ticksPerBeat(meterMap.getSignatureAt(tick));
+        int bar = meterMap.getBarIndexAt(tick) + 1;
+        int beat = static_cast<int>((tick - meterMap.getBarStartAt(tick)) / ticksPerBeat) + 1;
         
         timeLabel_->setText(QString("%1:%2")
                           .arg(minutes)
@@ -622,7 +674,7 @@ void MainWindow::updatePlayhead() {
                              .arg(bar)
                              .arg(beat));
         
-        positionLabel_->setText(QString("Tick: %1").arg(state.tick));
+        positionLabel_->setText(QString("Tick: %1").arg(tick));
         
         // Update timeline visualization
         if (timelineWidget_) {
@@ -665,6 +717,15 @@ void MainWindow::onOpenProject() {
         currentFilePath_ = filename;
         setWindowTitle(QString("Beater Drum Machine v0.1.0 - %1").arg(QFileInfo(filename).fileName()));
         
+        // Make the loaded project audible
+        if (engine_) {
+            engine_->publishProject();
+        }
+        {
+            const QSignalBlocker blocker(tempoSpinBox_);
+            tempoSpinBox_->setValue(project_->getTempoMap().getBpmAt(0));
+        }
+        
         // Refresh UI
         if (timelineWidget_) {
             timelineWidget_->setProject(project_);
@@ -719,4 +780,28 @@ void MainWindow::onSaveProjectAs() {
     }
 }
 
+void MainWindow::onRecordTraceToggled(bool checked) {
+    if (checked) {
+        Tracer::instance().clear();
+    }
+    Tracer::instance().setEnabled(checked);
+}
+
+void MainWindow::onSaveTrace() {
+    QString filename = QFileDialog::getSaveFileName(
+        this,
+        "Save Trace",
+        "beater-trace.json",
+        "Trace Files (*.json);;All Files (*)"
+    );
+    
+    if (filename.isEmpty()) {
+        return;
+    }
+    
+    // Written off the UI thread; open it in Perfetto or chrome://tracing
+    Tracer::instance().dumpInBackground(filename.toStdString());
+    statusBar()->showMessage(QString("Saving trace to %1").arg(QFileInfo(filename).fileName()), 3000);
+}
+
 } // namespace beater
@@ -31,6 +31,7 @@ private slots:
     void onStopClicked();
     void onRewindClicked();
     void updatePlayhead();
+    void updateStats();
     void onTempoChanged(double value);
     void onLoopToggled(bool checked);
     void onSettingsClicked();
@@ -38,6 +39,8 @@ private slots:
     void onOpenProject();
     void onSaveProject();
     void onSaveProjectAs();
+    void onRecordTraceToggled(bool checked);
+    void onSaveTrace();
     
 private:
     void setupUI();
@@ -62,11 +65,13 @@ private:
     QLabel* tempoLabel_ = nullptr;
     QLabel* meterLabel_ = nullptr;
     QLabel* statusLabel_ = nullptr;
+    QLabel* statsLabel_ = nullptr;
     QDoubleSpinBox* tempoSpinBox_ = nullptr;
     QCheckBox* loopCheckBox_ = nullptr;
     QSpinBox* loopStartSpinBox_ = nullptr;
     QSpinBox* loopEndSpinBox_ = nullptr;
     QTimer* updateTimer_ = nullptr;
+    QTimer* statsTimer_ = nullptr;
     TimelineWidget* timelineWidget_ = nullptr;
     PatternPalette* patternPalette_ = nullptr;
 };
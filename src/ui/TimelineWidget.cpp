@@ -3,6 +3,7 @@
 #include "domain/Track.hpp"
 #include "domain/Region.hpp"
 #include "engine/Engine.hpp"
+#include "trace/Trace.hpp"
 #include <QPainter>
 #include <QPaintEvent>
 #include <QMouseEvent>
@@ -39,9 +40,39 @@ TimelineCanvas::TimelineCanvas(QWidget* parent) : QWidget(parent) {
 
 void TimelineCanvas::setProject(Project* project) {
     project_ = project;
+    invalidateLayers();
+}
+
+void TimelineCanvas::invalidateLayers() {
+    layerValid_ = false;
+    playheadX_ = -1;  // Zoom may have moved it
     update();
 }
 
+void TimelineCanvas::updatePlayhead() {
+    if (!engine_) return;
+    
+    const int x = tickToPixel(playheadTick());
+    if (x == playheadX_) {
+        return;
+    }
+    if (playheadX_ >= 0) {
+        update(playheadRect(playheadX_));
+    }
+    update(playheadRect(x));
+    playheadX_ = x;
+}
+
+Tick TimelineCanvas::playheadTick() const {
+    // What is being heard now, extrapolated from the audio thread's last block
+    const TransportPosition position = engine_->getTransportPosition();
+    return static_cast<Tick>(position.tickAt(TransportPosition::nowNs()));
+}
+
+QRect TimelineCanvas::playheadRect(int x) const {
+    return QRect(x - PLAYHEAD_HALF_WIDTH, 0, 2 * PLAYHEAD_HALF_WIDTH + 1, height());
+}
+
 void TimelineCanvas::setEngine(Engine* engine) {
     engine_ = engine;
 }
@@ -58,12 +89,7 @@ QSize TimelineCanvas::sizeHint() const {
     for (size_t i = 0; i < project_->getTrackCount(); ++i) {
         const Track* track = project_->getTrack(i);
         if (track) {
-            for (const auto& region : track->getRegions()) {
-                Tick endTick = region.getEndTick();
-                if (endTick > maxTick) {
-                    maxTick = endTick;
-                }
-            }
+            maxTick = std::max(maxTick, track->getEndTick());
         }
     }
     
@@ -86,94 +112,129 @@ int TimelineCanvas::tickToPixel(Tick tick) const {
     return static_cast<int>((tick * pixelsPerBeat_) / PPQ);
 }
 
-void TimelineCanvas::paintEvent(QPaintEvent*) {
+void TimelineCanvas::paintEvent(QPaintEvent* event) {
+    BEATER_TRACE_THREAD("ui");
+    BEATER_TRACE_SCOPE("ui", "TimelineCanvas::paintEvent");
+    const QRect exposed = event->rect();
+    if (!isLayerCurrent(exposed)) {
+        // Visible area plus a margin, so small scrolls reuse the layer
+        const QRect visible = visibleRegion().boundingRect();
+        const QRect area = visible.adjusted(-visible.width() / 2, -visible.height() / 2,
+                                            visible.width() / 2, visible.height() / 2) & rect();
+        renderStaticLayer(area.united(exposed));
+    }
+    
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    painter.drawPixmap(layerRect_.topLeft(), staticLayer_);
     
-    int width = this->width();
-    int height = this->height();
+    // Draw playhead - always visible for positioning
+    if (engine_) {
+        if (playheadX_ < 0) {
+            playheadX_ = tickToPixel(playheadTick());
+        }
+        painter.setRenderHint(QPainter::Antialiasing);
+        drawPlayhead(painter, playheadX_, height());
+    }
+}
+
+bool TimelineCanvas::isLayerCurrent(const QRect& exposed) const {
+    return layerValid_ && layerProject_ == project_ &&
+           (!project_ || layerRevision_ == project_->getRevision()) &&
+           layerPixelsPerBeat_ == pixelsPerBeat_ &&
+           staticLayer_.devicePixelRatio() == devicePixelRatioF() &&
+           layerRect_.contains(exposed);
+}
+
+void TimelineCanvas::renderStaticLayer(const QRect& area) {
+    const qreal dpr = devicePixelRatioF();
+    if (staticLayer_.size() != area.size() * dpr) {
+        staticLayer_ = QPixmap(area.size() * dpr);
+    }
+    staticLayer_.setDevicePixelRatio(dpr);
+    
+    QPainter painter(&staticLayer_);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(-area.topLeft());
     
     // Background
-    painter.fillRect(0, 0, width, height, QColor(0x1a, 0x1a, 0x1a));
+    painter.fillRect(area, QColor(0x1a, 0x1a, 0x1a));
     
     // Draw ruler
-    drawRuler(painter, width);
+    if (area.top() <= RULER_HEIGHT) {
+        drawRuler(painter, area);
+    }
     
     // Draw tracks
     if (project_) {
-        drawTracks(painter, width, height);
+        drawTracks(painter, area);
     }
     
-    // Draw playhead - always visible for positioning
-    if (engine_) {
-        drawPlayhead(painter, height);
-    }
+    layerRect_ = area;
+    layerProject_ = project_;
+    layerRevision_ = project_ ? project_->getRevision() : 0;
+    layerPixelsPerBeat_ = pixelsPerBeat_;
+    layerValid_ = true;
 }
 
-void TimelineCanvas::drawRuler(QPainter& painter, int width) {
+void TimelineCanvas::drawRuler(QPainter& painter, const QRect& area) {
     // Ruler background
-    painter.fillRect(0, 0, width, RULER_HEIGHT, QColor(0x25, 0x25, 0x25));
+    painter.fillRect(area.left(), 0, area.width(), RULER_HEIGHT, QColor(0x25, 0x25, 0x25));
     
     if (!project_) return;
     
     // Draw bar numbers and beat marks using MeterMap
     const auto& meterMap = project_->getMeterMap();
-    painter.setPen(QColor(0x60, 0x60, 0x60));
-    
-    // Calculate visible range
-    Tick endTick = pixelToTick(width);
     
-    // Draw bars from start to end
-    Tick currentTick = 0;
-    int barNumber = 1;
+    // Bar and beat lines across the area in one query (from a label's
+    // width further left, so numbers of bars starting off-area still show)
+    const Tick startTick = std::max(Tick(0), pixelToTick(area.left() - 54));
+    meterMap.getGridLines(startTick, pixelToTick(area.right()) + 1, gridLines_);
     
-    while (currentTick <= endTick) {
-        TimeSignature sig = meterMap.getSignatureAt(currentTick);
-        Tick barLength = TimeUtils::ticksPerBar(sig);
-        
-        int x = tickToPixel(currentTick);
-        
-        if (x >= 0 && x <= width) {
+    for (const GridLine& line : gridLines_) {
+        int x = tickToPixel(line.tick);
+        if (line.isBar()) {
             // Bar line
             painter.setPen(QColor(0x60, 0x60, 0x60));
             painter.drawLine(x, 0, x, RULER_HEIGHT);
             
             // Bar number
             painter.setPen(QColor(0xb0, 0xb0, 0xb0));
-            painter.drawText(x + 4, 12, 50, 20, Qt::AlignLeft | Qt::AlignTop, QString::number(barNumber));
-            
+            painter.drawText(x + 4, 12, 50, 20, Qt::AlignLeft | Qt::AlignTop, QString::number(line.bar + 1));
+        } else {
             // Beat marks (lighter lines)
             painter.setPen(QColor(0x40, 0x40, 0x40));
-            for (int beat = 1; beat < sig.numerator; ++beat) {
-                int beatX = tickToPixel(currentTick + beat * PPQ);
-                if (beatX >= 0 && beatX <= width) {
-                    painter.drawLine(beatX, RULER_HEIGHT - 10, beatX, RULER_HEIGHT);
-                }
-            }
+            painter.drawLine(x, RULER_HEIGHT - 10, x, RULER_HEIGHT);
         }
-        
-        currentTick += barLength;
-        barNumber++;
-        
-        // Safety check to prevent infinite loop
-        if (barNumber > 1000) break;
     }
     
     // Ruler bottom border
     painter.setPen(QColor(0x3a, 0x3a, 0x3a));
-    painter.drawLine(0, RULER_HEIGHT, width, RULER_HEIGHT);
+    painter.drawLine(area.left(), RULER_HEIGHT, area.right() + 1, RULER_HEIGHT);
 }
 
-void TimelineCanvas::drawTracks(QPainter& painter, int width, int) {
-    int y = RULER_HEIGHT + TRACK_SPACING;
-    
-    for (size_t i = 0; i < project_->getTrackCount(); ++i) {
-        const Track* track = project_->getTrack(i);
+void TimelineCanvas::drawTracks(QPainter& painter, const QRect& area) {
+    const int left = area.left();
+    const int width = area.width();
+    const int rowHeight = TRACK_HEIGHT + TRACK_SPACING;
+    const int trackCount = static_cast<int>(project_->getTrackCount());
+    
+    // Only the rows that intersect the area
+    const int firstRow = std::max(0, (area.top() - RULER_HEIGHT - TRACK_SPACING) / rowHeight);
+    const int lastRow = std::min(trackCount, (area.bottom() - RULER_HEIGHT) / rowHeight + 1);
+    
+    // Ticks covered by the area (regions reaching into it are drawn whole)
+    const Tick startTick = std::max(Tick(0), pixelToTick(left) - 1);
+    const Tick endTick = pixelToTick(area.right()) + 1;
+    
+    for (int i = firstRow; i < lastRow; ++i) {
+        const Track* track = project_->getTrack(static_cast<size_t>(i));
         if (!track) continue;
         
+        const int y = RULER_HEIGHT + TRACK_SPACING + i * rowHeight;
+        
         // Track background
         QColor trackBg = (i % 2 == 0) ? QColor(0x20, 0x20, 0x20) : QColor(0x22, 0x22, 0x22);
-        painter.fillRect(0, y, width, TRACK_HEIGHT, trackBg);
+        painter.fillRect(left, y, width, TRACK_HEIGHT, trackBg);
         
         // Track name
         painter.setPen(QColor(0xa0, 0xa0, 0xa0));
@@ -181,7 +242,8 @@ void TimelineCanvas::drawTracks(QPainter& painter, int width, int) {
                         QString::fromStdString(track->getName()));
         
         // Draw regions
-        for (const auto& region : track->getRegions()) {
+        for (const Region* regionPtr : track->getRegionsInRange(startTick, endTick)) {
+            const Region& region = *regionPtr;
             int regionX = tickToPixel(region.getStartTick());
             int regionWidth = tickToPixel(region.getLengthTicks());
             int regionY = y + 25;
@@ -190,7 +252,7 @@ void TimelineCanvas::drawTracks(QPainter& painter, int width, int) {
             // Region color based on pattern name heuristics
             QColor regionColor;
             QString regionLabel;
-            std::string patternId = region.getPatternId();
+            const std::string& patternId = region.getPatternId();
             QString patternName = QString::fromStdString(patternId).toLower();
             
             if (patternName.contains("groove") || patternName.contains("beat") || patternName.contains("basic")) {
@@ -247,18 +309,11 @@ void TimelineCanvas::drawTracks(QPainter& painter, int width, int) {
         
         // Track separator
         painter.setPen(QColor(0x2a, 0x2a, 0x2a));
-        painter.drawLine(0, y + TRACK_HEIGHT, width, y + TRACK_HEIGHT);
-        
-        y += TRACK_HEIGHT + TRACK_SPACING;
+        painter.drawLine(left, y + TRACK_HEIGHT, left + width, y + TRACK_HEIGHT);
     }
 }
 
-void TimelineCanvas::drawPlayhead(QPainter& painter, int height) {
-    if (!engine_) return;
-    
-    const auto& state = engine_->getTransport().getState();
-    int x = tickToPixel(state.tick);
-    
+void TimelineCanvas::drawPlayhead(QPainter& painter, int x, int height) {
     // Playhead line - always visible for positioning
     painter.setPen(QPen(QColor(0x00, 0xaa, 0xff), 2));
     painter.drawLine(x, 0, x, height);
@@ -322,8 +377,7 @@ TimelineCanvas::RegionHitInfo TimelineCanvas::hitTestRegion(const QPoint& pos) c
 void TimelineCanvas::updateCursor(const QPoint& pos) {
     // Check if hovering over playhead
     if (engine_) {
-        const auto& state = engine_->getTransport().getState();
-        int playheadX = tickToPixel(state.tick);
+        int playheadX = tickToPixel(playheadTick());
         if (std::abs(pos.x() - playheadX) <= 6) {
             setCursor(Qt::SizeHorCursor);
             return;
@@ -351,8 +405,7 @@ void TimelineCanvas::mousePressEvent(QMouseEvent* event) {
     
     // Check if clicking on playhead first
     if (engine_) {
-        const auto& state = engine_->getTransport().getState();
-        int playheadX = tickToPixel(state.tick);
+        int playheadX = tickToPixel(playheadTick());
         if (std::abs(event->pos().x() - playheadX) <= 6) {
             // Clicked on playhead - start dragging it
             interactionMode_ = InteractionMode::DraggingPlayhead;
@@ -397,8 +450,8 @@ void TimelineCanvas::mousePressEvent(QMouseEvent* event) {
             // Snap to beat grid
             Tick snapSize = PPQ;
             clickedTick = (clickedTick / snapSize) * snapSize;
-            engine_->getTransport().setPosition(clickedTick);
-            update();
+            engine_->locate(clickedTick);
+            updatePlayhead();
         }
     }
 }
@@ -417,8 +470,8 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
             // Snap to beat grid
             Tick snapSize = PPQ;
             newTick = std::max(Tick(0), (newTick / snapSize) * snapSize);
-            engine_->getTransport().setPosition(newTick);
-            update();
+            engine_->locate(newTick);
+            updatePlayhead();
         }
         return;
     }
@@ -430,9 +483,17 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
         return;
     }
     
-    // Get mutable region
-    auto& regions = const_cast<std::vector<Region>&>(track->getRegions());
-    Region& region = regions[draggedRegion_.regionIndex];
+    // Region edits go through the track so its range index stays current;
+    // a move can change the dragged region's index
+    const auto& regions = track->getRegions();
+    size_t regionIndex = draggedRegion_.regionIndex;
+    const Region& region = regions[regionIndex];
+    auto setBounds = [&](size_t index, Tick startTick, Tick lengthTicks) {
+        size_t newIndex = track->setRegionBounds(index, startTick, lengthTicks);
+        if (index == regionIndex) {
+            regionIndex = newIndex;
+        }
+    };
     
     int deltaX = event->pos().x() - dragStartPos_.x();
     Tick deltaTicks = pixelToTick(deltaX);
@@ -447,8 +508,8 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
             newStartTick = (newStartTick / snapSize) * snapSize;
             // Clamp to positive values
             if (newStartTick < 0) newStartTick = 0;
-            region.setStartTick(newStartTick);
-            update();
+            setBounds(regionIndex, newStartTick, region.getLengthTicks());
+            invalidateLayers();
             break;
         }
         
@@ -462,13 +523,13 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
             // Minimum length: 1 beat
             if (newLength >= PPQ && newStartTick >= 0) {
                 // Check for overlap with previous region
-                if (draggedRegion_.regionIndex > 0) {
-                    Region& prevRegion = regions[draggedRegion_.regionIndex - 1];
+                if (regionIndex > 0) {
+                    const Region& prevRegion = regions[regionIndex - 1];
                     if (newStartTick < prevRegion.getEndTick()) {
                         // Shrink previous region to make room
                         Tick prevNewLength = newStartTick - prevRegion.getStartTick();
                         if (prevNewLength >= PPQ) {
-                            prevRegion.setLengthTicks(prevNewLength);
+                            setBounds(regionIndex - 1, prevRegion.getStartTick(), prevNewLength);
                         } else {
                             // Can't shrink further, limit our resize
                             newStartTick = prevRegion.getStartTick() + PPQ;
@@ -477,9 +538,8 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
                     }
                 }
                 
-                region.setStartTick(newStartTick);
-                region.setLengthTicks(newLength);
-                update();
+                setBounds(regionIndex, newStartTick, newLength);
+                invalidateLayers();
             }
             break;
         }
@@ -493,16 +553,15 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
                 Tick newEndTick = region.getStartTick() + newLength;
                 
                 // Check for overlap with next region
-                if (draggedRegion_.regionIndex < regions.size() - 1) {
-                    Region& nextRegion = regions[draggedRegion_.regionIndex + 1];
+                if (regionIndex < regions.size() - 1) {
+                    const Region& nextRegion = regions[regionIndex + 1];
                     if (newEndTick > nextRegion.getStartTick()) {
                         // Shrink next region from the left
                         Tick nextOriginalEnd = nextRegion.getEndTick();
                         Tick nextNewLength = nextOriginalEnd - newEndTick;
                         
                         if (nextNewLength >= PPQ) {
-                            nextRegion.setStartTick(newEndTick);
-                            nextRegion.setLengthTicks(nextNewLength);
+                            setBounds(regionIndex + 1, newEndTick, nextNewLength);
                         } else {
                             // Can't shrink further, limit our resize
                             newLength = nextRegion.getStartTick() - region.getStartTick();
@@ -510,8 +569,8 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
                     }
                 }
                 
-                region.setLengthTicks(newLength);
-                update();
+                setBounds(regionIndex, region.getStartTick(), newLength);
+                invalidateLayers();
             }
             break;
         }
@@ -519,11 +578,25 @@ void TimelineCanvas::mouseMoveEvent(QMouseEvent* event) {
         default:
             break;
     }
+    
+    // Keep following the dragged region if the edit re-sorted the track
+    if (selectedRegion_.isValid && selectedRegion_.trackIndex == draggedRegion_.trackIndex &&
+        selectedRegion_.regionIndex == draggedRegion_.regionIndex) {
+        selectedRegion_.regionIndex = regionIndex;
+    }
+    draggedRegion_.regionIndex = regionIndex;
 }
 
 void TimelineCanvas::mouseReleaseEvent(QMouseEvent* event) {
     if (event->button() == Qt::LeftButton) {
+        // Region drags/resizes reach the audio thread once, on release
+        bool editedRegion = interactionMode_ == InteractionMode::DraggingRegion ||
+                            interactionMode_ == InteractionMode::ResizingLeft ||
+                            interactionMode_ == InteractionMode::ResizingRight;
         interactionMode_ = InteractionMode::None;
+        if (editedRegion) {
+            commitEdit();
+        }
         updateCursor(event->pos());
     }
     QWidget::mouseReleaseEvent(event);
@@ -592,8 +665,7 @@ void TimelineCanvas::deleteRegion(size_t trackIndex, size_t regionIndex) {
     // Remove the region
     track->removeRegion(regionId);
     
-    // Update display
-    update();
+    commitEdit();
 }
 
 void TimelineCanvas::keyPressEvent(QKeyEvent* event) {
@@ -622,7 +694,7 @@ void TimelineCanvas::wheelEvent(QWheelEvent* event) {
             pixelsPerBeat_ = newZoom;
             setMinimumSize(sizeHint());
             updateGeometry();
-            update();
+            invalidateLayers();
         }
         
         event->accept();
@@ -736,6 +808,7 @@ void TimelineCanvas::setRegionTimeSignature(size_t trackIndex, size_t regionInde
                 .arg(newSig.denominator);
             
             Pattern newPattern(patternId, displayName.toStdString(), barLength);
+            std::vector<StepNote> notes;
             
             if (patternStyle == "fill") {
                 // Fill pattern: rapid snare hits with increasing velocity, crash at end
@@ -743,59 +816,69 @@ void TimelineCanvas::setRegionTimeSignature(size_t trackIndex, size_t regionInde
                 for (int i = 0; i < subdivisions; ++i) {
                     Tick pos = (barLength * i) / subdivisions;
                     float velocity = 0.6f + (i * 0.02f);
-                    newPattern.addNote({1, pos, velocity}); // Snare
+                    notes.push_back({1, pos, velocity}); // Snare
                 }
-                newPattern.addNote({3, barLength - 10, 0.9f}); // Crash at end
+                notes.push_back({3, barLength - 10, 0.9f}); // Crash at end
                 
             } else if (patternStyle == "halftime") {
                 // Half-time pattern: kick on 1, snare on 3, hi-hat on half beats
-                newPattern.addNote({0, 0, 0.9f}); // Kick on 1
+                notes.push_back({0, 0, 0.9f}); // Kick on 1
                 if (newSig.numerator >= 3) {
-                    newPattern.addNote({1, PPQ * 2, 0.85f}); // Snare on 3
+                    notes.push_back({1, PPQ * 2, 0.85f}); // Snare on 3
                 }
                 // Hi-hat on half the beats
                 for (int beat = 0; beat < newSig.numerator; beat += 2) {
-                    newPattern.addNote({2, PPQ * beat, 0.65f});
+                    notes.push_back({2, PPQ * beat, 0.65f});
                 }
                 
             } else {
                 // Groove pattern: standard kick/snare/hi-hat
                 // Kick on beat 1
-                newPattern.addNote({0, 0, 0.9f});
+                notes.push_back({0, 0, 0.9f});
                 
                 // Snare on backbeats
                 if (newSig.numerator >= 4) {
-                    newPattern.addNote({1, PPQ * 2, 0.8f});  // Beat 3
-                    newPattern.addNote({1, PPQ * (newSig.numerator - 1), 0.8f});  // Last beat
+                    notes.push_back({1, PPQ * 2, 0.8f});  // Beat 3
+                    notes.push_back({1, PPQ * (newSig.numerator - 1), 0.8f});  // Last beat
                 } else if (newSig.numerator == 3) {
-                    newPattern.addNote({1, PPQ * 2, 0.8f});  // Beat 3
+                    notes.push_back({1, PPQ * 2, 0.8f});  // Beat 3
                 } else if (newSig.numerator == 2) {
-                    newPattern.addNote({1, PPQ, 0.8f});  // Beat 2
+                    notes.push_back({1, PPQ, 0.8f});  // Beat 2
                 }
                 
                 // Hi-hat on every beat
                 for (int beat = 0; beat < newSig.numerator; ++beat) {
                     float velocity = (beat == 0) ? 0.7f : 0.55f;
-                    newPattern.addNote({2, PPQ * beat, velocity});
+                    notes.push_back({2, PPQ * beat, velocity});
                 }
             }
             
+            newPattern.addNotes(notes);
             const_cast<Project*>(project_)->getPatternLibrary().addPattern(newPattern);
         }
         
         // Update the region to use the new pattern
         Track* mutableTrack = const_cast<Track*>(track);
-        auto& mutableRegions = const_cast<std::vector<Region>&>(mutableTrack->getRegions());
-        if (regionIndex < mutableRegions.size()) {
-            mutableRegions[regionIndex].setPatternId(patternId);
-            mutableRegions[regionIndex].setLengthTicks(barLength);
+        if (regionIndex < mutableTrack->getRegions().size()) {
+            mutableTrack->setRegionPattern(regionIndex, patternId);
+            mutableTrack->setRegionBounds(regionIndex, mutableTrack->getRegions()[regionIndex].getStartTick(),
+                                          barLength);
         }
         
-        // Update display
-        update();
+        commitEdit();
     }
 }
 
+void TimelineCanvas::commitEdit() {
+    if (project_) {
+        project_->incrementRevision();
+    }
+    if (engine_) {
+        engine_->publishProject();
+    }
+    update();
+}
+
 int TimelineCanvas::hitTestTrack(const QPoint& pos) const {
     if (!project_ || pos.y() < RULER_HEIGHT) {
         return -1;
@@ -943,7 +1026,7 @@ void TimelineCanvas::dropEvent(QDropEvent* event) {
     track->addRegion(newRegion);
     
     event->acceptProposedAction();
-    update();
+    commitEdit();
 }
 
 // ============================================================================
@@ -1021,7 +1104,7 @@ void TimelineWidget::setEngine(Engine* engine) {
 
 void TimelineWidget::updatePlayhead() {
     if (canvas_) {
-        canvas_->update();
+        canvas_->updatePlayhead();
     }
 }
 
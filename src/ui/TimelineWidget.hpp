@@ -2,7 +2,11 @@
 
 #include <QWidget>
 #include <QScrollArea>
+#include <QPixmap>
 #include "domain/TimeTypes.hpp"
+#include "domain/MeterMap.hpp"
+#include <cstdint>
+#include <vector>
 
 namespace beater {
 
@@ -10,6 +14,9 @@ class Project;
 class Engine;
 
 // Custom widget for rendering the timeline with tracks and regions
+// The ruler and region blocks are drawn (culled to the visible area) into
+// a cached layer that is rebuilt only when the project revision, the zoom
+// or the visible area changes; playhead moves repaint two thin strips.
 class TimelineCanvas : public QWidget {
     Q_OBJECT
     
@@ -18,9 +25,16 @@ public:
     
     void setProject(Project* project);
     void setEngine(Engine* engine);
-    void setPixelsPerBeat(double ppb) { pixelsPerBeat_ = ppb; update(); }
+    void setPixelsPerBeat(double ppb) { pixelsPerBeat_ = ppb; invalidateLayers(); }
     double getPixelsPerBeat() const { return pixelsPerBeat_; }
     
+    // Repaint only where the playhead was and where it is now
+    void updatePlayhead();
+    
+    // Rebuild the cached layer on the next paint (edits not yet committed
+    // to a new project revision, e.g. during a drag)
+    void invalidateLayers();
+    
     QSize sizeHint() const override;
     
 protected:
@@ -37,9 +51,15 @@ protected:
     void wheelEvent(QWheelEvent* event) override;
     
 private:
-    void drawRuler(QPainter& painter, int width);
-    void drawTracks(QPainter& painter, int width, int height);
-    void drawPlayhead(QPainter& painter, int height);
+    // Static layer: the ruler and tracks inside area, into staticLayer_
+    void renderStaticLayer(const QRect& area);
+    bool isLayerCurrent(const QRect& exposed) const;
+    
+    void drawRuler(QPainter& painter, const QRect& area);
+    void drawTracks(QPainter& painter, const QRect& area);
+    void drawPlayhead(QPainter& painter, int x, int height);
+    QRect playheadRect(int x) const;
+    Tick playheadTick() const;
     
     Tick pixelToTick(int x) const;
     int tickToPixel(Tick tick) const;
@@ -59,6 +79,9 @@ private:
     void setRegionTimeSignature(size_t trackIndex, size_t regionIndex);
     int hitTestTrack(const QPoint& pos) const;
     
+    // Publish the edited project to the audio thread and repaint
+    void commitEdit();
+    
     Project* project_ = nullptr;
     Engine* engine_ = nullptr;
     double pixelsPerBeat_ = 40.0;  // Zoom level
@@ -72,10 +95,24 @@ private:
     Tick dragStartTick_ = 0;
     Tick dragOriginalLength_ = 0;
     
+    // Bar/beat lines of the ruler (reused between paints)
+    std::vector<GridLine> gridLines_;
+    
+    // Cached static layer covering layerRect_ (canvas coordinates)
+    QPixmap staticLayer_;
+    QRect layerRect_;
+    const Project* layerProject_ = nullptr;
+    uint64_t layerRevision_ = 0;
+    double layerPixelsPerBeat_ = 0.0;
+    bool layerValid_ = false;
+    
+    int playheadX_ = -1;  // Where the playhead is drawn; -1 until known
+    
     static constexpr int RULER_HEIGHT = 40;
     static constexpr int TRACK_HEIGHT = 80;
     static constexpr int TRACK_SPACING = 4;
     static constexpr int RESIZE_EDGE_WIDTH = 8;
+    static constexpr int PLAYHEAD_HALF_WIDTH = 8;  // Covers the triangle and pen
 };
 
 // Timeline widget with ruler, tracks, and scrolling
@@ -94,6 +131,10 @@ public slots:
     void zoomOut();
     void resetZoom();
     
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    
 private:
     TimelineCanvas* canvas_ = nullptr;
     QScrollArea* scrollArea_ = nullptr;
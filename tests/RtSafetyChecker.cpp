@@ -0,0 +1,134 @@
+#include "RtSafetyChecker.hpp"
+#include <dlfcn.h>
+#include <pthread.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+// glibc's real allocator entry points
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+// Plain-old-data thread locals: no dynamic initialization, safe inside malloc
+thread_local bool armed = false;
+thread_local size_t allocationCount = 0;
+thread_local size_t freeCount = 0;
+thread_local size_t lockCount = 0;
+
+using MutexFn = int (*)(pthread_mutex_t*);
+MutexFn realMutexLock = nullptr;
+MutexFn realMutexTrylock = nullptr;
+
+void resolveMutexFunctions() {
+    if (realMutexLock == nullptr) {
+        realMutexLock = reinterpret_cast<MutexFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realMutexTrylock = reinterpret_cast<MutexFn>(dlsym(RTLD_NEXT, "pthread_mutex_trylock"));
+    }
+}
+
+inline void noteAllocation() {
+    if (armed) {
+        ++allocationCount;
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    noteAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    noteAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    noteAllocation();
+    return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    noteAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    noteAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    noteAllocation();
+    void* ptr = __libc_memalign(alignment, size);
+    if (ptr == nullptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (armed && ptr != nullptr) {
+        ++freeCount;
+    }
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    if (armed) {
+        ++lockCount;
+    }
+    resolveMutexFunctions();
+    return realMutexLock(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t* mutex) {
+    if (armed) {
+        ++lockCount;
+    }
+    resolveMutexFunctions();
+    return realMutexTrylock(mutex);
+}
+
+} // extern "C"
+
+namespace beater {
+namespace rtcheck {
+
+RtSafetyScope::RtSafetyScope() {
+    // Resolve before arming: dlsym may allocate
+    resolveMutexFunctions();
+    armed = true;
+}
+
+RtSafetyScope::~RtSafetyScope() {
+    armed = false;
+}
+
+Violations violations() {
+    Violations v;
+    v.allocations = allocationCount;
+    v.frees = freeCount;
+    v.locks = lockCount;
+    return v;
+}
+
+void resetViolations() {
+    allocationCount = 0;
+    freeCount = 0;
+    lockCount = 0;
+}
+
+} // namespace rtcheck
+} // namespace beater
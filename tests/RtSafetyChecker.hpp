@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+// Test-mode RT-safety checker
+//
+// Linking RtSafetyChecker.cpp into a test executable interposes malloc/free
+// (and friends) and pthread mutex locking. The hooks only count while an
+// RtSafetyScope is alive on the calling thread, so a test can wrap a single
+// rendered block and assert that it neither allocated nor took a lock.
+namespace beater {
+namespace rtcheck {
+
+struct Violations {
+    size_t allocations = 0;   // malloc/calloc/realloc/aligned allocations
+    size_t frees = 0;         // free of a non-null pointer
+    size_t locks = 0;         // pthread_mutex_lock/trylock
+
+    size_t total() const { return allocations + frees + locks; }
+};
+
+// Arms the checker on this thread for the lifetime of the scope
+class RtSafetyScope {
+public:
+    RtSafetyScope();
+    ~RtSafetyScope();
+
+    RtSafetyScope(const RtSafetyScope&) = delete;
+    RtSafetyScope& operator=(const RtSafetyScope&) = delete;
+};
+
+// Violations recorded on this thread since the last reset
+Violations violations();
+void resetViolations();
+
+} // namespace rtcheck
+} // namespace beater
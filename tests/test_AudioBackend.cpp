@@ -0,0 +1,330 @@
+#include "engine/Engine.hpp"
+#include "engine/NullAudioBackend.hpp"
+#include "engine/FileAudioBackend.hpp"
+#include "engine/SeqLock.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace beater;
+
+void testManualStep() {
+    NullAudioBackend backend(48000, 64);
+    std::vector<uint32_t> blocks;
+    backend.setAudioCallback([&](uint32_t nframes, float* outL, float* outR) {
+        blocks.push_back(nframes);
+        outL[0] = 1.0f;
+        outR[nframes - 1] = -1.0f;
+    });
+
+    // Not running yet: nothing happens
+    backend.step(64);
+    assert(blocks.empty());
+
+    const bool started = backend.initialize("test");
+    assert(started);
+    assert(backend.isActive());
+    backend.step(200);
+    assert((blocks == std::vector<uint32_t>{64, 64, 64, 8}));
+    assert(backend.getFramesProcessed() == 200);
+    assert(backend.getLastBlockFrames() == 8);
+    assert(backend.getLeft()[0] == 1.0f);
+    assert(backend.getRight()[7] == -1.0f);
+
+    backend.shutdown();
+    assert(!backend.isActive());
+
+    std::cout << "✓ testManualStep passed\n";
+}
+
+void testThreadClock() {
+    NullAudioBackend backend(48000, 480, NullClock::Thread);
+    std::atomic<int> calls{0};
+    backend.setAudioCallback([&](uint32_t, float*, float*) { calls.fetch_add(1); });
+    const bool started = backend.initialize("test");
+    assert(started);
+
+    // 10 ms blocks: roughly realtime, not free-running
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    backend.shutdown();
+    assert(calls.load() >= 5);
+    assert(calls.load() <= 40);
+    assert(backend.getFramesProcessed() == static_cast<uint64_t>(calls.load()) * 480);
+
+    std::cout << "✓ testThreadClock passed\n";
+}
+
+void testEngineOnNullBackend() {
+    Engine engine(std::make_unique<NullAudioBackend>(44100, 128));
+    const bool started = engine.initialize("test");
+    assert(started);
+    assert(std::string(engine.getAudioBackend().getName()) == "null");
+    assert(engine.getSampleRate() == 44100);
+    assert(engine.getBufferSize() == 128);
+
+    // The transport advances with the backend's clock
+    engine.playTimeline();
+    static_cast<NullAudioBackend&>(engine.getAudioBackend()).step(44100);
+    const auto& state = engine.getTransport().getState();
+    assert(state.frame == 44100);
+    assert(state.tick == 1920);  // One second at 120 BPM
+
+    engine.shutdown();
+    std::cout << "✓ testEngineOnNullBackend passed\n";
+}
+
+void testInitializeTwiceKeepsHelpers() {
+    Engine engine(std::make_unique<NullAudioBackend>(48000, 256, NullClock::Thread));
+    engine.setRenderThreads(2);
+    bool started = engine.initialize("test");
+    assert(started);
+    assert(engine.getRenderWorkers().getThreadCount() == 2);
+
+    // Refused while the callback runs: the helpers it uses stay in place
+    engine.setRenderThreads(3);
+    started = engine.initialize("test");
+    assert(!started);
+    assert(engine.getAudioBackend().isActive());
+    assert(engine.getRenderWorkers().getThreadCount() == 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Once stopped it starts again, with the new helper count
+    engine.shutdown();
+    assert(engine.getRenderWorkers().getThreadCount() == 0);
+    started = engine.initialize("test");
+    assert(started);
+    assert(engine.getRenderWorkers().getThreadCount() == 3);
+
+    engine.shutdown();
+    std::cout << "✓ testInitializeTwiceKeepsHelpers passed\n";
+}
+
+void testTransportPositionPublished() {
+    Engine engine(std::make_unique<NullAudioBackend>(48000, 480));
+    const bool started = engine.initialize("test");
+    assert(started);
+    auto& backend = static_cast<NullAudioBackend&>(engine.getAudioBackend());
+
+    engine.playTimeline();
+    backend.step(480 * 10);
+
+    // The last block published where it started
+    TransportPosition position = engine.getTransportPosition();
+    assert(position.rolling);
+    assert(position.frame == 480 * 9);
+    assert(position.blockFrames == 480);
+    assert(position.sampleRate == 48000);
+    assert(position.bpm == 120.0);
+    assert(std::abs(position.tick - 480.0 * 9 * 1920 / 48000) < 1e-9);
+
+    // Extrapolated at the block's tempo, held at its end (audio stalled)
+    const int64_t start = position.timestampNs;
+    assert(position.frameAt(start) == 480.0 * 9);
+    assert(position.frameAt(start + 5000000) == 480.0 * 9 + 240);  // 5 ms
+    assert(position.frameAt(start + 1000000000) == 480.0 * 10);
+    assert(std::abs(position.tickAt(start + 5000000) - (position.tick + 9.6)) < 1e-9);
+
+    // Output latency puts the heard position behind the rendered one
+    position.latencyFrames = 960;
+    assert(position.frameAt(start + 5000000) == 480.0 * 9 + 240 - 960);
+
+    // Stopped: no extrapolation
+    engine.stopPlayback();
+    backend.step(480);
+    position = engine.getTransportPosition();
+    assert(!position.rolling);
+    assert(position.tickAt(TransportPosition::nowNs() + 1000000000) == position.tick);
+
+    engine.shutdown();
+    std::cout << "✓ testTransportPositionPublished passed\n";
+}
+
+void testSeqLockIsTearFree() {
+    // Every field holds the same value, so a torn read shows as a mismatch
+    struct Wide {
+        uint64_t values[6];
+    };
+    SeqLock<Wide> lock;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]() {
+        Wide wide;
+        for (uint64_t i = 1; i <= 200000; ++i) {
+            std::fill(std::begin(wide.values), std::end(wide.values), i);
+            lock.store(wide);
+        }
+        done = true;
+    });
+
+    uint64_t last = 0;
+    int reads = 0;
+    while (!done.load() || reads == 0) {
+        const Wide wide = lock.load();
+        for (uint64_t value : wide.values) {
+            assert(value == wide.values[0]);
+        }
+        assert(wide.values[0] >= last);  // Never goes back in time
+        last = wide.values[0];
+        ++reads;
+    }
+    writer.join();
+    assert(lock.load().values[0] == 200000);
+    assert(lock.getVersion() == 200001);
+
+    std::cout << "✓ testSeqLockIsTearFree passed\n";
+}
+
+void testCommandsApplyAtBlockStart() {
+    Engine engine(std::make_unique<NullAudioBackend>(48000, 480));
+    const bool started = engine.initialize("test");
+    assert(started);
+    auto& backend = static_cast<NullAudioBackend&>(engine.getAudioBackend());
+    const auto& state = engine.getTransport().getState();
+
+    // Queued until the next block, then applied on its first frame
+    const CommandId play = engine.playFromTick(3840);
+    assert(play != 0);
+    assert(engine.isPlaying());
+    assert(!state.rolling);
+    assert(engine.getCompletedCommand() < play);
+
+    backend.step(480);
+    assert(engine.getCompletedCommand() == play);
+    assert(state.rolling);
+    assert(state.frame == 96000 + 480);  // Bar 2 at 120 BPM, plus the block
+
+    CommandAck ack;
+    bool acked = engine.pollAck(ack);
+    assert(acked);
+    assert(ack.id == play);
+    assert(ack.type == EngineCommandType::PlayTimeline);
+    assert(ack.rolling);
+    assert(ack.frame == 96000);
+    assert(ack.tick == 3840);
+    acked = engine.pollAck(ack);
+    assert(!acked);
+
+    // Several commands between two blocks: applied in order
+    const CommandId locate = engine.locate(0);
+    const CommandId stop = engine.stopPlayback();
+    assert(!engine.isPlaying());
+    backend.step(480);
+    assert(engine.getCompletedCommand() == stop);
+    assert(!state.rolling);
+    assert(state.frame == 0);
+    acked = engine.pollAck(ack);
+    assert(acked && ack.id == locate && ack.rolling && ack.frame == 0);
+    acked = engine.pollAck(ack);
+    assert(acked && ack.id == stop && !ack.rolling);
+
+    // Bounded: with no block running the queue fills up and rejects
+    size_t posted = 0;
+    while (posted < 1000 && engine.locate(0) != 0) {
+        ++posted;
+    }
+    assert(posted > 0 && posted < 1000);
+    backend.step(480);
+    const CommandId afterBlock = engine.locate(0);
+    assert(afterBlock != 0);
+
+    // No audio thread: applied right away
+    engine.shutdown();
+    const CommandId direct = engine.playFromTick(1920);
+    assert(engine.getCompletedCommand() == direct);
+    assert(state.rolling && state.tick == 1920);
+
+    engine.stopPlayback();
+    std::cout << "✓ testCommandsApplyAtBlockStart passed\n";
+}
+
+void testCommandsOnAudioThread() {
+    Engine engine(std::make_unique<NullAudioBackend>(48000, 256, NullClock::Thread));
+    const bool started = engine.initialize("test");
+    assert(started);
+
+    // The audio thread picks commands up within a few buffer periods
+    auto waitFor = [&engine](CommandId id) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (engine.getCompletedCommand() < id &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return engine.getCompletedCommand() >= id;
+    };
+
+    for (int i = 0; i < 10; ++i) {
+        const CommandId play = engine.playFromTick(i * 960);
+        const bool played = waitFor(play);
+        assert(played);
+        const CommandId stop = engine.stopPlayback();
+        const bool stopped = waitFor(stop);
+        assert(stopped);
+    }
+
+    CommandAck ack;
+    size_t acks = 0;
+    CommandId last = 0;
+    while (engine.pollAck(ack)) {
+        assert(ack.id > last);
+        last = ack.id;
+        ++acks;
+    }
+    assert(acks == 20);
+
+    engine.shutdown();
+    std::cout << "✓ testCommandsOnAudioThread passed\n";
+}
+
+void testFileBackend() {
+    const std::string path = "test_file_backend.wav";
+
+    // One impulse per block, at a different offset each time
+    FileAudioBackend backend(path, AudioFileFormat::WavFloat, 48000, 32);
+    uint32_t blockIndex = 0;
+    backend.setAudioCallback([&](uint32_t nframes, float* outL, float* outR) {
+        uint32_t at = blockIndex++ % nframes;
+        outL[at] = 0.5f;
+        outR[at] = -0.25f;
+    });
+    const bool started = backend.initialize("test");
+    assert(started);
+    backend.step(32 * 10);
+    backend.shutdown();
+    assert(!backend.hasWriteError());
+
+    SampleLibrary library;
+    auto sample = library.loadSample(path);
+    assert(sample != nullptr);
+    assert(sample->lengthFrames == 320);
+    for (uint32_t block = 0; block < 10; ++block) {
+        for (uint32_t i = 0; i < 32; ++i) {
+            bool impulse = (i == block);
+            assert(sample->dataLeft[block * 32 + i] == (impulse ? 0.5f : 0.0f));
+            assert(sample->dataRight[block * 32 + i] == (impulse ? -0.25f : 0.0f));
+        }
+    }
+    std::remove(path.c_str());
+
+    std::cout << "✓ testFileBackend passed\n";
+}
+
+int main() {
+    std::cout << "Running AudioBackend tests...\n";
+
+    testManualStep();
+    testThreadClock();
+    testEngineOnNullBackend();
+    testInitializeTwiceKeepsHelpers();
+    testTransportPositionPublished();
+    testSeqLockIsTearFree();
+    testCommandsApplyAtBlockStart();
+    testCommandsOnAudioThread();
+    testFileBackend();
+
+    std::cout << "\n✓ All AudioBackend tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "engine/Histogram.hpp"
+#include "engine/Engine.hpp"
+#include "engine/NullAudioBackend.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace beater;
+
+// Percentile within the histogram's bucket precision of the exact value
+static bool closeTo(uint64_t reported, uint64_t exact) {
+    const double tolerance = std::max(1.0, static_cast<double>(exact) / Histogram::SUB_BUCKETS);
+    return reported >= exact && static_cast<double>(reported - exact) <= tolerance;
+}
+
+void testHistogramSmallValuesAreExact() {
+    Histogram histogram;
+    assert(histogram.getCount() == 0);
+    assert(histogram.getPercentile(99.0) == 0);
+
+    for (uint64_t value = 0; value < 10; ++value) {
+        histogram.record(value);
+    }
+    assert(histogram.getCount() == 10);
+    assert(histogram.getMax() == 9);
+    assert(histogram.getMean() == 4.5);
+    assert(histogram.getPercentile(50.0) == 4);
+    assert(histogram.getPercentile(90.0) == 8);
+    assert(histogram.getPercentile(100.0) == 9);
+    assert(histogram.getPercentile(0.0) == 0);
+
+    std::cout << "✓ testHistogramSmallValuesAreExact passed\n";
+}
+
+void testHistogramPercentiles() {
+    // 1..100000 ns, uniformly: every percentile is known exactly
+    Histogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value) {
+        histogram.record(value);
+    }
+    assert(closeTo(histogram.getPercentile(50.0), 50000));
+    assert(closeTo(histogram.getPercentile(99.0), 99000));
+    assert(closeTo(histogram.getPercentile(99.9), 99900));
+    assert(histogram.getPercentile(100.0) == 100000);  // Capped at the max
+    assert(std::abs(histogram.getMean() - 50000.5) < 1e-6);
+
+    // A single outlier moves the max but not the p99
+    histogram.record(5000000000ULL);
+    assert(histogram.getMax() == 5000000000ULL);
+    assert(closeTo(histogram.getPercentile(99.0), 99000));
+
+    // Huge values are clamped instead of overflowing the table
+    histogram.record(~uint64_t(0));
+    assert(histogram.getMax() == Histogram::MAX_VALUE);
+
+    histogram.reset();
+    assert(histogram.getCount() == 0 && histogram.getMax() == 0);
+    assert(histogram.getPercentile(50.0) == 0);
+
+    std::cout << "✓ testHistogramPercentiles passed\n";
+}
+
+void testEngineRecordsCallbackStats() {
+    Engine engine(std::make_unique<NullAudioBackend>(48000, 256));
+    const bool started = engine.initialize("test");
+    assert(started);
+    auto& backend = static_cast<NullAudioBackend&>(engine.getAudioBackend());
+
+    // Voices to render: a long impulse triggered a few times
+    auto sample = std::make_shared<Sample>();
+    sample->dataLeft.assign(48000, 0.1f);
+    sample->dataRight = sample->dataLeft;
+    sample->lengthFrames = 48000;
+    engine.getSampleLibrary().addSample("dc", sample);
+    const SampleHandle handle = engine.getSampleLibrary().getHandle("dc");
+    for (int i = 0; i < 5; ++i) {
+        engine.triggerSample(handle);
+    }
+    engine.playTimeline();
+    backend.step(256 * 100);
+
+    EngineStats stats = engine.getStats();
+    assert(stats.blocks == 100);
+    assert(stats.callback.count == 100);
+    assert(stats.transport.count == 100 && stats.scheduling.count == 100 &&
+           stats.rendering.count == 100);
+    assert(stats.callback.maxUs > 0.0);
+    assert(stats.callback.p99Us <= stats.callback.maxUs);
+    assert(stats.callback.p50Us <= stats.callback.p99Us);
+    assert(stats.rendering.maxUs <= stats.callback.maxUs);
+    assert(stats.dspLoadMax > 0.0);
+    assert(stats.dspLoadP99 <= stats.dspLoadMax);
+    assert(stats.activeVoices == 5);
+    assert(stats.peakVoices == 5);
+    assert(stats.xruns == 0);
+
+    // Cleared from the next block on
+    engine.stopPlayback();
+    engine.resetStats();
+    backend.step(256);
+    stats = engine.getStats();
+    assert(stats.blocks == 1);
+    assert(stats.activeVoices == 0 && stats.peakVoices == 0);
+
+    engine.shutdown();
+    std::cout << "✓ testEngineRecordsCallbackStats passed\n";
+}
+
+int main() {
+    std::cout << "Running EngineStats tests...\n\n";
+
+    testHistogramSmallValuesAreExact();
+    testHistogramPercentiles();
+    testEngineRecordsCallbackStats();
+
+    std::cout << "\n✓ All EngineStats tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include "engine/Engine.hpp"
+#include "engine/NullAudioBackend.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace beater;
+
+// Golden-render regression test
+// Renders a fixed project through the engine on a manual-clock null backend
+// and compares it with a stored reference buffer (raw little-endian float32,
+// interleaved stereo). Any change in event timing, voice handling or mixing
+// shows up as a mismatch. The comparison aborts on failure rather than
+// asserting, so it also runs in release builds.
+//
+// After an intended change in output, regenerate the reference with
+//   BEATER_UPDATE_GOLDEN=1 ./test_golden_render
+
+#ifndef BEATER_GOLDEN_DIR
+#define BEATER_GOLDEN_DIR "golden"
+#endif
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 4000;   // Low rate keeps the reference small
+constexpr uint32_t BLOCK_SIZE = 64;
+constexpr float TOLERANCE = 1e-6f;
+
+// Backend that keeps everything it renders
+class CaptureBackend : public NullAudioBackend {
+public:
+    CaptureBackend() : NullAudioBackend(SAMPLE_RATE, BLOCK_SIZE) {}
+
+    std::vector<float> output;
+
+protected:
+    void deliver(const float* left, const float* right, uint32_t nframes) override {
+        for (uint32_t i = 0; i < nframes; ++i) {
+            output.push_back(left[i]);
+            output.push_back(right[i]);
+        }
+    }
+};
+
+// Decaying sawtooth-like hit; integer arithmetic so it is identical everywhere
+std::shared_ptr<Sample> makeHit(uint32_t period, uint32_t frames) {
+    auto sample = std::make_shared<Sample>();
+    for (uint32_t i = 0; i < frames; ++i) {
+        float decay = static_cast<float>(frames - i) / frames;
+        float saw = static_cast<float>(i % period) / period * 2.0f - 1.0f;
+        sample->dataLeft.push_back(decay * saw);
+        sample->dataRight.push_back(decay * saw * 0.75f);
+    }
+    sample->lengthFrames = frames;
+    return sample;
+}
+
+std::vector<float> renderGoldenProject() {
+    auto backend = std::make_unique<CaptureBackend>();
+    CaptureBackend& capture = *backend;
+    Engine engine(std::move(backend), 16);
+    const bool started = engine.initialize("golden");
+    assert(started);
+
+    SampleLibrary& library = engine.getSampleLibrary();
+    library.addSample("kick", makeHit(40, 1600));
+    library.addSample("snare", makeHit(7, 900));
+    library.addSample("hat-closed", makeHit(3, 200));
+    library.addSample("hat-open", makeHit(3, 1200));
+
+    Project& project = engine.getProject();
+    project.getTempoMap().setConstantTempo(200.0);
+    project.getTempoMap().addChange(1920, 150.0);  // Mid bar, mid block
+
+    InstrumentRack& rack = project.getInstrumentRack();
+    rack.addInstrument(Instrument(4, "Open Hat"));
+    rack.getInstrument(1)->setSamplePath("kick");
+    rack.getInstrument(2)->setSamplePath("snare");
+    rack.getInstrument(2)->setPan(-0.4f);
+    rack.getInstrument(2)->setGain(0.8f);
+    rack.getInstrument(3)->setSamplePath("hat-closed");
+    rack.getInstrument(3)->setChokeGroup(1);
+    rack.getInstrument(3)->setPan(0.5f);
+    rack.getInstrument(4)->setSamplePath("hat-open");
+    rack.getInstrument(4)->setChokeGroup(1);
+    rack.getInstrument(4)->setMaxPolyphony(1);
+    rack.getInstrument(4)->setPan(0.5f);
+
+    Pattern groove("groove", "Groove", 3840);
+    groove.addNote({1, 0, 1.0f});
+    groove.addNote({1, 1920 + 13, 0.7f});
+    groove.addNote({2, 960, 0.9f});
+    groove.addNote({2, 2880, 0.95f});
+    for (int i = 0; i < 8; ++i) {
+        groove.addNote({i % 4 == 3 ? 4 : 3, i * 480 + 5, 0.4f + 0.05f * i});  // Open hat choked
+    }
+    groove.addNote({4, 3600, 0.5f});  // Two open hats: polyphony limit of 1
+    groove.addNote({4, 3700, 0.6f});
+    project.getPatternLibrary().addPattern(groove);
+
+    Region region("r1", RegionType::Groove, 0, 3840);
+    region.setPatternId("groove");
+    project.getTrack(size_t(0))->addRegion(region);
+
+    engine.loadInstrumentSamples();
+    engine.playTimeline();
+
+    // The bar (0.6 s at 200 + 0.8 s at 150 BPM) plus ring-out
+    capture.step(SAMPLE_RATE * 3 / 2 + 400);
+
+    engine.shutdown();
+    return capture.output;
+}
+
+bool readGolden(const std::string& path, std::vector<float>& data) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    std::streamsize bytes = in.tellg();
+    in.seekg(0);
+    data.resize(static_cast<size_t>(bytes) / sizeof(float));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(data.data()),
+                                     static_cast<std::streamsize>(data.size() * sizeof(float))));
+}
+
+void writeGolden(const std::string& path, const std::vector<float>& data) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data.data()),
+              static_cast<std::streamsize>(data.size() * sizeof(float)));
+    if (!out.good()) {
+        std::cerr << "Failed to write golden file " << path << "\n";
+        std::abort();
+    }
+}
+
+} // namespace
+
+void testRenderIsRepeatable() {
+    const std::vector<float> first = renderGoldenProject();
+    const std::vector<float> second = renderGoldenProject();
+    if (first.empty() || first != second) {
+        std::cerr << "Golden project renders differently each time\n";
+        std::abort();
+    }
+
+    std::cout << "✓ testRenderIsRepeatable passed\n";
+}
+
+void testMatchesGolden() {
+    const std::string path = std::string(BEATER_GOLDEN_DIR) + "/groove.f32";
+    std::vector<float> rendered = renderGoldenProject();
+
+    if (std::getenv("BEATER_UPDATE_GOLDEN") != nullptr) {
+        writeGolden(path, rendered);
+        std::cout << "  (wrote " << path << ")\n";
+    }
+
+    std::vector<float> golden;
+    if (!readGolden(path, golden)) {
+        std::cerr << "Missing golden file " << path << "\n";
+        std::abort();
+    }
+    if (rendered.size() != golden.size()) {
+        std::cerr << "Golden length mismatch: rendered " << rendered.size() / 2
+                  << " frames, expected " << golden.size() / 2 << "\n";
+        std::abort();
+    }
+
+    for (size_t i = 0; i < golden.size(); ++i) {
+        if (std::fabs(rendered[i] - golden[i]) > TOLERANCE) {
+            std::cerr << "Golden mismatch at frame " << i / 2 << (i % 2 ? " (R)" : " (L)")
+                      << ": got " << rendered[i] << ", expected " << golden[i] << "\n";
+            std::abort();
+        }
+    }
+
+    std::cout << "✓ testMatchesGolden passed\n";
+}
+
+int main() {
+    std::cout << "Running GoldenRender tests...\n";
+
+    testRenderIsRepeatable();
+    testMatchesGolden();
+
+    std::cout << "\n✓ All GoldenRender tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "domain/MeterMap.hpp"
+#include "domain/TempoMap.hpp"
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+using namespace beater;
+
+// Linear walks over the change list: the reference answers
+static const MeterChange* changeAt(const MeterMap& map, Tick tick) {
+    const MeterChange* found = nullptr;
+    for (const auto& change : map.getChanges()) {
+        if (change.atTick <= tick) {
+            found = &change;
+        }
+    }
+    return found;
+}
+
+static int scanBarIndex(const MeterMap& map, Tick tick) {
+    const auto& changes = map.getChanges();
+    int bars = 0;
+    for (size_t i = 0; i < changes.size() && changes[i].atTick <= tick; ++i) {
+        Tick end = i + 1 < changes.size() ? std::min(changes[i + 1].atTick, tick) : tick;
+        bars += static_cast<int>((end - changes[i].atTick) / TimeUtils::ticksPerBar(changes[i].signature));
+    }
+    return bars;
+}
+
+void testConstantMeter() {
+    MeterMap map;
+    assert(map.getSignatureAt(10000) == (TimeSignature{4, 4}));
+    assert(map.getBarStartAt(3839) == 0);
+    assert(map.getBarStartAt(3840) == 3840);
+    assert(map.getBarIndexAt(3840 * 5 + 10) == 5);
+
+    std::cout << "✓ testConstantMeter passed\n";
+}
+
+void testMeterChanges() {
+    // Two bars of 4/4, three of 3/4, then 6/8
+    MeterMap map;
+    map.addChange(3840 * 2, {3, 4});
+    map.addChange(3840 * 2 + 2880 * 3, {6, 8});
+
+    assert(map.getSignatureAt(3840 * 2 - 1) == (TimeSignature{4, 4}));
+    assert(map.getSignatureAt(3840 * 2) == (TimeSignature{3, 4}));
+    assert(map.getBarIndexAt(3840 * 2 + 2880) == 3);
+    assert(map.getBarStartAt(3840 * 2 + 2880 + 100) == 3840 * 2 + 2880);
+    assert(map.getBarIndexAt(3840 * 2 + 2880 * 3) == 5);
+
+    // Removing a change re-indexes everything after it
+    map.removeChangeAt(3840 * 2);
+    assert(map.getBarIndexAt(3840 * 2 + 2880 * 3) == (3840 * 2 + 2880 * 3) / 3840);
+
+    std::cout << "✓ testMeterChanges passed\n";
+}
+
+void testIndexMatchesScan() {
+    uint32_t seed = 777;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<Tick>((seed >> 8) % range);
+    };
+    const TimeSignature signatures[] = {{4, 4}, {3, 4}, {6, 8}, {7, 8}, {5, 4}, {2, 2}};
+
+    for (int round = 0; round < 50; ++round) {
+        MeterMap map;
+        for (Tick changes = next(8); changes > 0; --changes) {
+            map.addChange(next(100) * 480, signatures[next(6)]);
+        }
+
+        for (int probe = 0; probe < 200; ++probe) {
+            Tick tick = next(60000);
+            const MeterChange* change = changeAt(map, tick);
+            assert(change != nullptr);
+            Tick barLength = TimeUtils::ticksPerBar(change->signature);
+
+            assert(map.getSignatureAt(tick) == change->signature);
+            assert(map.getBarStartAt(tick) ==
+                   change->atTick + ((tick - change->atTick) / barLength) * barLength);
+            assert(map.getBarIndexAt(tick) == scanBarIndex(map, tick));
+        }
+    }
+
+    std::cout << "✓ testIndexMatchesScan passed\n";
+}
+
+void testGridLines() {
+    MeterMap map;
+    map.addChange(3840, {6, 8});
+    std::vector<GridLine> lines;
+
+    // One 4/4 bar (4 beats), then 6/8 bars of six eighth-note beats
+    map.getGridLines(0, 3840 + 2880, lines);
+    assert(lines.size() == 4 + 6);
+    assert(lines[0].tick == 0 && lines[0].isBar() && lines[0].bar == 0);
+    assert(lines[1].tick == 960 && lines[1].beat == 1);
+    assert(lines[4].tick == 3840 && lines[4].isBar() && lines[4].bar == 1);
+    assert(lines[5].tick == 3840 + 480 && lines[5].beat == 1);
+
+    // Every line agrees with the point queries; windows start mid-bar
+    map.getGridLines(1000, 20000, lines);
+    assert(lines.front().tick == 1920);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        assert(lines[i].tick >= 1000 && lines[i].tick < 20000);
+        assert(i == 0 || lines[i - 1].tick < lines[i].tick);
+        assert(map.getBarIndexAt(lines[i].tick) == lines[i].bar);
+        assert(lines[i].isBar() == (map.getBarStartAt(lines[i].tick) == lines[i].tick));
+    }
+
+    map.getGridLines(500, 500, lines);
+    assert(lines.empty());
+
+    std::cout << "✓ testGridLines passed\n";
+}
+
+void testTempoMapLookup() {
+    TempoMap map(100.0);
+    map.addChange(1920, 140.0);
+    map.addChange(960, 90.0);
+    assert(map.getBpmAt(-5) == 100.0);
+    assert(map.getBpmAt(959) == 100.0);
+    assert(map.getBpmAt(960) == 90.0);
+    assert(map.getBpmAt(1919) == 90.0);
+    assert(map.getBpmAt(1000000) == 140.0);
+
+    std::cout << "✓ testTempoMapLookup passed\n";
+}
+
+int main() {
+    std::cout << "Running MeterMap tests...\n";
+
+    testConstantMeter();
+    testMeterChanges();
+    testIndexMatchesScan();
+    testGridLines();
+    testTempoMapLookup();
+
+    std::cout << "\n✓ All MeterMap tests passed!\n";
+    return 0;
+}
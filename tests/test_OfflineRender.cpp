@@ -0,0 +1,191 @@
+#include "engine/OfflineRenderer.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace beater;
+
+// Decaying tone so overlapping voices and ring-out are both exercised
+static std::shared_ptr<Sample> makeHit(float pitch, size_t frames) {
+    auto sample = std::make_shared<Sample>();
+    for (size_t i = 0; i < frames; ++i) {
+        float decay = 1.0f - static_cast<float>(i) / frames;
+        float value = decay * ((i * static_cast<size_t>(pitch)) % 100 / 50.0f - 1.0f);
+        sample->dataLeft.push_back(value);
+        sample->dataRight.push_back(value * 0.5f);
+    }
+    sample->lengthFrames = frames;
+    return sample;
+}
+
+// Two bars of a simple groove with a tempo change halfway
+static void buildProject(Engine& engine) {
+    engine.getSampleLibrary().addSample("kick", makeHit(3.0f, 12000));
+    engine.getSampleLibrary().addSample("hat", makeHit(41.0f, 3000));
+
+    Project& project = engine.getProject();
+    project.getTempoMap().addChange(3840, 97.0);
+    project.getInstrumentRack().getInstrument(1)->setSamplePath("kick");
+    project.getInstrumentRack().getInstrument(3)->setSamplePath("hat");
+
+    Pattern groove("groove", "Groove", 3840);
+    groove.addNote({1, 0, 1.0f});
+    groove.addNote({1, 1920, 0.9f});
+    groove.addNote({1, 3800, 0.8f});  // Rings past the end of the region
+    for (int i = 0; i < 8; ++i) {
+        groove.addNote({3, i * 480 + 7, 0.6f});
+    }
+    project.getPatternLibrary().addPattern(groove);
+
+    Region region("r1", RegionType::Groove, 0, 3840 * 2);
+    region.setPatternId("groove");
+    project.getTrack(size_t(0))->addRegion(region);
+
+    engine.loadInstrumentSamples();
+}
+
+static std::vector<float> renderToMemory(Engine& engine, const OfflineRenderOptions& options,
+                                         OfflineRenderStats* stats = nullptr) {
+    OfflineRenderer renderer(engine);
+    std::vector<float> out;
+    bool ok = renderer.render(options, [&](const float* left, const float* right, uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i) {
+            out.push_back(left[i]);
+            out.push_back(right[i]);
+        }
+        return true;
+    });
+    assert(ok);
+    if (stats != nullptr) {
+        *stats = renderer.getStats();
+    }
+    return out;
+}
+
+void testRenderLength() {
+    Engine engine;
+    buildProject(engine);
+
+    OfflineRenderOptions options;
+    options.sampleRate = 44100;
+    options.tailSeconds = 0.0;
+    OfflineRenderStats stats;
+    std::vector<float> out = renderToMemory(engine, options, &stats);
+
+    // Exactly the region span under the tempo map
+    TempoTimeline tempo(engine.getProject().getTempoMap(), 44100);
+    assert(stats.frames == tempo.tickToFrame(3840 * 2));
+    assert(out.size() == stats.frames * 2);
+    assert(out[0] != 0.0f);  // Kick on tick 0
+
+    // With a tail the last kick rings out, and rendering stops once silent
+    options.tailSeconds = 5.0;
+    renderToMemory(engine, options, &stats);
+    assert(stats.frames > tempo.tickToFrame(3840 * 2));
+    assert(stats.frames < tempo.tickToFrame(3840 * 2) + 12000 + options.blockSize);
+
+    std::cout << "✓ testRenderLength passed\n";
+}
+
+void testRenderIsRepeatable() {
+    OfflineRenderOptions options;
+    options.blockSize = 100;
+
+    Engine first;
+    buildProject(first);
+    std::vector<float> a = renderToMemory(first, options);
+    std::vector<float> b = renderToMemory(first, options);
+
+    Engine second;
+    buildProject(second);
+    std::vector<float> c = renderToMemory(second, options);
+
+    assert(!a.empty());
+    assert(a == b);
+    assert(a == c);
+
+    // Block size only changes how the work is cut up (the tail included)
+    options.blockSize = 1024;
+    std::vector<float> d = renderToMemory(second, options);
+    assert(a == d);
+
+    std::cout << "✓ testRenderIsRepeatable passed\n";
+}
+
+void testRenderRange() {
+    Engine engine;
+    buildProject(engine);
+
+    OfflineRenderOptions options;
+    options.startTick = 3840;
+    options.endTick = 3840 + 960;
+    options.tailSeconds = 0.0;
+    OfflineRenderStats stats;
+    renderToMemory(engine, options, &stats);
+
+    // One beat at 97 BPM
+    TempoTimeline tempo(engine.getProject().getTempoMap(), 48000);
+    assert(stats.frames == tempo.tickToFrame(3840 + 960) - tempo.tickToFrame(3840));
+
+    // Empty range is an error, not an empty file
+    options.endTick = options.startTick;
+    OfflineRenderer renderer(engine);
+    const bool rendered = renderer.render(options, [](const float*, const float*, uint32_t) { return true; });
+    assert(!rendered);
+    assert(!renderer.getError().empty());
+
+    std::cout << "✓ testRenderRange passed\n";
+}
+
+void testMissingSampleLeavesOthersLoaded() {
+    // A real file for the last instrument, none for the first
+    const std::string hatPath = "test_offline_hat.wav";
+    auto hat = makeHit(41.0f, 3000);
+    AudioFileWriter writer;
+    const bool opened = writer.open(hatPath, 48000, AudioFileFormat::WavFloat);
+    assert(opened);
+    const bool written = writer.write(hat->dataLeft.data(), hat->dataRight.data(), 3000);
+    assert(written);
+    writer.close();
+
+    Engine engine;
+    Project& project = engine.getProject();
+    project.getInstrumentRack().getInstrument(1)->setSamplePath("missing_kick.wav");
+    project.getInstrumentRack().getInstrument(3)->setSamplePath(hatPath);
+
+    // Reported as a failure, but the instruments after it still load
+    const bool allLoaded = engine.loadInstrumentSamples();
+    assert(!allLoaded);
+    assert(engine.getSampleLibrary().getHandle(hatPath) != INVALID_SAMPLE_HANDLE);
+    assert(engine.getSampleLibrary().getHandle("missing_kick.wav") == INVALID_SAMPLE_HANDLE);
+
+    std::remove(hatPath.c_str());
+    std::cout << "✓ testMissingSampleLeavesOthersLoaded passed\n";
+}
+
+void testFormatForPath() {
+    AudioFileFormat format;
+    assert(AudioFileWriter::formatForPath("mix.wav", 24, format) && format == AudioFileFormat::Wav24);
+    assert(AudioFileWriter::formatForPath("mix.WAV", 32, format) && format == AudioFileFormat::WavFloat);
+    assert(AudioFileWriter::formatForPath("stem.flac", 16, format) && format == AudioFileFormat::Flac16);
+    assert(!AudioFileWriter::formatForPath("stem.flac", 32, format));
+    assert(!AudioFileWriter::formatForPath("mix.mp3", 24, format));
+    assert(!AudioFileWriter::formatForPath("mix", 24, format));
+
+    std::cout << "✓ testFormatForPath passed\n";
+}
+
+int main() {
+    std::cout << "Running OfflineRender tests...\n";
+
+    testRenderLength();
+    testRenderIsRepeatable();
+    testRenderRange();
+    testMissingSampleLeavesOthersLoaded();
+    testFormatForPath();
+
+    std::cout << "\n✓ All OfflineRender tests passed!\n";
+    return 0;
+}
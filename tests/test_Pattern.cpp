@@ -82,11 +82,47 @@ void testPatternLibrary() {
     std::cout << "✓ testPatternLibrary passed\n";
 }
 
+void testAddNotesBatch() {
+    Pattern pattern("test", "Test", 3840);
+    pattern.addNote({1, 960, 0.5f});
+    pattern.addNote({1, 2880, 0.5f});
+    
+    // Unsorted batch, with ticks equal to existing notes and to each other
+    pattern.addNotes({{2, 2880, 0.1f}, {3, 0, 0.2f}, {2, 960, 0.3f}, {4, 960, 0.4f}});
+    
+    const auto& notes = pattern.getNotes();
+    assert(notes.size() == 6);
+    for (size_t i = 1; i < notes.size(); ++i) {
+        assert(notes[i - 1].offsetTick <= notes[i].offsetTick);
+    }
+    
+    // Equal ticks keep insertion order: existing notes first, then the batch
+    assert(notes[0].instrumentId == 3);
+    assert(notes[1].instrumentId == 1 && notes[1].offsetTick == 960);
+    assert(notes[2].instrumentId == 2 && notes[2].offsetTick == 960);
+    assert(notes[3].instrumentId == 4);
+    assert(notes[4].instrumentId == 1 && notes[4].offsetTick == 2880);
+    assert(notes[5].instrumentId == 2 && notes[5].offsetTick == 2880);
+    
+    // Same result as adding one at a time
+    Pattern single("single", "Single", 3840);
+    single.addNote({1, 960, 0.5f});
+    single.addNote({1, 2880, 0.5f});
+    single.addNote({2, 2880, 0.1f});
+    single.addNote({3, 0, 0.2f});
+    single.addNote({2, 960, 0.3f});
+    single.addNote({4, 960, 0.4f});
+    assert(single.getNotes() == notes);
+    
+    std::cout << "✓ testAddNotesBatch passed\n";
+}
+
 int main() {
     std::cout << "Running Pattern tests...\n";
     
     testPatternCreation();
     testAddNotes();
+    testAddNotesBatch();
     testGetNotesAt();
     testPatternLibrary();
     
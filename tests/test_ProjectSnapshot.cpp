@@ -0,0 +1,151 @@
+#include "engine/ProjectSnapshot.hpp"
+#include <iostream>
+#include <cassert>
+#include <vector>
+
+using namespace beater;
+
+void testSnapshotIsIsolated() {
+    Project working;
+    Pattern groove("groove", "Groove", 3840);
+    groove.addNote({1, 0, 0.9f});
+    working.getPatternLibrary().addPattern(groove);
+
+    Region region("r1", RegionType::Groove, 0, 3840 * 2);
+    region.setPatternId("groove");
+    working.getTrack(size_t(0))->addRegion(region);
+
+    ProjectSnapshot compiledSnapshot(working);
+    assert(compiledSnapshot.timeline.size() == 2);
+
+    EventTimeline compiled;
+    compiled.compile(working);
+    std::vector<Change> changes;
+    working.drainChanges(changes);
+    ProjectSnapshot snapshot(compiled, working.getRevision());
+    assert(snapshot.timeline.size() == 2);
+
+    // Editing the working copy (and patching its timeline) must not touch
+    // the published snapshot
+    working.getTrack(size_t(0))->clearRegions();
+    changes.clear();
+    working.drainChanges(changes);
+    compiled.update(working, changes);
+    assert(compiled.empty());
+    assert(snapshot.timeline.size() == 2);
+    assert(snapshot.timeline.getEvents()[1].tick == 3840);
+    assert(compiledSnapshot.timeline.size() == 2);
+
+    std::cout << "✓ testSnapshotIsIsolated passed\n";
+}
+
+void testSnapshotsShareUnchangedChunks() {
+    // Forty bars of groove on one track, a one-bar fill on another
+    Project working;
+    Pattern groove("groove", "Groove", 3840);
+    groove.addNote({1, 0, 0.9f});
+    groove.addNote({2, 1920, 0.8f});
+    working.getPatternLibrary().addPattern(groove);
+    Region grooveRegion("r1", RegionType::Groove, 0, 3840 * 40);
+    grooveRegion.setPatternId("groove");
+    working.getTrack(size_t(0))->addRegion(grooveRegion);
+    Track fills("track_1", "Fills");
+    Region fill("r2", RegionType::Fill, 3840 * 21, 3840);
+    fill.setPatternId("groove");
+    fills.addRegion(fill);
+    working.addTrack(fills);
+
+    EventTimeline compiled;
+    compiled.compile(working);
+    std::vector<Change> changes;
+    working.drainChanges(changes);
+    ProjectSnapshot before(compiled, working.getRevision());
+    const size_t chunks = before.timeline.getChunkCount();
+    assert(chunks == 10);
+
+    // Move the fill by a bar, within its chunk
+    working.getTrack(size_t(1))->setRegionBounds(0, 3840 * 22, 3840);
+    changes.clear();
+    working.drainChanges(changes);
+    compiled.update(working, changes);
+    ProjectSnapshot after(compiled, working.getRevision());
+
+    // Only the edited chunk was rebuilt; the rest are the same storage
+    const size_t edited = static_cast<size_t>(3840 * 21 / EventTimeline::CHUNK_TICKS);
+    assert(after.timeline.getChunkCount() == chunks);
+    for (size_t i = 0; i < chunks; ++i) {
+        const bool shared = after.timeline.getChunk(i) == before.timeline.getChunk(i);
+        assert(shared == (i != edited));
+    }
+
+    // ...and the patched timeline still matches a full compile
+    EventTimeline fresh;
+    fresh.compile(working);
+    const std::vector<CompiledEvent> expected = fresh.getEvents();
+    const std::vector<CompiledEvent> actual = after.timeline.getEvents();
+    assert(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        assert(actual[i].tick == expected[i].tick &&
+               actual[i].instrumentId == expected[i].instrumentId);
+    }
+
+    std::cout << "✓ testSnapshotsShareUnchangedChunks passed\n";
+}
+
+void testExchangeAdoptsNewest() {
+    SnapshotExchange exchange;
+    assert(exchange.acquire() == nullptr);
+
+    Project project;
+    exchange.publish(std::make_unique<ProjectSnapshot>(project));
+    const ProjectSnapshot* first = exchange.acquire();
+    assert(first != nullptr && first->revision == 0);
+
+    // Nothing new published: keep using the same snapshot
+    assert(exchange.acquire() == first);
+
+    // Two publishes before the next block: only the newest is adopted
+    project.incrementRevision();
+    exchange.publish(std::make_unique<ProjectSnapshot>(project));
+    project.incrementRevision();
+    exchange.publish(std::make_unique<ProjectSnapshot>(project));
+    const ProjectSnapshot* third = exchange.acquire();
+    assert(third != first && third->revision == 2);
+    assert(exchange.current() == third);
+
+    // The replaced snapshot is freed by the publishing side
+    exchange.collect();
+    assert(exchange.acquire() == third);
+
+    std::cout << "✓ testExchangeAdoptsNewest passed\n";
+}
+
+void testExchangeManyPublishes() {
+    SnapshotExchange exchange;
+
+    // Publish once per block for a while; each block sees the newest snapshot
+    const ProjectSnapshot* last = nullptr;
+    Project project;
+    for (uint64_t i = 0; i < 40; ++i) {
+        exchange.publish(std::make_unique<ProjectSnapshot>(project));
+        const ProjectSnapshot* current = exchange.acquire();
+        assert(current != nullptr && current != last);
+        assert(current->revision == i);
+        project.incrementRevision();
+        last = current;
+    }
+
+    std::cout << "✓ testExchangeManyPublishes passed\n";
+}
+
+int main() {
+    std::cout << "Running ProjectSnapshot tests...\n";
+
+    testSnapshotIsIsolated();
+    testSnapshotsShareUnchangedChunks();
+    testExchangeAdoptsNewest();
+    testExchangeManyPublishes();
+
+    std::cout << "\n✓ All ProjectSnapshot tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "RtSafetyChecker.hpp"
+#include "engine/Engine.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+using namespace beater;
+
+// Decaying tone long enough to keep many voices overlapping
+static std::shared_ptr<Sample> makeTone(size_t frames, float frequency) {
+    auto sample = std::make_shared<Sample>();
+    sample->dataLeft.resize(frames);
+    sample->dataRight.resize(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        float envelope = 1.0f - static_cast<float>(i) / frames;
+        float phase = static_cast<float>(i) * frequency / 48000.0f;
+        float value = envelope * ((phase - static_cast<int>(phase)) * 2.0f - 1.0f);
+        sample->dataLeft[i] = value;
+        sample->dataRight[i] = value;
+    }
+    sample->lengthFrames = frames;
+    return sample;
+}
+
+// Dense arrangement over every default instrument
+static void setUpProject(Engine& engine) {
+    Project& project = engine.getProject();
+    for (int id = 1; id <= 3; ++id) {
+        std::string key = "tone" + std::to_string(id);
+        engine.getSampleLibrary().addSample(key, makeTone(6000, 110.0f * id));
+        project.getInstrumentRack().getInstrument(id)->setSamplePath(key);
+    }
+
+    Pattern busy("busy", "Busy", 3840);
+    for (int step = 0; step < 32; ++step) {
+        busy.addNote({1 + step % 3, step * 120, 0.7f});
+    }
+    project.getPatternLibrary().addPattern(busy);
+
+    Region region("r1", RegionType::Groove, 0, 3840 * 8);
+    region.setPatternId("busy");
+    project.getTrack(size_t(0))->addRegion(region);
+
+    engine.loadInstrumentSamples();
+}
+
+// Render blocks with the checker armed around each callback only
+static rtcheck::Violations renderChecked(Engine& engine, int blocks, uint32_t blockSize) {
+    std::vector<float> outL(blockSize), outR(blockSize);
+    rtcheck::resetViolations();
+    for (int i = 0; i < blocks; ++i) {
+        std::fill(outL.begin(), outL.end(), 0.0f);
+        std::fill(outR.begin(), outR.end(), 0.0f);
+        rtcheck::RtSafetyScope scope;
+        engine.audioCallback(blockSize, outL.data(), outR.data());
+    }
+    return rtcheck::violations();
+}
+
+void testCheckerDetectsViolations() {
+    // Call through volatile pointers so the compiler cannot elide anything
+    void* (*volatile allocate)(size_t) = std::malloc;
+    void (*volatile release)(void*) = std::free;
+    std::mutex mutex;
+
+    rtcheck::resetViolations();
+    {
+        rtcheck::RtSafetyScope scope;
+        void* ptr = allocate(64);
+        release(ptr);
+        mutex.lock();
+        mutex.unlock();
+    }
+    rtcheck::Violations v = rtcheck::violations();
+    assert(v.allocations == 1);
+    assert(v.frees == 1);
+    assert(v.locks == 1);
+
+    // Disarmed again outside the scope
+    rtcheck::resetViolations();
+    release(allocate(64));
+    assert(rtcheck::violations().total() == 0);
+
+    std::cout << "✓ testCheckerDetectsViolations passed\n";
+}
+
+void testTimelinePlaybackIsRtSafe() {
+    Engine engine;
+    setUpProject(engine);
+    engine.playTimeline();
+
+    rtcheck::Violations v = renderChecked(engine, 400, 64);
+    assert(v.total() == 0);
+    assert(engine.getSampler().getActiveVoiceCount() > 0);
+
+    engine.stopPlayback();
+
+    std::cout << "✓ testTimelinePlaybackIsRtSafe passed\n";
+}
+
+void testPublishDuringPlaybackIsRtSafe() {
+    Engine engine;
+    setUpProject(engine);
+    engine.playTimeline();
+
+    for (int edit = 0; edit < 5; ++edit) {
+        // Edit and publish between blocks, as the UI would
+        Track* track = engine.getProject().getTrack(size_t(0));
+        Region extra("extra" + std::to_string(edit), RegionType::Fill,
+                     3840 * (8 + edit), 3840);
+        extra.setPatternId("busy");
+        track->addRegion(extra);
+        engine.publishProject();
+
+        rtcheck::Violations v = renderChecked(engine, 50, 128);
+        assert(v.total() == 0);
+    }
+
+    engine.stopPlayback();
+
+    std::cout << "✓ testPublishDuringPlaybackIsRtSafe passed\n";
+}
+
+void testPatternPlaybackIsRtSafe() {
+    Engine engine;
+    setUpProject(engine);
+    const Pattern* pattern = engine.getProject().getPatternLibrary().getPattern("busy");
+    engine.playPattern(pattern);
+
+    rtcheck::Violations v = renderChecked(engine, 400, 64);
+    assert(v.total() == 0);
+
+    engine.stopPlayback();
+
+    std::cout << "✓ testPatternPlaybackIsRtSafe passed\n";
+}
+
+int main() {
+    std::cout << "Running RT-safety tests...\n";
+
+    testCheckerDetectsViolations();
+    testTimelinePlaybackIsRtSafe();
+    testPublishDuringPlaybackIsRtSafe();
+    testPatternPlaybackIsRtSafe();
+
+    std::cout << "\n✓ All RT-safety tests passed!\n";
+    return 0;
+}
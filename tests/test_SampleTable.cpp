@@ -0,0 +1,184 @@
+#include "engine/SampleTable.hpp"
+#include "engine/SampleLibrary.hpp"
+#include "engine/Sampler.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace beater;
+
+// Sample whose every frame holds the same value
+static std::shared_ptr<Sample> makeFilled(float value, size_t frames = 256) {
+    auto sample = std::make_shared<Sample>();
+    sample->dataLeft.assign(frames, value);
+    sample->dataRight.assign(frames, value);
+    sample->lengthFrames = frames;
+    return sample;
+}
+
+void testAddResolveRemove() {
+    SampleTable table(8);
+    auto sample = makeFilled(1.0f);
+
+    SampleHandle handle = table.add(sample);
+    assert(handle != INVALID_SAMPLE_HANDLE);
+    assert(table.resolve(handle) == sample.get());
+    assert(table.resolve(INVALID_SAMPLE_HANDLE) == nullptr);
+
+    table.remove(handle);
+    assert(table.resolve(handle) == nullptr);
+
+    // Reusing the slot produces a different handle; the old one stays stale
+    SampleHandle reused = table.add(makeFilled(2.0f));
+    assert(reused != handle);
+    assert(table.resolve(handle) == nullptr);
+    assert(table.resolve(reused)->dataLeft[0] == 2.0f);
+
+    std::cout << "✓ testAddResolveRemove passed\n";
+}
+
+void testTableFull() {
+    SampleTable table(2);
+    const SampleHandle first = table.add(makeFilled(1.0f));
+    const SampleHandle second = table.add(makeFilled(2.0f));
+    const SampleHandle third = table.add(makeFilled(3.0f));
+    assert(first != INVALID_SAMPLE_HANDLE);
+    assert(second != INVALID_SAMPLE_HANDLE);
+    assert(third == INVALID_SAMPLE_HANDLE);
+
+    std::cout << "✓ testTableFull passed\n";
+}
+
+void testReclaimWaitsForReader() {
+    SampleTable table;
+    std::weak_ptr<Sample> watch;
+    SampleHandle handle;
+    {
+        auto sample = makeFilled(1.0f);
+        watch = sample;
+        handle = table.add(sample);
+    }
+
+    // Audio thread is mid-block holding the resolved pointer
+    table.beginRead();
+    const Sample* inUse = table.resolve(handle);
+    assert(inUse != nullptr);
+
+    table.remove(handle);
+    table.collect();
+    assert(!watch.expired());
+    assert(table.getRetiredCount() == 1);
+    assert(inUse->dataLeft[0] == 1.0f);
+
+    // Block ends: now it may go
+    table.endRead();
+    table.collect();
+    assert(watch.expired());
+    assert(table.getRetiredCount() == 0);
+
+    std::cout << "✓ testReclaimWaitsForReader passed\n";
+}
+
+void testReaderAfterRemoveDoesNotBlockReclaim() {
+    SampleTable table;
+    std::weak_ptr<Sample> watch;
+    SampleHandle handle;
+    {
+        auto sample = makeFilled(1.0f);
+        watch = sample;
+        handle = table.add(sample);
+    }
+    table.remove(handle);
+
+    // A block that started after the removal cannot see the old pointer
+    table.beginRead();
+    assert(table.resolve(handle) == nullptr);
+    table.collect();
+    assert(watch.expired());
+    table.endRead();
+
+    std::cout << "✓ testReaderAfterRemoveDoesNotBlockReclaim passed\n";
+}
+
+void testUnloadWhilePlaying() {
+    SampleLibrary library;
+    Sampler sampler(library.getTable());
+    std::weak_ptr<Sample> watch;
+    {
+        auto sample = makeFilled(0.5f, 10000);
+        watch = sample;
+        library.addSample("tom", sample);
+    }
+
+    std::vector<float> outL(64, 0.0f), outR(64, 0.0f);
+    sampler.noteOn(library.getHandle("tom"), 1.0f, 1.0f, 0.0f);
+    sampler.render(outL.data(), outR.data(), 64);
+    assert(outL[63] == 0.5f);
+
+    // Unload from the UI side between blocks; the voice ends cleanly
+    library.unloadSample("tom");
+    library.collect();
+    assert(watch.expired());
+
+    std::fill(outL.begin(), outL.end(), 0.0f);
+    sampler.render(outL.data(), outR.data(), 64);
+    assert(outL[0] == 0.0f);
+    assert(sampler.getActiveVoiceCount() == 0);
+
+    std::cout << "✓ testUnloadWhilePlaying passed\n";
+}
+
+void testConcurrentSwap() {
+    SampleTable table(16);
+    std::atomic<SampleHandle> current{table.add(makeFilled(1.0f))};
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+
+    // Simulated audio thread: resolve and read whole buffers every "block"
+    std::thread audio([&]() {
+        while (!done.load()) {
+            SampleTable::ReadScope scope(table);
+            const Sample* sample = table.resolve(current.load());
+            if (sample != nullptr) {
+                const float first = sample->dataLeft.front();
+                for (float value : sample->dataLeft) {
+                    if (value != first) {
+                        mismatches.fetch_add(1);
+                        break;
+                    }
+                }
+            }
+        }
+    });
+
+    // Loader thread: keep swapping the sample out from under it
+    for (int i = 0; i < 2000; ++i) {
+        SampleHandle next = table.add(makeFilled(static_cast<float>(i)));
+        SampleHandle previous = current.exchange(next);
+        table.remove(previous);
+    }
+    done = true;
+    audio.join();
+    table.collect();
+
+    assert(mismatches.load() == 0);
+    assert(table.getRetiredCount() == 0);
+
+    std::cout << "✓ testConcurrentSwap passed\n";
+}
+
+int main() {
+    std::cout << "Running SampleTable tests...\n";
+
+    testAddResolveRemove();
+    testTableFull();
+    testReclaimWaitsForReader();
+    testReaderAfterRemoveDoesNotBlockReclaim();
+    testUnloadWhilePlaying();
+    testConcurrentSwap();
+
+    std::cout << "\n✓ All SampleTable tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,545 @@
+#include "engine/Sampler.hpp"
+#include "engine/Engine.hpp"
+#include "engine/MixKernels.hpp"
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <thread>
+
+using namespace beater;
+
+// Table the standalone sampler tests play their samples from
+static SampleTable samples;
+
+// Short decaying click: easy to spot the exact onset frame
+static SampleHandle makeClick() {
+    auto sample = std::make_shared<Sample>();
+    sample->dataLeft = {1.0f, 0.5f, 0.25f, 0.125f};
+    sample->dataRight = sample->dataLeft;
+    sample->lengthFrames = sample->dataLeft.size();
+    sample->channels = 1;
+    return samples.add(sample);
+}
+
+// Constant-level sample: voice contributions are easy to tell apart in the mix
+static SampleHandle makeDC(float level, size_t frames = 10000) {
+    auto sample = std::make_shared<Sample>();
+    sample->dataLeft.assign(frames, level);
+    sample->dataRight = sample->dataLeft;
+    sample->lengthFrames = frames;
+    sample->channels = 1;
+    return samples.add(sample);
+}
+
+// Render one 64-frame block into fresh buffers
+static std::vector<float> renderBlock(Sampler& sampler) {
+    std::vector<float> outL(64, 0.0f), outR(64, 0.0f);
+    sampler.render(outL.data(), outR.data(), 64);
+    return outL;
+}
+
+void testNoteOnOffset() {
+    Sampler sampler(samples);
+    auto click = makeClick();
+
+    std::vector<float> outL(64, 0.0f), outR(64, 0.0f);
+    sampler.noteOn(click, 1.0f, 1.0f, 0.0f, 37);
+    sampler.render(outL.data(), outR.data(), 64);
+
+    for (uint32_t i = 0; i < 37; ++i) {
+        assert(outL[i] == 0.0f && outR[i] == 0.0f);
+    }
+    assert(outL[37] == 1.0f && outR[37] == 1.0f);
+    assert(outL[38] == 0.5f);
+    assert(outL[40] == 0.125f);
+    assert(outL[41] == 0.0f);
+
+    std::cout << "✓ testNoteOnOffset passed\n";
+}
+
+void testOffsetAcrossBlockEnd() {
+    Sampler sampler(samples);
+    auto click = makeClick();
+
+    // Onset two frames before the block end: tail continues in the next block
+    std::vector<float> outL(64, 0.0f), outR(64, 0.0f);
+    sampler.noteOn(click, 1.0f, 1.0f, 0.0f, 62);
+    sampler.render(outL.data(), outR.data(), 64);
+    assert(outL[61] == 0.0f);
+    assert(outL[62] == 1.0f && outL[63] == 0.5f);
+
+    std::fill(outL.begin(), outL.end(), 0.0f);
+    std::fill(outR.begin(), outR.end(), 0.0f);
+    sampler.render(outL.data(), outR.data(), 64);
+    assert(outL[0] == 0.25f && outL[1] == 0.125f);
+    assert(sampler.getActiveVoiceCount() == 0);
+
+    std::cout << "✓ testOffsetAcrossBlockEnd passed\n";
+}
+
+// Play two bars of impulses under a tempo map; true if every onset lands on
+// the frame the compiled tempo timeline gives for its tick. With lookahead,
+// the worker schedules every block after the first.
+static bool engineOnsetsMatch(const TempoMap& tempoMap, bool lookahead = false) {
+    Engine engine;
+    const uint32_t sampleRate = engine.getSampleRate();
+
+    // Single-frame impulse: every nonzero output frame is an onset
+    auto impulse = std::make_shared<Sample>();
+    impulse->dataLeft = {1.0f};
+    impulse->dataRight = {1.0f};
+    impulse->lengthFrames = 1;
+    engine.getSampleLibrary().addSample("impulse", impulse);
+
+    Project& project = engine.getProject();
+    project.getTempoMap() = tempoMap;
+    project.getInstrumentRack().getInstrument(1)->setSamplePath("impulse");
+
+    // Ticks chosen so onsets fall at odd offsets inside blocks (and on tick 0)
+    const std::vector<Tick> ticks = {0, 1, 37, 961, 2879, 3839};
+    Pattern pattern("click", "Click", 3840);
+    for (Tick tick : ticks) {
+        pattern.addNote({1, tick, 1.0f});
+    }
+    project.getPatternLibrary().addPattern(pattern);
+
+    Region region("r1", RegionType::Groove, 0, 3840 * 2);
+    region.setPatternId("click");
+    project.getTrack(size_t(0))->addRegion(region);
+
+    engine.loadInstrumentSamples();
+    engine.playTimeline();
+    if (lookahead) {
+        engine.getLookaheadScheduler().start(sampleRate / 10);
+    }
+
+    // Expected onset frames, as the callback converts them
+    TempoTimeline reference(tempoMap, sampleRate);
+    std::vector<uint64_t> expected;
+    for (int bar = 0; bar < 2; ++bar) {
+        for (Tick tick : ticks) {
+            expected.push_back(reference.tickToFrame(bar * 3840 + tick));
+        }
+    }
+
+    // Render with a block size that does not divide the onset spacing
+    const uint32_t blockSize = 100;
+    const uint64_t totalFrames = expected.back() + blockSize * 3;
+    std::vector<uint64_t> onsets;
+    std::vector<float> outL(blockSize), outR(blockSize);
+    for (uint64_t blockStart = 0; blockStart < totalFrames; blockStart += blockSize) {
+        if (lookahead && blockStart > 0) {
+            const LookaheadScheduler& worker = engine.getLookaheadScheduler();
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (worker.getHorizonFrame() < blockStart + blockSize &&
+                   std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        std::fill(outL.begin(), outL.end(), 0.0f);
+        std::fill(outR.begin(), outR.end(), 0.0f);
+        engine.audioCallback(blockSize, outL.data(), outR.data());
+        for (uint32_t i = 0; i < blockSize; ++i) {
+            if (outL[i] != 0.0f) {
+                onsets.push_back(blockStart + i);
+            }
+        }
+    }
+
+    engine.getLookaheadScheduler().stop();
+    engine.stopPlayback();
+    return onsets == expected;
+}
+
+void testEngineOnsetsAreSampleAccurate() {
+    assert(engineOnsetsMatch(TempoMap(120.0)));
+
+    std::cout << "✓ testEngineOnsetsAreSampleAccurate passed\n";
+}
+
+void testEngineFollowsTempoChanges() {
+    // Changes inside blocks, between onsets and right on an onset
+    TempoMap tempoMap(120.0);
+    tempoMap.addChange(500, 90.0);
+    tempoMap.addChange(2879, 173.5);
+    tempoMap.addChange(3840 + 100, 61.0);
+    assert(engineOnsetsMatch(tempoMap));
+
+    // Sanity: the second bar really is at a different tempo than 120
+    TempoTimeline compiled(tempoMap, 48000);
+    assert(compiled.tickToFrame(3840) != TimeUtils::ticksToFrames(3840, 120.0, 48000));
+
+    // Onsets inside ramps (up, then down across the bar line) land on the
+    // closed-form frame too
+    TempoMap ramped(120.0);
+    ramped.addRamp(0, 120.0, 2000, 180.0);
+    ramped.addRamp(3000, 180.0, 3840 + 1000, 75.0);
+    assert(engineOnsetsMatch(ramped));
+
+    // Same onsets when scheduled ahead on the lookahead worker
+    assert(engineOnsetsMatch(tempoMap, true));
+    assert(engineOnsetsMatch(ramped, true));
+
+    std::cout << "✓ testEngineFollowsTempoChanges passed\n";
+}
+
+void testSetTempoKeepsRamp() {
+    Engine engine;
+    TempoMap& tempoMap = engine.getProject().getTempoMap();
+    tempoMap.addRamp(0, 100.0, 3840, 160.0);
+
+    // Only the starting tempo changes; the glide to 160 stays
+    engine.setTempo(90.0);
+    assert(tempoMap.getChanges().size() == 2);
+    assert(tempoMap.getChanges()[0].bpm == 90.0);
+    assert(tempoMap.getChanges()[0].ramp);
+    assert(std::abs(tempoMap.getBpmAt(1920) - 125.0) < 1e-9);
+    assert(tempoMap.getBpmAt(3840) == 160.0);
+
+    // Without a change at tick 0 it adds a step there
+    tempoMap.clear();
+    tempoMap.addChange(960, 140.0);
+    engine.setTempo(110.0);
+    assert(tempoMap.getChanges().size() == 2);
+    assert(tempoMap.getBpmAt(0) == 110.0 && !tempoMap.getChanges()[0].ramp);
+    assert(tempoMap.getBpmAt(960) == 140.0);
+
+    std::cout << "✓ testSetTempoKeepsRamp passed\n";
+}
+
+void testMixKernelsMatchScalar() {
+    const MixKernels& scalar = *mixKernelsFor(MixIsa::Scalar);
+    const MixIsa isas[] = {MixIsa::SSE2, MixIsa::AVX2, MixIsa::AVX512};
+
+    std::vector<float> srcL(300), srcR(300);
+    for (size_t i = 0; i < srcL.size(); ++i) {
+        srcL[i] = static_cast<float>(i % 17) * 0.1f - 0.8f;
+        srcR[i] = static_cast<float>(i % 23) * 0.07f - 0.7f;
+    }
+
+    for (MixIsa isa : isas) {
+        const MixKernels* kernels = mixKernelsFor(isa);
+        if (kernels == nullptr) {
+            continue;  // Not supported on this CPU
+        }
+
+        // Odd lengths and offsets exercise unaligned access and tails
+        for (uint32_t n : {0u, 1u, 3u, 7u, 15u, 16u, 17u, 33u, 64u, 257u}) {
+            for (uint32_t offset : {0u, 1u, 5u}) {
+                std::vector<float> refL(300, 0.25f), refR(300, -0.25f);
+                std::vector<float> outL = refL, outR = refR;
+                scalar.mixStereo(srcL.data() + offset, srcR.data() + offset,
+                                 refL.data() + offset, refR.data() + offset, n, 0.7f, 0.3f);
+                kernels->mixStereo(srcL.data() + offset, srcR.data() + offset,
+                                   outL.data() + offset, outR.data() + offset, n, 0.7f, 0.3f);
+                // Bit-identical, and nothing written past the span
+                assert(outL == refL && outR == refR);
+            }
+        }
+    }
+
+    std::cout << "✓ testMixKernelsMatchScalar passed (active: " << mixKernels().name << ")\n";
+}
+
+void testStealOldest() {
+    Sampler sampler(samples, 2);
+    auto a = makeDC(1.0f), b = makeDC(2.0f), c = makeDC(4.0f);
+    sampler.setStealPolicy(StealPolicy::Oldest);
+
+    sampler.noteOn(a, 1.0f, 1.0f, 0.0f, 0, 1);
+    sampler.noteOn(b, 1.0f, 1.0f, 0.0f, 0, 2);
+    renderBlock(sampler);
+
+    // Pool full: A (oldest) fades out over the next block instead of cutting
+    sampler.noteOn(c, 1.0f, 1.0f, 0.0f, 0, 2);
+    assert(sampler.getActiveVoiceCount() == 3);
+    std::vector<float> fade = renderBlock(sampler);
+    assert(fade[0] == 7.0f);
+    for (size_t i = 1; i < fade.size(); ++i) {
+        assert(fade[i] < fade[i - 1]);
+    }
+    assert(fade[63] > 6.0f);
+
+    std::vector<float> after = renderBlock(sampler);
+    assert(after[0] == 6.0f && after[63] == 6.0f);
+    assert(sampler.getActiveVoiceCount() == 2);
+
+    std::cout << "✓ testStealOldest passed\n";
+}
+
+void testStealQuietest() {
+    Sampler sampler(samples, 2);
+    auto a = makeDC(1.0f), b = makeDC(2.0f), c = makeDC(4.0f);
+    sampler.setStealPolicy(StealPolicy::Quietest);
+
+    sampler.noteOn(a, 1.0f, 1.0f, 0.0f, 0, 1);
+    sampler.noteOn(b, 0.25f, 1.0f, 0.0f, 0, 2);
+    renderBlock(sampler);
+
+    // B was triggered softly: it goes, although A is older
+    sampler.noteOn(c, 1.0f, 1.0f, 0.0f, 0, 3);
+    renderBlock(sampler);
+    std::vector<float> after = renderBlock(sampler);
+    assert(after[0] == 5.0f);
+
+    std::cout << "✓ testStealQuietest passed\n";
+}
+
+void testStealSameInstrumentFirst() {
+    Sampler sampler(samples, 2);
+    auto a = makeDC(1.0f), b = makeDC(2.0f), c = makeDC(4.0f);
+    sampler.setStealPolicy(StealPolicy::SameInstrumentFirst);
+
+    sampler.noteOn(a, 1.0f, 1.0f, 0.0f, 0, 1);
+    sampler.noteOn(b, 1.0f, 1.0f, 0.0f, 0, 2);
+    renderBlock(sampler);
+
+    // Another hit on instrument 2 replaces B; A (older) keeps ringing
+    sampler.noteOn(c, 1.0f, 1.0f, 0.0f, 0, 2);
+    renderBlock(sampler);
+    assert(renderBlock(sampler)[0] == 5.0f);
+
+    // No voice of instrument 7: falls back to the oldest (A)
+    sampler.noteOn(b, 1.0f, 1.0f, 0.0f, 0, 7);
+    renderBlock(sampler);
+    assert(renderBlock(sampler)[0] == 6.0f);
+
+    std::cout << "✓ testStealSameInstrumentFirst passed\n";
+}
+
+void testStealNoneDropsAndPoolRecycles() {
+    Sampler sampler(samples, 2);
+    auto a = makeDC(1.0f), c = makeDC(4.0f);
+    auto click = makeClick();
+    sampler.setStealPolicy(StealPolicy::None);
+
+    sampler.noteOn(a, 1.0f, 1.0f, 0.0f);
+    sampler.noteOn(a, 1.0f, 1.0f, 0.0f);
+    sampler.noteOn(c, 1.0f, 1.0f, 0.0f);
+    assert(sampler.getActiveVoiceCount() == 2);
+    assert(renderBlock(sampler)[0] == 2.0f);
+
+    // Finished voices go back to the pool; many short hits never run dry
+    sampler.allNotesOff();
+    for (int i = 0; i < 1000; ++i) {
+        sampler.noteOn(click, 1.0f, 1.0f, 0.0f, static_cast<uint32_t>(i % 60));
+        renderBlock(sampler);
+        assert(sampler.getActiveVoiceCount() <= 1);
+    }
+
+    std::cout << "✓ testStealNoneDropsAndPoolRecycles passed\n";
+}
+
+void testChokeGroup() {
+    Sampler sampler(samples);
+    auto openHat = makeDC(1.0f), closedHat = makeDC(2.0f), kick = makeDC(4.0f);
+
+    sampler.noteOn(openHat, 1.0f, 1.0f, 0.0f, 0, 3, 1);
+    sampler.noteOn(kick, 1.0f, 1.0f, 0.0f, 0, 1);
+    renderBlock(sampler);
+
+    // Closed hat at frame 10 chokes the open hat from that frame on
+    sampler.noteOn(closedHat, 1.0f, 1.0f, 0.0f, 10, 4, 1);
+    std::vector<float> block = renderBlock(sampler);
+    assert(block[9] == 5.0f);
+    assert(block[10] == 7.0f);
+    assert(block[11] < 7.0f && block[11] > 6.0f);
+    assert(block[63] < block[11]);
+
+    // Open hat gone; kick (no group) untouched
+    renderBlock(sampler);
+    assert(renderBlock(sampler)[0] == 6.0f);
+    assert(sampler.getActiveVoiceCount() == 2);
+
+    // A choke before the choked voice is heard just drops it
+    sampler.allNotesOff();
+    sampler.noteOn(openHat, 1.0f, 1.0f, 0.0f, 20, 3, 1);
+    sampler.noteOn(closedHat, 1.0f, 1.0f, 0.0f, 5, 4, 1);
+    assert(sampler.getActiveVoiceCount() == 1);
+    block = renderBlock(sampler);
+    assert(block[4] == 0.0f && block[5] == 2.0f && block[30] == 2.0f);
+
+    std::cout << "✓ testChokeGroup passed\n";
+}
+
+void testMaxPolyphony() {
+    Sampler sampler(samples);
+    auto hat = makeDC(1.0f);
+
+    // Monophonic: each hit fades out the previous one
+    for (int hit = 0; hit < 8; ++hit) {
+        sampler.noteOn(hat, 1.0f, 1.0f, 0.0f, 0, 3, 0, 1);
+        renderBlock(sampler);
+    }
+    assert(sampler.getActiveVoiceCount() == 1);
+    assert(renderBlock(sampler)[0] == 1.0f);
+
+    // Two voices: the third hit fades out the oldest only
+    sampler.allNotesOff();
+    for (int hit = 0; hit < 3; ++hit) {
+        sampler.noteOn(hat, 1.0f, 1.0f, 0.0f, 0, 5, 0, 2);
+        renderBlock(sampler);
+    }
+    assert(sampler.getActiveVoiceCount() == 2);
+    assert(renderBlock(sampler)[0] == 2.0f);
+
+    std::cout << "✓ testMaxPolyphony passed\n";
+}
+
+void testInstrumentGainSmoothing() {
+    InstrumentTable instruments;
+    Sampler sampler(samples);
+    sampler.setInstrumentTable(&instruments);
+    auto tone = makeDC(1.0f);
+
+    instruments.set(1, tone, 1.0f, 0.0f, 0, 0);
+    instruments.beginBlock(64);
+    sampler.noteOn(tone, 1.0f, 1.0f, 0.0f, 0, 1);
+    assert(renderBlock(sampler)[63] == 1.0f);
+
+    // Fader move: ramps across the next block, then holds
+    instruments.setGain(1, 0.5f);
+    instruments.beginBlock(64);
+    std::vector<float> block = renderBlock(sampler);
+    assert(block[0] == 1.0f);
+    for (size_t i = 1; i < block.size(); ++i) {
+        assert(block[i] < block[i - 1]);
+        assert(block[i - 1] - block[i] < 0.01f);
+    }
+    assert(block[63] > 0.5f && block[63] < 0.51f);
+    instruments.beginBlock(64);
+    block = renderBlock(sampler);
+    assert(block[0] == 0.5f && block[63] == 0.5f);
+
+    // Pan hard right: the left channel fades to silence
+    instruments.setPan(1, 1.0f);
+    instruments.beginBlock(64);
+    renderBlock(sampler);
+    instruments.beginBlock(64);
+    std::vector<float> outL(64, 0.0f), outR(64, 0.0f);
+    sampler.render(outL.data(), outR.data(), 64);
+    assert(outL[0] == 0.0f && outR[0] == 0.5f);
+
+    // Untracked instruments keep their trigger-time gain
+    instruments.remove(1);
+    instruments.beginBlock(64);
+    assert(renderBlock(sampler)[0] == 1.0f);
+
+    std::cout << "✓ testInstrumentGainSmoothing passed\n";
+}
+
+void testWorkerPoolRunsEveryTask() {
+    RenderWorkerPool pool;
+    pool.start(3, nullptr);
+    assert(pool.getThreadCount() == 3);
+
+    // Every task of every job runs exactly once, whoever claims it
+    std::vector<int> runs(7, 0);
+    auto countTask = [](void* context, size_t task) {
+        auto& counts = *static_cast<std::vector<int>*>(context);
+        ++counts[task];
+    };
+    for (int job = 0; job < 2000; ++job) {
+        pool.run(runs.size(), countTask, &runs);
+    }
+    for (int count : runs) {
+        assert(count == 2000);
+    }
+
+    // Without helpers the caller runs everything
+    pool.stop();
+    assert(pool.getThreadCount() == 0);
+    pool.run(runs.size(), countTask, &runs);
+    assert(runs[6] == 2001);
+
+    std::cout << "✓ testWorkerPoolRunsEveryTask passed\n";
+}
+
+void testParallelRenderMatchesSerial() {
+    RenderWorkerPool pool;
+    pool.start(3, nullptr);
+
+    Sampler serial(samples, 64);
+    Sampler parallel(samples, 64);
+    parallel.setWorkerPool(&pool);
+
+    // Voices of different lengths (ending mid-block), offsets and pans,
+    // enough to be stolen along the way
+    std::vector<SampleHandle> handles;
+    for (int i = 0; i < 12; ++i) {
+        handles.push_back(makeDC(0.05f + 0.01f * i, 200 + 173 * i));
+    }
+
+    const uint32_t blockSize = 128;
+    std::vector<float> serialL(blockSize), serialR(blockSize);
+    std::vector<float> parallelL(blockSize), parallelR(blockSize);
+    size_t mostVoices = 0;
+    for (int block = 0; block < 60; ++block) {
+        for (int hit = 0; hit < 5; ++hit) {
+            const int n = block * 5 + hit;
+            const SampleHandle sample = handles[static_cast<size_t>(n) % handles.size()];
+            const float pan = static_cast<float>(n % 7) / 3.0f - 1.0f;
+            const uint32_t offset = static_cast<uint32_t>((n * 37) % blockSize);
+            serial.noteOn(sample, 0.9f, 1.0f, pan, offset, n % 4, 0, 0);
+            parallel.noteOn(sample, 0.9f, 1.0f, pan, offset, n % 4, 0, 0);
+        }
+
+        std::fill(serialL.begin(), serialL.end(), 0.0f);
+        std::fill(serialR.begin(), serialR.end(), 0.0f);
+        std::fill(parallelL.begin(), parallelL.end(), 0.0f);
+        std::fill(parallelR.begin(), parallelR.end(), 0.0f);
+        serial.render(serialL.data(), serialR.data(), blockSize);
+        parallel.render(parallelL.data(), parallelR.data(), blockSize);
+
+        // Same voices end; the sum only differs by float rounding
+        assert(parallel.getActiveVoiceCount() == serial.getActiveVoiceCount());
+        mostVoices = std::max(mostVoices, parallel.getActiveVoiceCount());
+        for (uint32_t i = 0; i < blockSize; ++i) {
+            assert(std::abs(parallelL[i] - serialL[i]) < 1e-5f);
+            assert(std::abs(parallelR[i] - serialR[i]) < 1e-5f);
+        }
+    }
+    assert(mostVoices >= 4 * MIN_VOICES_PER_STRIPE);  // Really ran on all stripes
+
+    // Too few voices to split: one thread, bit-identical
+    serial.allNotesOff();
+    parallel.allNotesOff();
+    for (int i = 0; i < 3; ++i) {
+        serial.noteOn(handles[static_cast<size_t>(i)], 1.0f, 1.0f, 0.3f, 0);
+        parallel.noteOn(handles[static_cast<size_t>(i)], 1.0f, 1.0f, 0.3f, 0);
+    }
+    std::fill(serialL.begin(), serialL.end(), 0.0f);
+    std::fill(parallelL.begin(), parallelL.end(), 0.0f);
+    serial.render(serialL.data(), serialR.data(), blockSize);
+    parallel.render(parallelL.data(), parallelR.data(), blockSize);
+    assert(parallelL == serialL);
+
+    pool.stop();
+    std::cout << "✓ testParallelRenderMatchesSerial passed\n";
+}
+
+int main() {
+    std::cout << "Running Sampler tests...\n";
+
+    testNoteOnOffset();
+    testOffsetAcrossBlockEnd();
+    testEngineOnsetsAreSampleAccurate();
+    testEngineFollowsTempoChanges();
+    testSetTempoKeepsRamp();
+    testMixKernelsMatchScalar();
+    testStealOldest();
+    testStealQuietest();
+    testStealSameInstrumentFirst();
+    testStealNoneDropsAndPoolRecycles();
+    testChokeGroup();
+    testMaxPolyphony();
+    testInstrumentGainSmoothing();
+    testWorkerPoolRunsEveryTask();
+    testParallelRenderMatchesSerial();
+
+    std::cout << "\n✓ All Sampler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,441 @@
+#include "engine/Scheduler.hpp"
+#include "engine/EventTimeline.hpp"
+#include "engine/LookaheadScheduler.hpp"
+#include "domain/Project.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+
+using namespace beater;
+
+// Two-track arrangement: a repeating groove (truncated last repeat) and a fill
+static Project makeProject() {
+    Project project;
+
+    Pattern groove("groove", "Groove", 3840);
+    groove.addNote({1, 0, 0.9f});
+    groove.addNote({2, 960, 0.8f});
+    groove.addNote({3, 1920, 0.7f});
+    project.getPatternLibrary().addPattern(groove);
+
+    Pattern fill("fill", "Fill", 3840);
+    for (int i = 0; i < 4; ++i) {
+        fill.addNote({2, i * 960, 0.6f});
+    }
+    project.getPatternLibrary().addPattern(fill);
+
+    // 2.5 bars of groove: 3 + 3 + 2 notes
+    Region grooveRegion("r1", RegionType::Groove, 0, 3840 * 2 + 1920);
+    grooveRegion.setPatternId("groove");
+    project.getTrack(size_t(0))->addRegion(grooveRegion);
+
+    Track fillTrack("track_1", "Fills");
+    Region fillRegion("r2", RegionType::Fill, 3840, 3840);
+    fillRegion.setPatternId("fill");
+    fillTrack.addRegion(fillRegion);
+    project.addTrack(fillTrack);
+
+    return project;
+}
+
+void testCompileTimeline() {
+    Project project = makeProject();
+
+    EventTimeline timeline;
+    timeline.compile(project);
+
+    assert(timeline.size() == 8 + 4);
+    assert(timeline.getEndTick() == 3840 * 2 + 1920);
+
+    // Sorted by tick
+    const std::vector<CompiledEvent> events = timeline.getEvents();
+    for (size_t i = 1; i < events.size(); ++i) {
+        assert(events[i - 1].tick <= events[i].tick);
+    }
+
+    // Truncated last repeat: nothing at or past the region end
+    assert(events.back().tick < timeline.getEndTick());
+
+    // Binary search lands on the first event at or after the tick
+    assert(timeline.findFirstAt(0) == 0);
+    assert(events[timeline.findFirstAt(961)].tick == 1920);
+    assert(timeline.findFirstAt(1000000) == timeline.size());
+
+    std::cout << "✓ testCompileTimeline passed\n";
+}
+
+void testCursorContiguousBlocks() {
+    Project project = makeProject();
+    EventTimeline timeline;
+    timeline.compile(project);
+    Scheduler scheduler;
+    scheduler.setTimeline(&timeline);
+
+    // Walking contiguous blocks must yield every event exactly once, in order
+    EventBuffer events(MAX_EVENTS_PER_BLOCK);
+    size_t total = 0;
+    Tick lastTick = -1;
+    for (Tick start = 0; start < 12000; start += 250) {
+        scheduler.getEventsInRange(start, start + 250, events);
+        for (const auto& event : events) {
+            assert(event.tick >= start && event.tick < start + 250);
+            assert(event.tick >= lastTick);
+            lastTick = event.tick;
+        }
+        total += events.size();
+    }
+
+    assert(total == timeline.size());
+
+    std::cout << "✓ testCursorContiguousBlocks passed\n";
+}
+
+void testCursorSeek() {
+    Project project = makeProject();
+    EventTimeline timeline;
+    timeline.compile(project);
+    Scheduler scheduler;
+    scheduler.setTimeline(&timeline);
+
+    // Play past the first bar, then jump back
+    EventBuffer events(MAX_EVENTS_PER_BLOCK);
+    scheduler.getEventsInRange(0, 5000, events);
+    scheduler.getEventsInRange(900, 1000, events);
+    assert(events.size() == 1);
+    assert(events[0].tick == 960);
+
+    // Jump forward into the overlap of groove and fill
+    scheduler.getEventsInRange(3840, 3841, events);
+    assert(events.size() == 2);
+    assert(events[0].tick == 3840 && events[1].tick == 3840);
+
+    // Past the end: nothing
+    scheduler.getEventsInRange(20000, 30000, events);
+    assert(events.empty());
+
+    std::cout << "✓ testCursorSeek passed\n";
+}
+
+void testCursorCrossesChunks() {
+    // Hits in the first chunk and many chunks later, nothing in between
+    Project project = makeProject();
+    Region late("r3", RegionType::Groove, EventTimeline::CHUNK_TICKS * 6 + 1000, 3840);
+    late.setPatternId("groove");
+    project.getTrack(size_t(0))->addRegion(late);
+    EventTimeline timeline;
+    timeline.compile(project);
+    assert(timeline.getChunkCount() == 7);
+    assert(timeline.getChunk(3) == nullptr);
+    Scheduler scheduler;
+    scheduler.setTimeline(&timeline);
+
+    // Contiguous blocks walk over the empty chunks
+    EventBuffer events(MAX_EVENTS_PER_BLOCK);
+    size_t total = 0;
+    Tick lastTick = -1;
+    for (Tick start = 0; start < EventTimeline::CHUNK_TICKS * 8; start += 1000) {
+        scheduler.getEventsInRange(start, start + 1000, events);
+        for (const auto& event : events) {
+            assert(event.tick >= start && event.tick < start + 1000);
+            assert(event.tick >= lastTick);
+            lastTick = event.tick;
+        }
+        total += events.size();
+    }
+    assert(total == timeline.size());
+
+    // Seeking into an empty chunk finds the next hit further on
+    const Tick lateStart = EventTimeline::CHUNK_TICKS * 6 + 1000;
+    scheduler.getEventsInRange(EventTimeline::CHUNK_TICKS * 3, lateStart + 1, events);
+    assert(events.size() == 1 && events[0].tick == lateStart);
+    assert(timeline.findFirstAt(EventTimeline::CHUNK_TICKS * 3) == 12);
+
+    std::cout << "✓ testCursorCrossesChunks passed\n";
+}
+
+void testFullBufferDropsRestOfBlock() {
+    Project project = makeProject();
+    EventTimeline timeline;
+    timeline.compile(project);
+    Scheduler scheduler;
+    scheduler.setTimeline(&timeline);
+
+    // Room for one event: the second hit at 3840 is dropped, not deferred
+    EventBuffer events(1);
+    scheduler.getEventsInRange(3840, 3841, events);
+    assert(events.size() == 1);
+    scheduler.getEventsInRange(3841, 4900, events);
+    assert(events.size() == 1);
+    assert(events[0].tick == 4800);
+
+    std::cout << "✓ testFullBufferDropsRestOfBlock passed\n";
+}
+
+static bool sameEvents(const EventTimeline& a, const EventTimeline& b) {
+    if (a.size() != b.size() || a.getEndTick() != b.getEndTick()) {
+        return false;
+    }
+    const std::vector<CompiledEvent> eventsA = a.getEvents();
+    const std::vector<CompiledEvent> eventsB = b.getEvents();
+    for (size_t i = 0; i < eventsA.size(); ++i) {
+        const CompiledEvent& x = eventsA[i];
+        const CompiledEvent& y = eventsB[i];
+        if (x.tick != y.tick || x.instrumentId != y.instrumentId || x.velocity != y.velocity) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testChangeJournal() {
+    Project project = makeProject();
+    std::vector<Change> changes;
+    project.drainChanges(changes);
+
+    // Drained: nothing pending
+    changes.clear();
+    project.drainChanges(changes);
+    assert(changes.empty());
+
+    // A move records where the region was and where it went
+    Track* track = project.getTrack(size_t(0));
+    track->setRegionBounds(0, 960, 3840);
+    project.getPatternLibrary().getPattern("fill")->addNote({1, 480, 0.5f});
+    project.getPatternLibrary().getPattern("fill")->addNote({1, 1440, 0.5f});
+    project.getTempoMap().addChange(3840, 90.0);
+    project.drainChanges(changes);
+
+    bool moved = false, patternChanged = false, tempoChanged = false;
+    for (const auto& change : changes) {
+        if (change.kind == ChangeKind::RegionChanged) {
+            moved = change.target == domainSymbols().find("r1") &&
+                    change.oldStart == 0 && change.oldEnd == 3840 * 2 + 1920 &&
+                    change.newStart == 960 && change.newEnd == 960 + 3840;
+        }
+        if (change.kind == ChangeKind::PatternChanged) {
+            assert(!patternChanged);  // One record per pattern until drained
+            patternChanged = change.target == domainSymbols().find("fill");
+        }
+        tempoChanged = tempoChanged || change.kind == ChangeKind::TempoChanged;
+    }
+    assert(moved && patternChanged && tempoChanged);
+
+    // Too many records collapse into a reset
+    changes.clear();
+    for (size_t i = 0; i <= ChangeJournal::MAX_RECORDS; ++i) {
+        track->setRegionBounds(0, static_cast<Tick>(i), 3840);
+    }
+    project.drainChanges(changes);
+    assert(changes.size() == 1 && changes[0].kind == ChangeKind::Reset);
+
+    std::cout << "✓ testChangeJournal passed\n";
+}
+
+void testIncrementalUpdateMatchesCompile() {
+    Project project = makeProject();
+    uint32_t seed = 4242;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<Tick>((seed >> 8) % range);
+    };
+    const char* patternIds[] = {"groove", "fill", "missing"};
+
+    EventTimeline patched;
+    patched.compile(project);
+    std::vector<Change> changes;
+    project.drainChanges(changes);
+
+    int nextId = 0;
+    for (int step = 0; step < 600; ++step) {
+        // A few edits between publishes, like a drag between UI frames
+        for (Tick edits = next(4) + 1; edits > 0; --edits) {
+            Track* track = project.getTrack(static_cast<size_t>(next(static_cast<uint32_t>(project.getTrackCount()))));
+            Tick op = next(12);
+            size_t regionCount = track->getRegions().size();
+            size_t index = regionCount > 0 ? static_cast<size_t>(next(static_cast<uint32_t>(regionCount))) : 0;
+            if (op < 3 || regionCount == 0) {
+                Region region("inc" + std::to_string(nextId++), RegionType::Groove,
+                              next(40000), next(8000) + 1);
+                region.setPatternId(patternIds[next(3)]);
+                track->addRegion(region);
+            } else if (op < 5) {
+                track->setRegionBounds(index, next(40000), next(8000) + 1);
+            } else if (op == 5) {
+                track->removeRegion(track->getRegions()[index].getId());
+            } else if (op == 6) {
+                track->setRegionPattern(index, patternIds[next(3)]);
+            } else if (op == 7) {
+                Pattern* pattern = project.getPatternLibrary().getPattern(patternIds[next(2)]);
+                pattern->addNote({static_cast<int>(next(4)), next(4000), 0.5f});
+            } else if (op == 8) {
+                Pattern* pattern = project.getPatternLibrary().getPattern(patternIds[next(2)]);
+                if (!pattern->getNotes().empty()) {
+                    pattern->removeNote(static_cast<size_t>(next(static_cast<uint32_t>(pattern->getNotes().size()))));
+                }
+            } else if (op == 9) {
+                project.getPatternLibrary().getPattern(patternIds[next(2)])->setLengthTicks(next(3840) + 240);
+            } else if (op == 10) {
+                Track extra("extra" + std::to_string(nextId++), "Extra");
+                extra.addRegion(Region("inc" + std::to_string(nextId++), RegionType::Fill, next(40000), 3840));
+                extra.setRegionPattern(0, "fill");
+                project.addTrack(extra);
+            } else if (project.getTrackCount() > 1) {
+                project.removeTrack(project.getTracks().back().getId());
+            }
+        }
+
+        changes.clear();
+        project.drainChanges(changes);
+        patched.update(project, changes);
+
+        EventTimeline fresh;
+        fresh.compile(project);
+        assert(sameEvents(patched, fresh));
+    }
+
+    std::cout << "✓ testIncrementalUpdateMatchesCompile passed\n";
+}
+
+// Wait (bounded) for the worker to schedule up to a frame
+static void waitForHorizon(const LookaheadScheduler& lookahead, uint64_t frame) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (lookahead.getHorizonFrame() < frame && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+void testLookaheadMatchesInline() {
+    // Long arrangement under a tempo ramp
+    Project project = makeProject();
+    Region longRegion("r3", RegionType::Groove, 3840 * 3, 3840 * 16);
+    longRegion.setPatternId("groove");
+    project.getTrack(size_t(0))->addRegion(longRegion);
+    project.getTempoMap().addRamp(0, 100.0, 3840 * 2, 160.0);
+
+    SnapshotExchange snapshots;
+    auto published = std::make_unique<ProjectSnapshot>(project);
+    published->tempo.compile(project.getTempoMap(), 48000);
+    snapshots.publish(std::move(published));
+    const ProjectSnapshot* snapshot = snapshots.acquire();
+    const TempoTimeline& tempo = snapshot->tempo;
+
+    LookaheadScheduler lookahead(snapshots);
+    lookahead.start(4800);  // 100 ms
+
+    // Reference: the audio thread's inline scheduling
+    Scheduler reference;
+    reference.setTimeline(&snapshot->timeline);
+    EventBuffer expected(MAX_EVENTS_PER_BLOCK);
+    ScheduledBuffer scheduled(MAX_EVENTS_PER_BLOCK);
+
+    LookaheadScheduler::Block block;
+    block.snapshot = snapshot;
+    block.rolling = true;
+    block.timelineMode = true;
+    block.sampleRate = 48000;
+    block.nframes = 300;
+
+    int blocks = 0;
+    int ahead = 0;
+    size_t eventCount = 0;
+    uint64_t frame = 0;
+    while (frame < 48000 * 20) {
+        // One transport jump, forwards
+        const bool jump = frame == 48000 * 4;
+        if (jump) {
+            frame = 48000 * 9;
+        }
+        if (frame > 0 && !jump) {
+            waitForHorizon(lookahead, frame + block.nframes);
+        }
+
+        block.startFrame = frame;
+        const bool took = lookahead.takeBlock(block, scheduled);
+        reference.getEventsInRange(tempo.firstTickAtFrame(frame),
+                                   tempo.firstTickAtFrame(frame + block.nframes), expected);
+        if (took) {
+            assert(scheduled.size() == expected.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                assert(scheduled[i].event.tick == expected[i].tick);
+                assert(scheduled[i].event.instrumentId == expected[i].instrumentId);
+                assert(scheduled[i].frame == tempo.tickToFrame(expected[i].tick));
+            }
+            ++ahead;
+        } else {
+            // Re-cued: the caller schedules this block itself
+            assert(scheduled.empty());
+        }
+        eventCount += expected.size();
+        ++blocks;
+        frame += block.nframes;
+    }
+    lookahead.stop();
+
+    // Only the first block and the one after the jump were inline
+    assert(eventCount > 30);
+    assert(ahead == blocks - 2);
+
+    std::cout << "✓ testLookaheadMatchesInline passed\n";
+}
+
+void testLookaheadRecuesOnNewSnapshot() {
+    Project project = makeProject();
+    SnapshotExchange snapshots;
+    snapshots.publish(std::make_unique<ProjectSnapshot>(project));
+    const ProjectSnapshot* first = snapshots.acquire();
+
+    LookaheadScheduler lookahead(snapshots);
+    lookahead.start(4800);
+    ScheduledBuffer scheduled(MAX_EVENTS_PER_BLOCK);
+
+    LookaheadScheduler::Block block;
+    block.snapshot = first;
+    block.rolling = true;
+    block.timelineMode = true;
+    block.nframes = 256;
+    assert(!lookahead.takeBlock(block, scheduled));  // Cues the worker
+    block.startFrame = 256;
+    waitForHorizon(lookahead, 512);
+    assert(lookahead.takeBlock(block, scheduled));
+
+    // An edit publishes a new snapshot: the next block is inline again
+    project.getTrack(size_t(0))->clearRegions();
+    snapshots.publish(std::make_unique<ProjectSnapshot>(project));
+    block.snapshot = snapshots.acquire();
+    assert(block.snapshot != first);
+    block.startFrame = 512;
+    assert(!lookahead.takeBlock(block, scheduled));
+    block.startFrame = 768;
+    waitForHorizon(lookahead, 1024);
+    assert(lookahead.takeBlock(block, scheduled));
+
+    // The worker may still have pinned the old snapshot; it is freed later
+    lookahead.stop();
+    snapshots.collect();
+
+    // Stopping the transport stops scheduling
+    block.rolling = false;
+    assert(!lookahead.takeBlock(block, scheduled));
+
+    std::cout << "✓ testLookaheadRecuesOnNewSnapshot passed\n";
+}
+
+int main() {
+    std::cout << "Running Scheduler tests...\n";
+
+    testCompileTimeline();
+    testCursorContiguousBlocks();
+    testCursorSeek();
+    testCursorCrossesChunks();
+    testFullBufferDropsRestOfBlock();
+    testChangeJournal();
+    testIncrementalUpdateMatchesCompile();
+    testLookaheadMatchesInline();
+    testLookaheadRecuesOnNewSnapshot();
+
+    std::cout << "\n✓ All Scheduler tests passed!\n";
+    return 0;
+}
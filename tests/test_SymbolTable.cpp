@@ -0,0 +1,180 @@
+#include "domain/SymbolTable.hpp"
+#include "domain/Project.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace beater;
+
+void testInternAndFind() {
+    SymbolTable table;
+    assert(table.size() == 1);
+    assert(table.find("") == EMPTY_SYMBOL);
+    assert(table.find("kick") == INVALID_SYMBOL);
+    
+    SymbolId kick = table.intern("kick");
+    SymbolId snare = table.intern("snare");
+    assert(kick != snare);
+    assert(table.intern("kick") == kick);
+    assert(table.find("snare") == snare);
+    assert(table.name(kick) == "kick");
+    assert(table.size() == 3);
+    
+    // Names stay put while the table grows
+    const std::string* name = &table.name(kick);
+    for (int i = 0; i < 1000; ++i) {
+        table.intern("id_" + std::to_string(i));
+    }
+    assert(&table.name(kick) == name);
+    
+    std::cout << "✓ testInternAndFind passed\n";
+}
+
+void testNameWhileInterning() {
+    SymbolTable table;
+    const int count = 20000;
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (int i = 0; i < count; ++i) {
+            table.intern("sym_" + std::to_string(i));
+        }
+        done.store(true, std::memory_order_release);
+    });
+    
+    // Every id below size() already names its string
+    bool finished = false;
+    while (!finished) {
+        finished = done.load(std::memory_order_acquire);
+        size_t size = table.size();
+        for (size_t id = 1; id < size; id += 97) {
+            assert(table.name(static_cast<SymbolId>(id)) == "sym_" + std::to_string(id - 1));
+        }
+    }
+    writer.join();
+    assert(table.size() == count + 1);
+    assert(table.find("sym_19999") == count);
+    
+    std::cout << "✓ testNameWhileInterning passed\n";
+}
+
+void testIndexSizedByItems() {
+    struct Item { SymbolId id; };
+    auto symbolOf = [](const Item& item) { return item.id; };
+    
+    // Ids far apart (as in a process that has interned many) stay cheap
+    std::vector<Item> items;
+    for (SymbolId i = 0; i < 100; ++i) {
+        items.push_back({i * 100003u + 7});
+    }
+    SymbolIndex index;
+    index.update(items, 0, symbolOf);
+    assert(index.size() == items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        assert(index.find(items[i].id) == i);
+    }
+    assert(index.find(8) == SymbolIndex::NONE);
+    assert(index.find(INVALID_SYMBOL) == SymbolIndex::NONE);
+    
+    // Remove every third item and re-point the rest
+    for (size_t i = items.size(); i-- > 0;) {
+        if (i % 3 == 0) {
+            index.erase(items[i].id);
+            items.erase(items.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+    index.update(items, 0, symbolOf);
+    assert(index.size() == items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        assert(index.find(items[i].id) == i);
+    }
+    assert(index.find(7) == SymbolIndex::NONE);
+    
+    // Duplicates: the first one wins
+    items.push_back(items[0]);
+    index.update(items, items.size() - 1, symbolOf);
+    assert(index.find(items[0].id) == 0);
+    
+    index.clear();
+    assert(index.size() == 0);
+    assert(index.find(items[1].id) == SymbolIndex::NONE);
+    
+    std::cout << "✓ testIndexSizedByItems passed\n";
+}
+
+void testDomainIdsAreInterned() {
+    Region region("region_a", RegionType::Groove, 0, PPQ * 4);
+    region.setPatternId("pattern_a");
+    assert(region.getId() == "region_a");
+    assert(region.getPatternId() == "pattern_a");
+    assert(region.getSymbol() == domainSymbols().find("region_a"));
+    assert(region.getPatternSymbol() == domainSymbols().find("pattern_a"));
+    
+    // Default-constructed objects have the empty id
+    assert(Region().getId().empty());
+    assert(Region().getPatternSymbol() == EMPTY_SYMBOL);
+    
+    std::cout << "✓ testDomainIdsAreInterned passed\n";
+}
+
+void testPatternLibraryLookup() {
+    PatternLibrary library;
+    for (int i = 0; i < 10; ++i) {
+        library.addPattern(Pattern("p" + std::to_string(i), "Pattern", PPQ * 4));
+    }
+    
+    // Replacing keeps one entry per id
+    library.addPattern(Pattern("p3", "Replaced", PPQ * 2));
+    assert(library.getPatterns().size() == 10);
+    assert(library.getPattern("p3")->getName() == "Replaced");
+    
+    library.removePattern("p0");
+    library.removePattern("not_there");
+    assert(library.getPattern("p0") == nullptr);
+    for (const auto& pattern : library.getPatterns()) {
+        assert(library.getPattern(pattern.getId()) == &pattern);
+        assert(library.getPattern(pattern.getSymbol()) == &pattern);
+    }
+    assert(library.getPattern("never_interned_pattern") == nullptr);
+    
+    library.clear();
+    assert(!library.hasPattern("p1"));
+    
+    std::cout << "✓ testPatternLibraryLookup passed\n";
+}
+
+void testProjectTrackLookup() {
+    Project project;
+    project.addTrack(Track("track_1", "Perc"));
+    project.addTrack(Track("track_2", "Fx"));
+    assert(project.getTrack("track_0")->getName() == "Drums");
+    
+    project.removeTrack("track_0");
+    assert(project.getTrack("track_0") == nullptr);
+    assert(project.getTrack("track_2") == project.getTrack(static_cast<size_t>(1)));
+    assert(project.getTrackBySymbol(domainSymbols().find("track_1"))->getName() == "Perc");
+    
+    // Copies (as taken for engine snapshots) carry their own lookup table
+    Project copy = project;
+    assert(copy.getTrack("track_1") == copy.getTrack(static_cast<size_t>(0)));
+    
+    project.clear();
+    assert(project.getTrack("track_1") == nullptr);
+    
+    std::cout << "✓ testProjectTrackLookup passed\n";
+}
+
+int main() {
+    std::cout << "Running SymbolTable tests...\n";
+    
+    testInternAndFind();
+    testNameWhileInterning();
+    testIndexSizedByItems();
+    testDomainIdsAreInterned();
+    testPatternLibraryLookup();
+    testProjectTrackLookup();
+    
+    std::cout << "\n✓ All SymbolTable tests passed!\n";
+    return 0;
+}
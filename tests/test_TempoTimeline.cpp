@@ -0,0 +1,161 @@
+#include "domain/TempoTimeline.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+using namespace beater;
+
+void testConstantTempoMatchesTimeUtils() {
+    TempoTimeline timeline(TempoMap(133.0), 44100);
+    assert(timeline.getSegmentCount() == 1);
+
+    for (Tick tick = 0; tick < 20000; tick += 7) {
+        assert(timeline.tickToFrame(tick) == TimeUtils::ticksToFrames(tick, 133.0, 44100));
+    }
+    for (uint64_t frame = 0; frame < 100000; frame += 13) {
+        assert(timeline.frameToTick(frame) == TimeUtils::framesToTicks(frame, 133.0, 44100));
+    }
+
+    std::cout << "✓ testConstantTempoMatchesTimeUtils passed\n";
+}
+
+void testTempoChange() {
+    // One bar at 120, then half speed
+    TempoMap tempoMap(120.0);
+    tempoMap.addChange(3840, 60.0);
+    TempoTimeline timeline(tempoMap, 48000);
+    assert(timeline.getSegmentCount() == 2);
+
+    assert(timeline.tickToFrame(3840) == 96000);         // 2 s
+    assert(timeline.tickToFrame(3840 + 960) == 144000);  // + one beat at 60
+    assert(timeline.frameToTick(96000) == 3840);
+    assert(timeline.frameToTick(144000) == 4800);
+
+    assert(timeline.getBpmAt(3839) == 120.0);
+    assert(timeline.getBpmAt(3840) == 60.0);
+    assert(timeline.getBpmAtFrame(95999) == 120.0);
+    assert(timeline.getBpmAtFrame(96000) == 60.0);
+
+    std::cout << "✓ testTempoChange passed\n";
+}
+
+void testRoundTrip() {
+    TempoMap tempoMap(97.0);
+    tempoMap.addChange(1000, 181.0);
+    tempoMap.addChange(5555, 64.5);
+    tempoMap.addChange(9000, 140.0);
+    TempoTimeline timeline(tempoMap, 48000);
+
+    for (double tick = 0.0; tick < 12000.0; tick += 3.25) {
+        double back = timeline.frameToTickExact(timeline.tickToFrameExact(tick));
+        assert(std::abs(back - tick) < 1e-6);
+    }
+
+    std::cout << "✓ testRoundTrip passed\n";
+}
+
+void testFirstTickAtFrame() {
+    TempoMap tempoMap(120.0);
+    tempoMap.addChange(500, 90.0);
+    tempoMap.addChange(2879, 173.5);
+    TempoTimeline timeline(tempoMap, 48000);
+
+    // Brute force: smallest tick whose frame is at or after the target
+    Tick expected = 0;
+    for (uint64_t frame = 0; frame < 60000; frame += 11) {
+        while (timeline.tickToFrame(expected) < frame) {
+            ++expected;
+        }
+        assert(timeline.firstTickAtFrame(frame) == expected);
+    }
+
+    std::cout << "✓ testFirstTickAtFrame passed\n";
+}
+
+void testRecompile() {
+    TempoMap tempoMap(120.0);
+    TempoTimeline a(tempoMap, 48000);
+    TempoTimeline b;
+    assert(a == b);
+
+    tempoMap.addChange(100, 140.0);
+    b.compile(tempoMap, 48000);
+    assert(a != b);
+    assert(b.getSegmentCount() == 2);
+
+    // Changes at tick 0 replace the initial tempo rather than adding one
+    TempoMap replaced;
+    replaced.addChange(0, 90.0);
+    TempoTimeline c(replaced, 48000);
+    assert(c.getSegmentCount() == 1);
+    assert(c.getBpmAt(0) == 90.0);
+
+    std::cout << "✓ testRecompile passed\n";
+}
+
+void testRampMatchesFineSteps() {
+    // 90 -> 150 BPM over four bars, then held
+    TempoMap tempoMap(90.0);
+    tempoMap.addRamp(0, 90.0, 4 * 3840, 150.0);
+    TempoTimeline timeline(tempoMap, 48000);
+    assert(timeline.getSegmentCount() == 2);
+
+    // Reference: the ramp approximated by one constant step per tick,
+    // each at the tempo of its midpoint
+    double frame = 0.0;
+    for (Tick tick = 0; tick < 5 * 3840; ++tick) {
+        if (tick % 97 == 0) {
+            assert(std::abs(timeline.tickToFrameExact(static_cast<double>(tick)) - frame) < 1e-3);
+        }
+        double bpm = tick < 4 * 3840 ? 90.0 + 60.0 * (tick + 0.5) / (4 * 3840) : 150.0;
+        frame += TimeUtils::framesPerTick(bpm, 48000);
+    }
+
+    assert(timeline.getBpmAt(0) == 90.0);
+    assert(std::abs(timeline.getBpmAt(2 * 3840) - 120.0) < 1e-9);
+    assert(timeline.getBpmAt(4 * 3840) == 150.0);
+    assert(std::abs(timeline.getBpmAtFrame(timeline.tickToFrame(3840)) - 105.0) < 0.01);
+
+    std::cout << "✓ testRampMatchesFineSteps passed\n";
+}
+
+void testRampRoundTrip() {
+    // Ramps up and down, into a step, and one starting before tick 0
+    TempoMap tempoMap;
+    tempoMap.clear();
+    tempoMap.addChange(-960, 60.0, true);
+    tempoMap.addChange(960, 100.0);
+    tempoMap.addRamp(2000, 100.0, 6000, 240.0);
+    tempoMap.addRamp(6000, 240.0, 9000, 40.0);
+    tempoMap.addChange(9500, 133.0);
+    TempoTimeline timeline(tempoMap, 44100);
+
+    assert(std::abs(timeline.getBpmAt(0) - 80.0) < 1e-9);
+    for (double tick = 0.0; tick < 12000.0; tick += 3.25) {
+        double back = timeline.frameToTickExact(timeline.tickToFrameExact(tick));
+        assert(std::abs(back - tick) < 1e-6);
+    }
+
+    // Monotonic, so the block splitter can rely on it
+    for (Tick tick = 1; tick < 12000; ++tick) {
+        assert(timeline.tickToFrameExact(static_cast<double>(tick)) >
+               timeline.tickToFrameExact(static_cast<double>(tick - 1)));
+    }
+
+    std::cout << "✓ testRampRoundTrip passed\n";
+}
+
+int main() {
+    std::cout << "Running TempoTimeline tests...\n";
+
+    testConstantTempoMatchesTimeUtils();
+    testTempoChange();
+    testRoundTrip();
+    testFirstTickAtFrame();
+    testRecompile();
+    testRampMatchesFineSteps();
+    testRampRoundTrip();
+
+    std::cout << "\n✓ All TempoTimeline tests passed!\n";
+    return 0;
+}
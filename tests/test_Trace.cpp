@@ -0,0 +1,174 @@
+#include "trace/Trace.hpp"
+#include "engine/Engine.hpp"
+#include "engine/NullAudioBackend.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace beater;
+using json = nlohmann::json;
+
+// Parse the current dump
+static json dumpJson() {
+    std::ostringstream out;
+    Tracer::instance().writeJson(out);
+    return json::parse(out.str());
+}
+
+static size_t countEvents(const json& trace, const std::string& name) {
+    size_t count = 0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X" && event["name"] == name) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void testDisabledRecordsNothing() {
+    Tracer::instance().setEnabled(false);
+    {
+        BEATER_TRACE_SCOPE("test", "disabled");
+    }
+    assert(countEvents(dumpJson(), "disabled") == 0);
+
+    // A scope opened while disabled stays unrecorded when tracing starts
+    {
+        BEATER_TRACE_SCOPE("test", "straddling");
+        Tracer::instance().setEnabled(true);
+    }
+    assert(countEvents(dumpJson(), "straddling") == 0);
+    Tracer::instance().setEnabled(false);
+
+    std::cout << "✓ testDisabledRecordsNothing passed\n";
+}
+
+void testScopesOnSeveralThreads() {
+    Tracer::instance().clear();
+    Tracer::instance().setEnabled(true);
+
+    const int threadCount = 4;
+    const int scopesPerThread = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([]() {
+            BEATER_TRACE_THREAD("test worker");
+            for (int i = 0; i < scopesPerThread; ++i) {
+                BEATER_TRACE_SCOPE("test", "outer");
+                BEATER_TRACE_SCOPE("test", "inner");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Tracer::instance().setEnabled(false);
+
+    const json trace = dumpJson();
+    assert(countEvents(trace, "outer") == threadCount * scopesPerThread);
+    assert(countEvents(trace, "inner") == threadCount * scopesPerThread);
+
+    // Each worker has its own named track; inner nests inside outer
+    std::set<int> workerTids;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "M" && event["args"]["name"] == "test worker") {
+            workerTids.insert(event["tid"].get<int>());
+        }
+        if (event["ph"] == "X") {
+            assert(event["cat"] == "test");
+            assert(event["dur"].get<double>() >= 0.0);
+            assert(event["pid"] == 1);
+        }
+    }
+    assert(workerTids.size() == threadCount);
+
+    std::cout << "✓ testScopesOnSeveralThreads passed\n";
+}
+
+void testRingKeepsNewestEvents() {
+    Tracer::instance().clear();
+    Tracer::instance().setEnabled(true);
+    std::thread writer([]() {
+        for (size_t i = 0; i < Tracer::EVENTS_PER_THREAD + 1000; ++i) {
+            BEATER_TRACE_SCOPE("test", "wrap");
+        }
+    });
+    writer.join();
+    Tracer::instance().setEnabled(false);
+
+    assert(countEvents(dumpJson(), "wrap") == Tracer::EVENTS_PER_THREAD);
+
+    Tracer::instance().clear();
+    assert(countEvents(dumpJson(), "wrap") == 0);
+
+    std::cout << "✓ testRingKeepsNewestEvents passed\n";
+}
+
+void testDumpWhileTracing() {
+    Tracer::instance().clear();
+    Tracer::instance().setEnabled(true);
+    std::atomic<bool> done{false};
+    std::thread writer([&done]() {
+        while (!done.load(std::memory_order_relaxed)) {
+            BEATER_TRACE_SCOPE("test", "busy");
+        }
+    });
+
+    // Every dump is well-formed, however far the writer has got
+    for (int i = 0; i < 20; ++i) {
+        const json trace = dumpJson();
+        assert(countEvents(trace, "busy") <= Tracer::EVENTS_PER_THREAD);
+    }
+    done.store(true, std::memory_order_relaxed);
+    writer.join();
+    Tracer::instance().setEnabled(false);
+
+    std::cout << "✓ testDumpWhileTracing passed\n";
+}
+
+void testEngineTracesAudioCallback() {
+    Engine engine(std::make_unique<NullAudioBackend>(48000, 256));
+    const bool started = engine.initialize("test");
+    assert(started);
+    auto& backend = static_cast<NullAudioBackend&>(engine.getAudioBackend());
+
+    Tracer::instance().clear();
+    Tracer::instance().setEnabled(true);
+    engine.playTimeline();
+    backend.step(256 * 10);
+    Tracer::instance().setEnabled(false);
+
+    const json trace = dumpJson();
+    assert(countEvents(trace, "Engine::audioCallback") == 10);
+    assert(countEvents(trace, "Sampler::render") == 10);
+
+    bool audioNamed = false;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "M" && event["args"]["name"] == "audio") {
+            audioNamed = true;
+        }
+    }
+    assert(audioNamed);
+
+    engine.shutdown();
+    std::cout << "✓ testEngineTracesAudioCallback passed\n";
+}
+
+int main() {
+    std::cout << "Running Trace tests...\n\n";
+
+    testDisabledRecordsNothing();
+    testScopesOnSeveralThreads();
+    testRingKeepsNewestEvents();
+    testDumpWhileTracing();
+    testEngineTracesAudioCallback();
+
+    std::cout << "\n✓ All Trace tests passed!\n";
+    return 0;
+}
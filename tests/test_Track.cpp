@@ -2,6 +2,7 @@
 #include "domain/Region.hpp"
 #include <iostream>
 #include <cassert>
+#include <string>
 
 using namespace beater;
 
@@ -98,6 +99,135 @@ void testTrackWouldOverlap() {
     std::cout << "✓ testTrackWouldOverlap passed\n";
 }
 
+void testTrackSetRegionBounds() {
+    Track track("track_1", "Test Track");
+    
+    track.addRegion(Region("r1", RegionType::Groove, 0, 1000));
+    track.addRegion(Region("r2", RegionType::Groove, 1000, 1000));
+    track.addRegion(Region("r3", RegionType::Groove, 2000, 1000));
+    
+    // Dragging r1 past r2 moves it in the sorted order
+    size_t index = track.setRegionBounds(0, 1500, 400);
+    assert(index == 1);
+    assert(track.getRegions()[0].getId() == "r2");
+    assert(track.getRegions()[1].getId() == "r1");
+    
+    // The index follows: r1 no longer covers tick 500, and now reaches 1900
+    assert(track.getRegionsInRange(500, 600).empty());
+    auto regions = track.getRegionsInRange(1800, 1900);
+    assert(regions.size() == 2);
+    assert(regions[0]->getId() == "r2" && regions[1]->getId() == "r1");
+    
+    // Growing a region updates the running max end after it
+    index = track.setRegionBounds(0, 1000, 5000);
+    assert(index == 0);
+    assert(track.getRegionsInRange(5500, 5600).size() == 1);
+    
+    std::cout << "✓ testTrackSetRegionBounds passed\n";
+}
+
+void testTrackAddRegionsBatch() {
+    Track track("track_1", "Test Track");
+    track.addRegion(Region("a", RegionType::Groove, 0, 1000));
+    track.addRegion(Region("b", RegionType::Groove, 5000, 1000));
+    
+    // Unsorted batch landing between, before and after existing regions
+    track.addRegions({
+        Region("c", RegionType::Groove, 7000, 500),
+        Region("d", RegionType::Groove, 2000, 8000),   // Long: spans b and c
+        Region("e", RegionType::Groove, 5000, 100),    // Same start as b
+        Region("f", RegionType::Groove, 1000, 500),
+    });
+    
+    const auto& regions = track.getRegions();
+    assert(regions.size() == 6);
+    const char* expected[] = {"a", "f", "d", "b", "e", "c"};
+    for (size_t i = 0; i < regions.size(); ++i) {
+        assert(regions[i].getId() == expected[i]);
+    }
+    
+    // The index covers the batch, including the long region
+    auto found = track.getRegionsInRange(9000, 9500);
+    assert(found.size() == 1 && found[0]->getId() == "d");
+    assert(track.getRegionsInRange(7100, 7200).size() == 2);
+    assert(track.wouldOverlap(Region("g", RegionType::Groove, 9900, 50)));
+    assert(!track.wouldOverlap(Region("h", RegionType::Groove, 10000, 50)));
+    
+    track.addRegions({});
+    assert(track.getRegions().size() == 6);
+    
+    std::cout << "✓ testTrackAddRegionsBatch passed\n";
+}
+
+void testTrackRangeIndexMatchesScan() {
+    Track track("track_1", "Test Track");
+    uint32_t seed = 12345;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<Tick>((seed >> 8) % range);
+    };
+    
+    // Linear scan over the sorted regions: the reference answer
+    auto scan = [&track](Tick start, Tick end) {
+        std::vector<const Region*> result;
+        for (const auto& region : track.getRegions()) {
+            if (region.getStartTick() < end && start < region.getEndTick()) {
+                result.push_back(&region);
+            }
+        }
+        return result;
+    };
+    
+    int nextId = 0;
+    for (int step = 0; step < 2000; ++step) {
+        Tick op = next(10);
+        if (op == 9) {
+            std::vector<Region> batch;
+            for (Tick n = next(20); n > 0; --n) {
+                batch.push_back(Region("r" + std::to_string(nextId++), RegionType::Groove,
+                                       next(50000), next(500)));
+            }
+            track.addRegions(batch);
+        } else if (op < 5 || track.getRegions().empty()) {
+            // Mostly short regions, sometimes a long one spanning many others
+            Tick length = next(8) == 0 ? next(20000) : next(500);
+            track.addRegion(Region("r" + std::to_string(nextId++), RegionType::Groove,
+                                   next(50000), length));
+        } else if (op < 7) {
+            size_t index = static_cast<size_t>(next(static_cast<uint32_t>(track.getRegions().size())));
+            track.removeRegion(track.getRegions()[index].getId());
+        } else {
+            size_t index = static_cast<size_t>(next(static_cast<uint32_t>(track.getRegions().size())));
+            track.setRegionBounds(index, next(50000), next(2000));
+        }
+        
+        const auto& regions = track.getRegions();
+        for (size_t i = 1; i < regions.size(); ++i) {
+            assert(regions[i - 1].getStartTick() <= regions[i].getStartTick());
+        }
+        
+        Tick start = next(52000);
+        Tick end = start + next(3000);
+        assert(track.getRegionsInRange(start, end) == scan(start, end));
+        
+        Region probe("probe", RegionType::Groove, start, end - start);
+        bool expected = false;
+        for (const auto& region : regions) {
+            expected = expected || probe.overlaps(region);
+        }
+        assert(track.wouldOverlap(probe) == expected);
+        
+        // Id lookup follows regions through inserts, removes and moves
+        if (!regions.empty()) {
+            const Region& sampled = regions[static_cast<size_t>(next(static_cast<uint32_t>(regions.size())))];
+            assert(track.getRegion(sampled.getId()) == &sampled);
+            assert(track.getRegion(sampled.getSymbol()) == &sampled);
+        }
+    }
+    
+    std::cout << "✓ testTrackRangeIndexMatchesScan passed\n";
+}
+
 int main() {
     std::cout << "Running Track tests...\n";
     
@@ -107,6 +237,9 @@ int main() {
     testTrackAddRegion();
     testTrackGetRegionsInRange();
     testTrackWouldOverlap();
+    testTrackSetRegionBounds();
+    testTrackAddRegionsBatch();
+    testTrackRangeIndexMatchesScan();
     
     std::cout << "\n✓ All Track tests passed!\n";
     return 0;